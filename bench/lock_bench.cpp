@@ -0,0 +1,70 @@
+#include "jpl/spinlock.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// every thread repeatedly takes the lock around a critical section of a few
+// dozen nanoseconds worth of dependent arithmetic; reports total acquisitions
+// per second across all threads.
+template <typename Lock>
+auto run(unsigned threads, std::chrono::milliseconds window) -> double
+{
+    Lock lock;
+    unsigned long long shared = 1;
+    std::atomic<bool> start = false;
+    std::atomic<bool> stop = false;
+    std::atomic<unsigned long long> total = 0;
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        workers.emplace_back([&]
+        {
+            while (not start.load(std::memory_order_acquire))
+            {}
+            unsigned long long acquisitions = 0;
+            while (not stop.load(std::memory_order_relaxed))
+            {
+                lock.lock();
+                for (int step = 0; step < 16; ++step)
+                {
+                    shared = shared * 6364136223846793005ull + 1442695040888963407ull;
+                }
+                lock.unlock();
+                ++acquisitions;
+            }
+            total += acquisitions;
+        });
+    }
+
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(window);
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    return static_cast<double>(total.load()) / std::chrono::duration<double>(window).count();
+};
+
+int main()
+{
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const auto window = std::chrono::milliseconds{ 300 };
+
+    std::printf("%8s %14s %14s %14s %14s\n", "threads", "spinlock", "ticket_lock", "mcs_lock", "std::mutex");
+    for (unsigned threads = 1; threads <= cores; ++threads)
+    {
+        std::printf("%8u %14.3e %14.3e %14.3e %14.3e\n", threads,
+            run<jpl::spinlock>(threads, window),
+            run<jpl::ticket_lock>(threads, window),
+            run<jpl::mcs_lock>(threads, window),
+            run<std::mutex>(threads, window));
+    }
+    return 0;
+};
@@ -0,0 +1,119 @@
+#include "jpl/seqlock.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+struct Quote
+{
+    double bid;
+    double ask;
+    double bid_size;
+    double ask_size;
+    long long sequence;
+    long long timestamp;
+};
+
+struct SharedMutexCell
+{
+    mutable std::shared_mutex mutex;
+    Quote value{};
+
+    auto load() const -> Quote
+    {
+        std::shared_lock lock{ mutex };
+        return value;
+    };
+    auto store(const Quote& desired) -> void
+    {
+        std::unique_lock lock{ mutex };
+        value = desired;
+    };
+};
+
+// readers spin on load() for a fixed window while a single writer publishes
+// roughly once per `write_interval`; reports aggregate reads per second.
+template <typename Cell>
+auto run(Cell& cell, unsigned readers, std::chrono::microseconds write_interval, std::chrono::milliseconds window) -> double
+{
+    std::atomic<bool> start = false;
+    std::atomic<bool> stop = false;
+    std::atomic<unsigned long long> total = 0;
+    std::atomic<unsigned long long> checksum = 0;
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < readers; ++i)
+    {
+        threads.emplace_back([&]
+        {
+            while (not start.load(std::memory_order_acquire))
+            {}
+            unsigned long long reads = 0;
+            long long sum = 0;
+            while (not stop.load(std::memory_order_relaxed))
+            {
+                const Quote quote = cell.load();
+                sum += quote.sequence;
+                ++reads;
+            }
+            total += reads;
+            checksum += static_cast<unsigned long long>(sum);
+        });
+    }
+    std::thread writer{ [&]
+    {
+        while (not start.load(std::memory_order_acquire))
+        {}
+        long long sequence = 0;
+        auto next = std::chrono::steady_clock::now();
+        while (not stop.load(std::memory_order_relaxed))
+        {
+            if (std::chrono::steady_clock::now() >= next)
+            {
+                ++sequence;
+                cell.store(Quote{ 1.0, 1.5, 100.0, 200.0, sequence, sequence });
+                next += write_interval;
+            }
+        }
+    } };
+
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(window);
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    return static_cast<double>(total.load()) / std::chrono::duration<double>(window).count();
+};
+
+int main()
+{
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const auto interval = std::chrono::microseconds{ 100 };
+    const auto window = std::chrono::milliseconds{ 500 };
+
+    std::printf("%8s %18s %18s\n", "readers", "seqlock reads/s", "shared_mutex reads/s");
+    std::vector<unsigned> counts;
+    for (unsigned readers = 1; readers < cores; readers *= 2)
+    {
+        counts.push_back(readers);
+    }
+    counts.push_back(cores);
+
+    for (const unsigned readers : counts)
+    {
+        jpl::seqlock<Quote> seq{ Quote{} };
+        SharedMutexCell shared;
+        const double seq_rate = run(seq, readers, interval, window);
+        const double shared_rate = run(shared, readers, interval, window);
+        std::printf("%8u %18.3e %18.3e\n", readers, seq_rate, shared_rate);
+    }
+    return 0;
+};
@@ -0,0 +1,664 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "new.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+// branchless_lower_bound
+// branchless_upper_bound
+namespace jpl
+{
+    // binary search whose loop has a fixed trip count for a given length and
+    // whose only data-dependent step is a conditional add, which compiles to a
+    // cmov rather than a mispredicted branch.
+    template <std::random_access_iterator I, typename T, typename Compare = std::less<>>
+    constexpr auto branchless_lower_bound(I first, I last, const T& value, Compare compare = {}) -> I
+    {
+        auto length = last - first;
+        if (length == 0)
+        {
+            return first;
+        }
+        while (length > 1)
+        {
+            const auto half = length / 2;
+            first += compare(first[half - 1], value) ? half : 0;
+            length -= half;
+        }
+        return first + (compare(*first, value) ? 1 : 0);
+    };
+    template <std::random_access_iterator I, typename T, typename Compare = std::less<>>
+    constexpr auto branchless_upper_bound(I first, I last, const T& value, Compare compare = {}) -> I
+    {
+        auto length = last - first;
+        if (length == 0)
+        {
+            return first;
+        }
+        while (length > 1)
+        {
+            const auto half = length / 2;
+            first += not compare(value, first[half - 1]) ? half : 0;
+            length -= half;
+        }
+        return first + (not compare(value, *first) ? 1 : 0);
+    };
+};
+
+// sort
+namespace jpl
+{
+    namespace impl
+    {
+        namespace sort
+        {
+            inline constexpr ptrdiff_t insertion_sort_threshold = 24;
+            inline constexpr ptrdiff_t ninther_threshold = 128;
+            inline constexpr ptrdiff_t partial_insertion_sort_limit = 8;
+            inline constexpr size_t block_size = 64;
+            inline constexpr size_t cacheline_size = hardware_constructive_interference_size;
+
+            // block partitioning pays off when comparisons are cheap and do not
+            // branch on their own, i.e. the builtin orderings on arithmetic types.
+            template <typename T, typename Compare>
+            inline constexpr bool use_branchless = is_arithmetic_v<T> and is_any_of_v<Compare,
+                std::less<>, std::less<T>, std::greater<>, std::greater<T>
+            >;
+
+            template <typename I, typename Compare>
+            auto insertion_sort(I begin, I end, Compare& compare) -> void
+            {
+                using T = typename std::iterator_traits<I>::value_type;
+                if (begin == end)
+                {
+                    return;
+                }
+                for (I current = begin + 1; current != end; ++current)
+                {
+                    I sift = current;
+                    I sift_1 = current - 1;
+                    if (compare(*sift, *sift_1))
+                    {
+                        T temporary = jpl::move(*sift);
+                        do
+                        {
+                            *sift-- = jpl::move(*sift_1);
+                        }
+                        while (sift != begin and compare(temporary, *--sift_1));
+                        *sift = jpl::move(temporary);
+                    }
+                }
+            };
+
+            // assumes *(begin - 1) is no greater than anything in [begin, end).
+            template <typename I, typename Compare>
+            auto unguarded_insertion_sort(I begin, I end, Compare& compare) -> void
+            {
+                using T = typename std::iterator_traits<I>::value_type;
+                if (begin == end)
+                {
+                    return;
+                }
+                for (I current = begin + 1; current != end; ++current)
+                {
+                    I sift = current;
+                    I sift_1 = current - 1;
+                    if (compare(*sift, *sift_1))
+                    {
+                        T temporary = jpl::move(*sift);
+                        do
+                        {
+                            *sift-- = jpl::move(*sift_1);
+                        }
+                        while (compare(temporary, *--sift_1));
+                        *sift = jpl::move(temporary);
+                    }
+                }
+            };
+
+            // gives up, returning false, once more than partial_insertion_sort_limit
+            // elements have had to move.
+            template <typename I, typename Compare>
+            auto partial_insertion_sort(I begin, I end, Compare& compare) -> bool
+            {
+                using T = typename std::iterator_traits<I>::value_type;
+                if (begin == end)
+                {
+                    return true;
+                }
+                ptrdiff_t moved = 0;
+                for (I current = begin + 1; current != end; ++current)
+                {
+                    I sift = current;
+                    I sift_1 = current - 1;
+                    if (compare(*sift, *sift_1))
+                    {
+                        T temporary = jpl::move(*sift);
+                        do
+                        {
+                            *sift-- = jpl::move(*sift_1);
+                        }
+                        while (sift != begin and compare(temporary, *--sift_1));
+                        *sift = jpl::move(temporary);
+                        moved += current - sift;
+                    }
+                    if (moved > partial_insertion_sort_limit)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            template <typename I, typename Compare>
+            auto sort2(I a, I b, Compare& compare) -> void
+            {
+                if (compare(*b, *a))
+                {
+                    std::iter_swap(a, b);
+                }
+            };
+            template <typename I, typename Compare>
+            auto sort3(I a, I b, I c, Compare& compare) -> void
+            {
+                sort2(a, b, compare);
+                sort2(b, c, compare);
+                sort2(a, b, compare);
+            };
+
+            template <typename I>
+            struct partition_result
+            {
+                I pivot;
+                bool already_partitioned;
+            };
+
+            template <typename I, typename Compare>
+            auto partition_right(I begin, I end, Compare& compare) -> partition_result<I>
+            {
+                using T = typename std::iterator_traits<I>::value_type;
+                T pivot = jpl::move(*begin);
+                I first = begin;
+                I last = end;
+
+                while (compare(*++first, pivot))
+                {}
+                if (first - 1 == begin)
+                {
+                    while (first < last and not compare(*--last, pivot))
+                    {}
+                }
+                else
+                {
+                    while (not compare(*--last, pivot))
+                    {}
+                }
+
+                const bool already_partitioned = first >= last;
+                while (first < last)
+                {
+                    std::iter_swap(first, last);
+                    while (compare(*++first, pivot))
+                    {}
+                    while (not compare(*--last, pivot))
+                    {}
+                }
+
+                I pivot_position = first - 1;
+                *begin = jpl::move(*pivot_position);
+                *pivot_position = jpl::move(pivot);
+                return { pivot_position, already_partitioned };
+            };
+
+            template <typename I>
+            auto swap_offsets(I first, I last, const unsigned char* offsets_l, const unsigned char* offsets_r, size_t count, bool use_swaps) -> void
+            {
+                using T = typename std::iterator_traits<I>::value_type;
+                if (use_swaps)
+                {
+                    // equal counts mean the ranges may overlap; only swaps are safe.
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+                    }
+                }
+                else if (count > 0)
+                {
+                    I l = first + offsets_l[0];
+                    I r = last - offsets_r[0];
+                    T temporary = jpl::move(*l);
+                    *l = jpl::move(*r);
+                    for (size_t i = 1; i < count; ++i)
+                    {
+                        l = first + offsets_l[i];
+                        *r = jpl::move(*l);
+                        r = last - offsets_r[i];
+                        *l = jpl::move(*r);
+                    }
+                    *r = jpl::move(temporary);
+                }
+            };
+
+            // block partitioning: comparisons only record offsets of misplaced
+            // elements into small buffers, turning the data-dependent branch into
+            // an add, and the swaps happen afterwards in bulk.
+            template <typename I, typename Compare>
+            auto partition_right_branchless(I begin, I end, Compare& compare) -> partition_result<I>
+            {
+                using T = typename std::iterator_traits<I>::value_type;
+                T pivot = jpl::move(*begin);
+                I first = begin;
+                I last = end;
+
+                while (compare(*++first, pivot))
+                {}
+                if (first - 1 == begin)
+                {
+                    while (first < last and not compare(*--last, pivot))
+                    {}
+                }
+                else
+                {
+                    while (not compare(*--last, pivot))
+                    {}
+                }
+
+                const bool already_partitioned = first >= last;
+                if (not already_partitioned)
+                {
+                    std::iter_swap(first, last);
+                    ++first;
+
+                    alignas(cacheline_size) unsigned char offsets_l[block_size];
+                    alignas(cacheline_size) unsigned char offsets_r[block_size];
+
+                    I offsets_l_base = first;
+                    I offsets_r_base = last;
+                    size_t count_l = 0;
+                    size_t count_r = 0;
+                    size_t start_l = 0;
+                    size_t start_r = 0;
+
+                    while (first < last)
+                    {
+                        const size_t unknown = static_cast<size_t>(last - first);
+                        const size_t left_split = count_l == 0 ? (count_r == 0 ? unknown / 2 : unknown) : 0;
+                        const size_t right_split = count_r == 0 ? (unknown - left_split) : 0;
+
+                        const size_t left_block = std::min(left_split, block_size);
+                        for (size_t i = 0; i < left_block; ++i)
+                        {
+                            offsets_l[count_l] = static_cast<unsigned char>(i);
+                            count_l += not compare(*first, pivot);
+                            ++first;
+                        }
+                        const size_t right_block = std::min(right_split, block_size);
+                        for (size_t i = 0; i < right_block; ++i)
+                        {
+                            offsets_r[count_r] = static_cast<unsigned char>(i + 1);
+                            count_r += compare(*--last, pivot);
+                        }
+
+                        const size_t count = std::min(count_l, count_r);
+                        swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, count, count_l == count_r);
+                        count_l -= count;
+                        count_r -= count;
+                        start_l += count;
+                        start_r += count;
+
+                        if (count_l == 0)
+                        {
+                            start_l = 0;
+                            offsets_l_base = first;
+                        }
+                        if (count_r == 0)
+                        {
+                            start_r = 0;
+                            offsets_r_base = last;
+                        }
+                    }
+
+                    // one side may still have misplaced elements; move them to the
+                    // boundary one at a time.
+                    if (count_l != 0)
+                    {
+                        const unsigned char* offsets = offsets_l + start_l;
+                        while (count_l-- != 0)
+                        {
+                            std::iter_swap(offsets_l_base + offsets[count_l], --last);
+                        }
+                        first = last;
+                    }
+                    if (count_r != 0)
+                    {
+                        const unsigned char* offsets = offsets_r + start_r;
+                        while (count_r-- != 0)
+                        {
+                            std::iter_swap(offsets_r_base - offsets[count_r], first);
+                            ++first;
+                        }
+                        last = first;
+                    }
+                }
+
+                I pivot_position = first - 1;
+                *begin = jpl::move(*pivot_position);
+                *pivot_position = jpl::move(pivot);
+                return { pivot_position, already_partitioned };
+            };
+
+            // puts everything equal to the pivot on the left; used when the pivot
+            // equals the element before the range, which makes the whole equal run
+            // disappear from further recursion.
+            template <typename I, typename Compare>
+            auto partition_left(I begin, I end, Compare& compare) -> I
+            {
+                using T = typename std::iterator_traits<I>::value_type;
+                T pivot = jpl::move(*begin);
+                I first = begin;
+                I last = end;
+
+                while (compare(pivot, *--last))
+                {}
+                if (last + 1 == end)
+                {
+                    while (first < last and not compare(pivot, *++first))
+                    {}
+                }
+                else
+                {
+                    while (not compare(pivot, *++first))
+                    {}
+                }
+
+                while (first < last)
+                {
+                    std::iter_swap(first, last);
+                    while (compare(pivot, *--last))
+                    {}
+                    while (not compare(pivot, *++first))
+                    {}
+                }
+
+                I pivot_position = last;
+                *begin = jpl::move(*pivot_position);
+                *pivot_position = jpl::move(pivot);
+                return pivot_position;
+            };
+
+            template <bool Branchless, typename I, typename Compare>
+            auto pdqsort_loop(I begin, I end, Compare& compare, int bad_allowed, bool leftmost = true) -> void
+            {
+                for (;;)
+                {
+                    const ptrdiff_t size = end - begin;
+                    if (size < insertion_sort_threshold)
+                    {
+                        if (leftmost)
+                        {
+                            insertion_sort(begin, end, compare);
+                        }
+                        else
+                        {
+                            unguarded_insertion_sort(begin, end, compare);
+                        }
+                        return;
+                    }
+
+                    const ptrdiff_t half = size / 2;
+                    if (size > ninther_threshold)
+                    {
+                        sort3(begin, begin + half, end - 1, compare);
+                        sort3(begin + 1, begin + (half - 1), end - 2, compare);
+                        sort3(begin + 2, begin + (half + 1), end - 3, compare);
+                        sort3(begin + (half - 1), begin + half, begin + (half + 1), compare);
+                        std::iter_swap(begin, begin + half);
+                    }
+                    else
+                    {
+                        sort3(begin + half, begin, end - 1, compare);
+                    }
+
+                    if (not leftmost and not compare(*(begin - 1), *begin))
+                    {
+                        begin = partition_left(begin, end, compare) + 1;
+                        continue;
+                    }
+
+                    const auto [pivot_position, already_partitioned] = Branchless ?
+                        partition_right_branchless(begin, end, compare) :
+                        partition_right(begin, end, compare);
+
+                    const ptrdiff_t l_size = pivot_position - begin;
+                    const ptrdiff_t r_size = end - (pivot_position + 1);
+                    const bool highly_unbalanced = l_size < size / 8 or r_size < size / 8;
+
+                    if (highly_unbalanced)
+                    {
+                        // too many bad pivots: fall back to heapsort for a
+                        // guaranteed n log n.
+                        if (--bad_allowed == 0)
+                        {
+                            std::make_heap(begin, end, compare);
+                            std::sort_heap(begin, end, compare);
+                            return;
+                        }
+
+                        // otherwise break up the patterns that produced the bad pivot.
+                        if (l_size >= insertion_sort_threshold)
+                        {
+                            std::iter_swap(begin, begin + l_size / 4);
+                            std::iter_swap(pivot_position - 1, pivot_position - l_size / 4);
+                            if (l_size > ninther_threshold)
+                            {
+                                std::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                                std::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                                std::iter_swap(pivot_position - 2, pivot_position - (l_size / 4 + 1));
+                                std::iter_swap(pivot_position - 3, pivot_position - (l_size / 4 + 2));
+                            }
+                        }
+                        if (r_size >= insertion_sort_threshold)
+                        {
+                            std::iter_swap(pivot_position + 1, pivot_position + (1 + r_size / 4));
+                            std::iter_swap(end - 1, end - r_size / 4);
+                            if (r_size > ninther_threshold)
+                            {
+                                std::iter_swap(pivot_position + 2, pivot_position + (2 + r_size / 4));
+                                std::iter_swap(pivot_position + 3, pivot_position + (3 + r_size / 4));
+                                std::iter_swap(end - 2, end - (1 + r_size / 4));
+                                std::iter_swap(end - 3, end - (2 + r_size / 4));
+                            }
+                        }
+                    }
+                    else if (already_partitioned and
+                             partial_insertion_sort(begin, pivot_position, compare) and
+                             partial_insertion_sort(pivot_position + 1, end, compare))
+                    {
+                        // a cheap pivot that left both sides nearly sorted.
+                        return;
+                    }
+
+                    pdqsort_loop<Branchless>(begin, pivot_position, compare, bad_allowed, leftmost);
+                    begin = pivot_position + 1;
+                    leftmost = false;
+                }
+            };
+        };
+    };
+
+    // pattern-defeating quicksort: unstable, n log n worst case, linear on sorted,
+    // reverse sorted and all-equal inputs.
+    template <std::random_access_iterator I, typename Compare = std::less<>>
+    auto sort(I first, I last, Compare compare = {}) -> void
+    {
+        using T = typename std::iterator_traits<I>::value_type;
+        if (last - first < 2)
+        {
+            return;
+        }
+        const int bad_allowed = std::bit_width(static_cast<size_t>(last - first)) - 1;
+        impl::sort::pdqsort_loop<impl::sort::use_branchless<T, Compare>>(first, last, compare, bad_allowed);
+    };
+};
+
+// radix_sort
+namespace jpl
+{
+    namespace impl
+    {
+        namespace radix_sort
+        {
+            // only widths with an unsigned_of, which rules out long double and
+            // 128-bit integers.
+            template <typename K>
+            concept key = (is_integral_v<K> or is_floating_point_v<K>) and
+                          (sizeof(K) == 1 or sizeof(K) == 2 or sizeof(K) == 4 or sizeof(K) == 8);
+
+            template <size_t Size>
+            struct unsigned_of;
+            template <>
+            struct unsigned_of<1>
+            {
+                using type = unsigned char;
+            };
+            template <>
+            struct unsigned_of<2>
+            {
+                using type = unsigned short;
+            };
+            template <>
+            struct unsigned_of<4>
+            {
+                using type = unsigned int;
+            };
+            template <>
+            struct unsigned_of<8>
+            {
+                using type = unsigned long long;
+            };
+            template <typename K>
+            using bits_t = typename unsigned_of<sizeof(K)>::type;
+
+            // maps a key onto an unsigned integer with the same ordering.
+            template <key K>
+            constexpr auto encode(K value) noexcept -> bits_t<K>
+            {
+                using U = bits_t<K>;
+                constexpr U sign = U{ 1 } << (sizeof(K) * 8 - 1);
+                U bits;
+                std::memcpy(&bits, &value, sizeof(K));
+                if constexpr (is_floating_point_v<K>)
+                {
+                    // negative floats order backwards: flip everything. positive
+                    // ones just need to sort above them.
+                    return (bits & sign) != 0 ? static_cast<U>(~bits) : static_cast<U>(bits | sign);
+                }
+                else if constexpr (static_cast<K>(-1) < K{ 0 })
+                {
+                    return static_cast<U>(bits ^ sign);
+                }
+                else
+                {
+                    return bits;
+                }
+            };
+
+            // 11-bit digits need one pass fewer on 32-bit keys and two fewer on
+            // 64-bit keys, at the price of 2048-entry histograms; narrower keys
+            // stay on bytes.
+            template <typename K>
+            inline constexpr size_t digit_bits = sizeof(K) >= 4 ? 11 : 8;
+
+            inline constexpr ptrdiff_t comparison_sort_threshold = 256;
+        };
+    };
+
+    // lsd radix sort on the key produced by projection, which must be an
+    // arithmetic type. stable; uses a buffer the size of the input, so the value
+    // type must be default constructible.
+    template <std::random_access_iterator I, typename Projection = std::identity>
+    requires impl::radix_sort::key<remove_cvref_t<std::invoke_result_t<Projection&, typename std::iterator_traits<I>::reference>>>
+    auto radix_sort(I first, I last, Projection projection = {}) -> void
+    {
+        using T = typename std::iterator_traits<I>::value_type;
+        using K = remove_cvref_t<std::invoke_result_t<Projection&, typename std::iterator_traits<I>::reference>>;
+        using U = impl::radix_sort::bits_t<K>;
+
+        constexpr size_t digit_bits = impl::radix_sort::digit_bits<K>;
+        constexpr size_t radix = size_t{ 1 } << digit_bits;
+        constexpr size_t passes = (sizeof(K) * 8 + digit_bits - 1) / digit_bits;
+
+        const ptrdiff_t size = last - first;
+        if (size < impl::radix_sort::comparison_sort_threshold)
+        {
+            std::stable_sort(first, last, [&](auto& l, auto& r)
+            {
+                return impl::radix_sort::encode<K>(std::invoke(projection, l)) < impl::radix_sort::encode<K>(std::invoke(projection, r));
+            });
+            return;
+        }
+
+        // every histogram is built in a single read of the input.
+        std::vector<size_t> histograms(passes * radix, 0);
+        for (I it = first; it != last; ++it)
+        {
+            const U bits = impl::radix_sort::encode<K>(std::invoke(projection, *it));
+            for (size_t pass = 0; pass < passes; ++pass)
+            {
+                ++histograms[pass * radix + ((bits >> (pass * digit_bits)) & (radix - 1))];
+            }
+        }
+
+        // passes alternate between the input and a single buffer.
+        std::vector<T> buffer(static_cast<size_t>(size));
+        bool in_buffer = false;
+        auto scatter = [&](auto source, auto destination, size_t pass)
+        {
+            size_t* counts = histograms.data() + pass * radix;
+            for (ptrdiff_t i = 0; i < size; ++i)
+            {
+                const U bits = impl::radix_sort::encode<K>(std::invoke(projection, source[i]));
+                destination[counts[(bits >> (pass * digit_bits)) & (radix - 1)]++] = jpl::move(source[i]);
+            }
+        };
+
+        for (size_t pass = 0; pass < passes; ++pass)
+        {
+            size_t* counts = histograms.data() + pass * radix;
+            // a digit every key shares does not reorder anything.
+            const U first_bits = impl::radix_sort::encode<K>(std::invoke(projection, in_buffer ? buffer.front() : *first));
+            if (counts[(first_bits >> (pass * digit_bits)) & (radix - 1)] == static_cast<size_t>(size))
+            {
+                continue;
+            }
+
+            size_t offset = 0;
+            for (size_t digit = 0; digit < radix; ++digit)
+            {
+                offset += jpl::exchange(counts[digit], offset);
+            }
+            if (in_buffer)
+            {
+                scatter(buffer.data(), first, pass);
+            }
+            else
+            {
+                scatter(first, buffer.data(), pass);
+            }
+            in_buffer = not in_buffer;
+        }
+
+        if (in_buffer)
+        {
+            std::move(buffer.begin(), buffer.end(), first);
+        }
+    };
+};
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <typeinfo>
+#include <vector>
+
+// allocation_snapshot
+// allocation_snapshots
+// untracked
+// tracked
+// allocation_policy
+// tracked_delete
+// make_tracked
+// tracked_allocator
+namespace jpl
+{
+    // the counters of one tag at one point in time. lifetimes[i] counts
+    // deallocations of memory that lived for less than 2^i nanoseconds and
+    // at least half that; the last bucket takes everything longer.
+    struct allocation_snapshot
+    {
+        static constexpr size_t lifetime_buckets = 48;
+
+        const char* tag = nullptr;
+        size_t allocations = 0;
+        size_t deallocations = 0;
+        size_t live_bytes = 0;
+        size_t peak_bytes = 0;
+        size_t total_bytes = 0;
+        std::array<size_t, lifetime_buckets> lifetimes{};
+    };
+
+    namespace impl
+    {
+        namespace allocation_tracking
+        {
+            struct counters
+            {
+                const char* tag;
+                std::atomic<size_t> allocations{ 0 };
+                std::atomic<size_t> deallocations{ 0 };
+                std::atomic<size_t> live_bytes{ 0 };
+                std::atomic<size_t> peak_bytes{ 0 };
+                std::atomic<size_t> total_bytes{ 0 };
+                std::array<std::atomic<size_t>, allocation_snapshot::lifetime_buckets> lifetimes{};
+                counters* next = nullptr;
+
+                explicit counters(const char* tag) noexcept :
+                    tag{ tag }
+                {};
+
+                auto snapshot() const noexcept -> allocation_snapshot
+                {
+                    allocation_snapshot result;
+                    result.tag = tag;
+                    result.allocations = allocations.load(std::memory_order_relaxed);
+                    result.deallocations = deallocations.load(std::memory_order_relaxed);
+                    result.live_bytes = live_bytes.load(std::memory_order_relaxed);
+                    result.peak_bytes = peak_bytes.load(std::memory_order_relaxed);
+                    result.total_bytes = total_bytes.load(std::memory_order_relaxed);
+                    for (size_t i = 0; i < lifetimes.size(); ++i)
+                    {
+                        result.lifetimes[i] = lifetimes[i].load(std::memory_order_relaxed);
+                    }
+                    return result;
+                };
+            };
+
+            // every tag that has been used, pushed on first use and never removed.
+            inline std::atomic<counters*> registry{ nullptr };
+
+            inline auto enroll(counters& tag) noexcept -> void
+            {
+                tag.next = registry.load(std::memory_order_relaxed);
+                while (not registry.compare_exchange_weak(tag.next, &tag, std::memory_order_release, std::memory_order_relaxed))
+                {}
+            };
+
+            template <typename Tag>
+            auto name() noexcept -> const char*
+            {
+                if constexpr (requires { requires is_convertible_v<decltype(Tag::name), const char*>; })
+                {
+                    return Tag::name;
+                }
+                else
+                {
+                    return typeid(Tag).name();
+                }
+            };
+
+            template <typename Tag>
+            auto counters_for() noexcept -> counters&
+            {
+                static counters* const instance = []
+                {
+                    static counters storage{ name<Tag>() };
+                    enroll(storage);
+                    return &storage;
+                }();
+                return *instance;
+            };
+
+            inline auto now() noexcept -> long long
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            };
+
+            struct empty_stamp
+            {};
+            // what a tracked allocation has to remember until it is freed.
+            struct stamp
+            {
+                long long born = 0;
+                size_t bytes = 0;
+            };
+        };
+    };
+
+    // every tag's counters, in no particular order.
+    inline auto allocation_snapshots() -> std::vector<allocation_snapshot>
+    {
+        std::vector<allocation_snapshot> result;
+        for (auto* tag = impl::allocation_tracking::registry.load(std::memory_order_acquire); tag != nullptr; tag = tag->next)
+        {
+            result.push_back(tag->snapshot());
+        }
+        return result;
+    };
+
+    // the policy that records nothing: its stamps are empty and its hooks
+    // compile away, so tracked_delete and tracked_allocator reduce to what
+    // they wrap.
+    struct untracked
+    {
+        using stamp = impl::allocation_tracking::empty_stamp;
+
+        static constexpr auto allocated(size_t) noexcept -> stamp
+        {
+            return {};
+        };
+        static constexpr auto deallocated(const stamp&) noexcept -> void
+        {};
+    };
+
+    // attributes allocations to Tag, named by a static Tag::name if it has one.
+    // counters are relaxed atomics shared by every thread using the tag.
+    template <typename Tag>
+    struct tracked
+    {
+        using stamp = impl::allocation_tracking::stamp;
+
+        static auto allocated(size_t bytes) noexcept -> stamp
+        {
+            auto& tag = impl::allocation_tracking::counters_for<Tag>();
+            tag.allocations.fetch_add(1, std::memory_order_relaxed);
+            tag.total_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            const size_t live = tag.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            size_t peak = tag.peak_bytes.load(std::memory_order_relaxed);
+            while (live > peak and not tag.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {}
+            return stamp{ impl::allocation_tracking::now(), bytes };
+        };
+        static auto deallocated(const stamp& allocation) noexcept -> void
+        {
+            auto& tag = impl::allocation_tracking::counters_for<Tag>();
+            tag.deallocations.fetch_add(1, std::memory_order_relaxed);
+            tag.live_bytes.fetch_sub(allocation.bytes, std::memory_order_relaxed);
+            const auto lifetime = static_cast<unsigned long long>(impl::allocation_tracking::now() - allocation.born);
+            const auto bucket = static_cast<size_t>(std::bit_width(lifetime));
+            tag.lifetimes[bucket < allocation_snapshot::lifetime_buckets ? bucket : allocation_snapshot::lifetime_buckets - 1].fetch_add(1, std::memory_order_relaxed);
+        };
+
+        [[nodiscard]] static auto snapshot() noexcept -> allocation_snapshot
+        {
+            return impl::allocation_tracking::counters_for<Tag>().snapshot();
+        };
+    };
+
+    // tracked<Tag> when the library is built with JPL_TRACK_ALLOCATIONS, and
+    // untracked otherwise, so instrumentation is switched on per build.
+#if defined(JPL_TRACK_ALLOCATIONS)
+    template <typename Tag>
+    using allocation_policy = tracked<Tag>;
+#else
+    template <typename Tag>
+    using allocation_policy = untracked;
+#endif
+
+    // default_delete that reports the deallocation to Policy. it carries the
+    // stamp made at allocation time, so pointers should come from
+    // make_tracked; with untracked it is empty like default_delete.
+    template <typename T, typename Policy = untracked>
+    struct tracked_delete
+    {
+        constexpr tracked_delete() noexcept = default;
+        constexpr explicit tracked_delete(const typename Policy::stamp& allocation) noexcept :
+            allocation{ allocation }
+        {};
+        template <typename U> requires is_convertible_v<U*, T*>
+        constexpr tracked_delete(const tracked_delete<U, Policy>& other) noexcept :
+            allocation{ other.allocation }
+        {};
+
+        constexpr auto operator ()(T* pointer) const -> void
+        {
+            Policy::deallocated(allocation);
+            default_delete<T>{}(pointer);
+        };
+
+        [[no_unique_address]] typename Policy::stamp allocation{};
+    };
+
+    template <typename T, typename Policy = untracked, typename... As>
+    [[nodiscard]] auto make_tracked(As&&... arguments) -> unique_ptr<T, tracked_delete<T, Policy>>
+    {
+        T* object = new T(jpl::forward<As>(arguments)...);
+        return unique_ptr<T, tracked_delete<T, Policy>>{ object, tracked_delete<T, Policy>{ Policy::allocated(sizeof(T)) } };
+    };
+
+    namespace impl
+    {
+        namespace allocation_tracking
+        {
+            // elements reserved in front of a tracked block to hold its stamp.
+            template <typename T, typename Policy>
+            inline constexpr size_t header_elements = is_same_v<typename Policy::stamp, empty_stamp> ? 0 : (sizeof(typename Policy::stamp) + sizeof(T) - 1) / sizeof(T);
+        };
+    };
+
+    // an allocator adaptor reporting to Policy. a tracked block is preceded by
+    // its stamp, so lifetimes are known at deallocation; untracked forwards
+    // straight to Allocator.
+    template <typename T, typename Policy = untracked, typename Allocator = std::allocator<T>>
+    struct tracked_allocator
+    {
+        using value_type = T;
+        using upstream_type = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+        using propagate_on_container_copy_assignment = typename std::allocator_traits<upstream_type>::propagate_on_container_copy_assignment;
+        using propagate_on_container_move_assignment = typename std::allocator_traits<upstream_type>::propagate_on_container_move_assignment;
+        using propagate_on_container_swap = typename std::allocator_traits<upstream_type>::propagate_on_container_swap;
+        using is_always_equal = typename std::allocator_traits<upstream_type>::is_always_equal;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = tracked_allocator<U, Policy, typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
+        };
+
+        tracked_allocator() noexcept(noexcept(upstream_type{})) = default;
+        tracked_allocator(const upstream_type& upstream) noexcept :
+            upstream{ upstream }
+        {};
+        template <typename U, typename A>
+        tracked_allocator(const tracked_allocator<U, Policy, A>& other) noexcept :
+            upstream{ other.upstream }
+        {};
+
+        [[nodiscard]] auto allocate(size_t count) -> T*
+        {
+            constexpr size_t header = impl::allocation_tracking::header_elements<T, Policy>;
+            T* block = std::allocator_traits<upstream_type>::allocate(upstream, count + header);
+            if constexpr (header != 0)
+            {
+                const typename Policy::stamp allocation = Policy::allocated(count * sizeof(T));
+                std::memcpy(static_cast<void*>(block), &allocation, sizeof(allocation));
+            }
+            return block + header;
+        };
+        auto deallocate(T* pointer, size_t count) noexcept -> void
+        {
+            constexpr size_t header = impl::allocation_tracking::header_elements<T, Policy>;
+            T* block = pointer - header;
+            if constexpr (header != 0)
+            {
+                typename Policy::stamp allocation;
+                std::memcpy(&allocation, static_cast<const void*>(block), sizeof(allocation));
+                Policy::deallocated(allocation);
+            }
+            std::allocator_traits<upstream_type>::deallocate(upstream, block, count + header);
+        };
+
+        template <typename U, typename A>
+        friend auto operator ==(const tracked_allocator& left, const tracked_allocator<U, Policy, A>& right) noexcept -> bool
+        {
+            return left.upstream == right.upstream;
+        };
+
+        [[no_unique_address]] upstream_type upstream;
+    };
+};
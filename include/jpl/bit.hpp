@@ -0,0 +1,111 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "type_traits.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <stdlib.h>
+#endif
+
+// endian
+// bit_cast
+// byteswap
+namespace jpl
+{
+    enum class endian
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        little = 0,
+        big = 1,
+        native = little,
+#else
+        little = __ORDER_LITTLE_ENDIAN__,
+        big = __ORDER_BIG_ENDIAN__,
+        native = __BYTE_ORDER__,
+#endif
+    };
+
+    // the object representation of from, reinterpreted as a To.
+    template <typename To, typename From>
+    requires (sizeof(To) == sizeof(From)) and is_trivially_copyable_v<To> and is_trivially_copyable_v<From>
+    [[nodiscard]] constexpr auto bit_cast(const From& from) noexcept -> To
+    {
+        return __builtin_bit_cast(To, from);
+    };
+
+    namespace impl
+    {
+        namespace bit
+        {
+            template <typename U>
+            constexpr auto reverse(U value) noexcept -> U
+            {
+                U result = 0;
+                for (size_t i = 0; i < sizeof(U); ++i)
+                {
+                    result = static_cast<U>((result << 8) | (value & 0xff));
+                    value = static_cast<U>(value >> 8);
+                }
+                return result;
+            };
+        };
+    };
+
+    // reverses the bytes of an integer; one bswap or rev instruction.
+    template <typename T>
+    requires is_integral_v<T>
+    [[nodiscard]] constexpr auto byteswap(T value) noexcept -> T
+    {
+        if constexpr (sizeof(T) == 1)
+        {
+            return value;
+        }
+        else
+        {
+            using U = make_unsigned_t<T>;
+            const auto bits = static_cast<U>(value);
+#if defined(__GNUC__) || defined(__clang__)
+            if constexpr (sizeof(T) == 2)
+            {
+                return static_cast<T>(__builtin_bswap16(bits));
+            }
+            else if constexpr (sizeof(T) == 4)
+            {
+                return static_cast<T>(__builtin_bswap32(bits));
+            }
+            else if constexpr (sizeof(T) == 8)
+            {
+                return static_cast<T>(__builtin_bswap64(bits));
+            }
+            else
+            {
+                return static_cast<T>(impl::bit::reverse(bits));
+            }
+#else
+            if consteval
+            {
+                return static_cast<T>(impl::bit::reverse(bits));
+            }
+            else
+            {
+                if constexpr (sizeof(T) == 2)
+                {
+                    return static_cast<T>(_byteswap_ushort(bits));
+                }
+                else if constexpr (sizeof(T) == 4)
+                {
+                    return static_cast<T>(_byteswap_ulong(bits));
+                }
+                else if constexpr (sizeof(T) == 8)
+                {
+                    return static_cast<T>(_byteswap_uint64(bits));
+                }
+                else
+                {
+                    return static_cast<T>(impl::bit::reverse(bits));
+                }
+            }
+#endif
+        }
+    };
+};
@@ -0,0 +1,675 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// bitset
+// dynamic_bitset
+namespace jpl
+{
+    namespace impl
+    {
+        namespace bitset
+        {
+            using word = unsigned long long;
+            inline constexpr size_t word_bits = std::numeric_limits<word>::digits;
+
+            constexpr auto word_count(size_t bits) noexcept -> size_t
+            {
+                return (bits + word_bits - 1) / word_bits;
+            };
+            // bits of the last word that belong to a set of the given size.
+            constexpr auto tail_mask(size_t bits) noexcept -> word
+            {
+                return bits % word_bits == 0 ? ~word{ 0 } : (word{ 1 } << (bits % word_bits)) - 1;
+            };
+
+            // the bulk kernels are straight loops over whole words with no
+            // early exits, written so that the compiler vectorizes them.
+            constexpr auto bitwise_and(word* destination, const word* source, size_t count) noexcept -> void
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    destination[i] &= source[i];
+                }
+            };
+            constexpr auto bitwise_or(word* destination, const word* source, size_t count) noexcept -> void
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    destination[i] |= source[i];
+                }
+            };
+            constexpr auto bitwise_xor(word* destination, const word* source, size_t count) noexcept -> void
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    destination[i] ^= source[i];
+                }
+            };
+            constexpr auto bitwise_and_not(word* destination, const word* source, size_t count) noexcept -> void
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    destination[i] &= ~source[i];
+                }
+            };
+            constexpr auto bitwise_not(word* words, size_t count) noexcept -> void
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    words[i] = ~words[i];
+                }
+            };
+            constexpr auto popcount(const word* words, size_t count) noexcept -> size_t
+            {
+                size_t total = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    total += static_cast<size_t>(std::popcount(words[i]));
+                }
+                return total;
+            };
+            constexpr auto any(const word* words, size_t count) noexcept -> bool
+            {
+                word combined = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    combined |= words[i];
+                }
+                return combined != 0;
+            };
+            constexpr auto equal(const word* left, const word* right, size_t count) noexcept -> bool
+            {
+                word difference = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    difference |= left[i] ^ right[i];
+                }
+                return difference == 0;
+            };
+
+            // index of the first set bit at or after from, or bits if there is none.
+            constexpr auto find_next(const word* words, size_t bits, size_t from) noexcept -> size_t
+            {
+                if (from >= bits)
+                {
+                    return bits;
+                }
+                size_t index = from / word_bits;
+                word current = words[index] & (~word{ 0 } << (from % word_bits));
+                const size_t count = word_count(bits);
+                while (current == 0)
+                {
+                    if (++index == count)
+                    {
+                        return bits;
+                    }
+                    current = words[index];
+                }
+                return index * word_bits + static_cast<size_t>(std::countr_zero(current));
+            };
+
+            // shifts towards higher indices by amount, filling with zeros.
+            constexpr auto shift_up(word* words, size_t count, size_t amount) noexcept -> void
+            {
+                const size_t whole = amount / word_bits;
+                const size_t partial = amount % word_bits;
+                for (size_t i = count; i-- > 0;)
+                {
+                    word shifted = 0;
+                    if (i >= whole)
+                    {
+                        shifted = words[i - whole] << partial;
+                        if (partial != 0 and i > whole)
+                        {
+                            shifted |= words[i - whole - 1] >> (word_bits - partial);
+                        }
+                    }
+                    words[i] = shifted;
+                }
+            };
+            constexpr auto shift_down(word* words, size_t count, size_t amount) noexcept -> void
+            {
+                const size_t whole = amount / word_bits;
+                const size_t partial = amount % word_bits;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    word shifted = 0;
+                    if (i + whole < count)
+                    {
+                        shifted = words[i + whole] >> partial;
+                        if (partial != 0 and i + whole + 1 < count)
+                        {
+                            shifted |= words[i + whole + 1] << (word_bits - partial);
+                        }
+                    }
+                    words[i] = shifted;
+                }
+            };
+
+            // visits set bits by clearing the lowest one of a copy of the current
+            // word, so sparse sets skip empty stretches a word at a time.
+            struct one_iterator
+            {
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = size_t;
+                using difference_type = ptrdiff_t;
+                using reference = size_t;
+                using pointer = void;
+
+                constexpr one_iterator() = default;
+                constexpr one_iterator(const word* words, size_t count, size_t index) noexcept :
+                    words{ words },
+                    count{ count },
+                    index{ index },
+                    current{ index < count ? words[index] : 0 }
+                {
+                    skip_empty();
+                };
+
+                constexpr auto operator *() const noexcept -> size_t
+                {
+                    return index * word_bits + static_cast<size_t>(std::countr_zero(current));
+                };
+                constexpr auto operator ++() noexcept -> one_iterator&
+                {
+                    current &= current - 1;
+                    skip_empty();
+                    return *this;
+                };
+                constexpr auto operator ++(int) noexcept -> one_iterator
+                {
+                    auto old = *this;
+                    ++*this;
+                    return old;
+                };
+                friend constexpr auto operator ==(const one_iterator& left, const one_iterator& right) noexcept -> bool
+                {
+                    return left.index == right.index and left.current == right.current;
+                };
+
+            private:
+                constexpr auto skip_empty() noexcept -> void
+                {
+                    while (current == 0 and index < count)
+                    {
+                        if (++index < count)
+                        {
+                            current = words[index];
+                        }
+                    }
+                };
+
+                const word* words = nullptr;
+                size_t count = 0;
+                size_t index = 0;
+                word current = 0;
+            };
+
+            struct ones
+            {
+                const word* words;
+                size_t count;
+
+                [[nodiscard]] constexpr auto begin() const noexcept -> one_iterator
+                {
+                    return one_iterator{ words, count, 0 };
+                };
+                [[nodiscard]] constexpr auto end() const noexcept -> one_iterator
+                {
+                    return one_iterator{ words, count, count };
+                };
+            };
+
+            // byte i of a little-endian view of the words, through jpl::byte.
+            constexpr auto get_byte(const word* words, size_t i) noexcept -> byte
+            {
+                return byte{ static_cast<unsigned char>(words[i / sizeof(word)] >> (i % sizeof(word) * 8)) };
+            };
+            constexpr auto set_byte(word* words, size_t i, byte value) noexcept -> void
+            {
+                const size_t shift = i % sizeof(word) * 8;
+                word& target = words[i / sizeof(word)];
+                target = (target & ~(word{ 0xff } << shift)) | (word{ to_integer<unsigned char>(value) } << shift);
+            };
+        };
+    };
+
+    // a fixed-size set of bits stored in 64-bit words. bits past N in the last
+    // word are kept clear, so whole-word kernels never need masking on read.
+    template <size_t N>
+    struct bitset
+    {
+        using word_type = impl::bitset::word;
+        static constexpr size_t word_count = impl::bitset::word_count(N);
+
+        constexpr bitset() noexcept = default;
+        constexpr bitset(unsigned long long value) noexcept
+        {
+            if constexpr (word_count > 0)
+            {
+                words[0] = value;
+                trim();
+            }
+        };
+
+        [[nodiscard]] constexpr auto size() const noexcept -> size_t
+        {
+            return N;
+        };
+        [[nodiscard]] constexpr auto test(size_t i) const -> bool
+        {
+            if (i >= N)
+            {
+                throw std::out_of_range{ "jpl::bitset::test" };
+            }
+            return (*this)[i];
+        };
+        // unchecked.
+        [[nodiscard]] constexpr auto operator [](size_t i) const noexcept -> bool
+        {
+            return (words[i / impl::bitset::word_bits] >> (i % impl::bitset::word_bits)) & 1;
+        };
+
+        constexpr auto set() noexcept -> bitset&
+        {
+            for (auto& word : words)
+            {
+                word = ~word_type{ 0 };
+            }
+            trim();
+            return *this;
+        };
+        constexpr auto set(size_t i, bool value = true) noexcept -> bitset&
+        {
+            const word_type bit = word_type{ 1 } << (i % impl::bitset::word_bits);
+            word_type& word = words[i / impl::bitset::word_bits];
+            word = (word & ~bit) | (value ? bit : 0);
+            return *this;
+        };
+        constexpr auto reset() noexcept -> bitset&
+        {
+            for (auto& word : words)
+            {
+                word = 0;
+            }
+            return *this;
+        };
+        constexpr auto reset(size_t i) noexcept -> bitset&
+        {
+            return set(i, false);
+        };
+        constexpr auto flip() noexcept -> bitset&
+        {
+            impl::bitset::bitwise_not(words, word_count);
+            trim();
+            return *this;
+        };
+        constexpr auto flip(size_t i) noexcept -> bitset&
+        {
+            words[i / impl::bitset::word_bits] ^= word_type{ 1 } << (i % impl::bitset::word_bits);
+            return *this;
+        };
+
+        [[nodiscard]] constexpr auto count() const noexcept -> size_t
+        {
+            return impl::bitset::popcount(words, word_count);
+        };
+        [[nodiscard]] constexpr auto any() const noexcept -> bool
+        {
+            return impl::bitset::any(words, word_count);
+        };
+        [[nodiscard]] constexpr auto none() const noexcept -> bool
+        {
+            return not any();
+        };
+        [[nodiscard]] constexpr auto all() const noexcept -> bool
+        {
+            return count() == N;
+        };
+
+        // N when no bit is set.
+        [[nodiscard]] constexpr auto find_first() const noexcept -> size_t
+        {
+            return impl::bitset::find_next(words, N, 0);
+        };
+        // the first set bit after i, or N.
+        [[nodiscard]] constexpr auto find_next(size_t i) const noexcept -> size_t
+        {
+            return impl::bitset::find_next(words, N, i + 1);
+        };
+        // the indices of the set bits, in increasing order.
+        [[nodiscard]] constexpr auto ones() const noexcept -> impl::bitset::ones
+        {
+            return impl::bitset::ones{ words, word_count };
+        };
+
+        constexpr auto operator &=(const bitset& other) noexcept -> bitset&
+        {
+            impl::bitset::bitwise_and(words, other.words, word_count);
+            return *this;
+        };
+        constexpr auto operator |=(const bitset& other) noexcept -> bitset&
+        {
+            impl::bitset::bitwise_or(words, other.words, word_count);
+            return *this;
+        };
+        constexpr auto operator ^=(const bitset& other) noexcept -> bitset&
+        {
+            impl::bitset::bitwise_xor(words, other.words, word_count);
+            return *this;
+        };
+        // clears every bit set in other.
+        constexpr auto and_not(const bitset& other) noexcept -> bitset&
+        {
+            impl::bitset::bitwise_and_not(words, other.words, word_count);
+            return *this;
+        };
+        constexpr auto operator <<=(size_t amount) noexcept -> bitset&
+        {
+            impl::bitset::shift_up(words, word_count, amount);
+            trim();
+            return *this;
+        };
+        constexpr auto operator >>=(size_t amount) noexcept -> bitset&
+        {
+            impl::bitset::shift_down(words, word_count, amount);
+            return *this;
+        };
+        [[nodiscard]] constexpr auto operator ~() const noexcept -> bitset
+        {
+            return bitset{ *this }.flip();
+        };
+        [[nodiscard]] constexpr auto operator <<(size_t amount) const noexcept -> bitset
+        {
+            return bitset{ *this } <<= amount;
+        };
+        [[nodiscard]] constexpr auto operator >>(size_t amount) const noexcept -> bitset
+        {
+            return bitset{ *this } >>= amount;
+        };
+        [[nodiscard]] friend constexpr auto operator &(bitset left, const bitset& right) noexcept -> bitset
+        {
+            return left &= right;
+        };
+        [[nodiscard]] friend constexpr auto operator |(bitset left, const bitset& right) noexcept -> bitset
+        {
+            return left |= right;
+        };
+        [[nodiscard]] friend constexpr auto operator ^(bitset left, const bitset& right) noexcept -> bitset
+        {
+            return left ^= right;
+        };
+        [[nodiscard]] friend constexpr auto operator ==(const bitset& left, const bitset& right) noexcept -> bool
+        {
+            return impl::bitset::equal(left.words, right.words, word_count);
+        };
+
+        // byte-granular access in little-endian order, e.g. for serialization.
+        [[nodiscard]] constexpr auto byte_count() const noexcept -> size_t
+        {
+            return (N + 7) / 8;
+        };
+        [[nodiscard]] constexpr auto get_byte(size_t i) const noexcept -> byte
+        {
+            return impl::bitset::get_byte(words, i);
+        };
+        constexpr auto set_byte(size_t i, byte value) noexcept -> bitset&
+        {
+            impl::bitset::set_byte(words, i, value);
+            trim();
+            return *this;
+        };
+
+        [[nodiscard]] constexpr auto data() noexcept -> word_type*
+        {
+            return words;
+        };
+        [[nodiscard]] constexpr auto data() const noexcept -> const word_type*
+        {
+            return words;
+        };
+
+    private:
+        constexpr auto trim() noexcept -> void
+        {
+            if constexpr (word_count > 0)
+            {
+                words[word_count - 1] &= impl::bitset::tail_mask(N);
+            }
+        };
+
+        word_type words[word_count == 0 ? 1 : word_count]{};
+    };
+
+    // a bitset whose size is chosen at run time. binary operations require
+    // both operands to have the same size.
+    struct dynamic_bitset
+    {
+        using word_type = impl::bitset::word;
+
+        dynamic_bitset() = default;
+        explicit dynamic_bitset(size_t bits, bool value = false) :
+            words(impl::bitset::word_count(bits), value ? ~word_type{ 0 } : 0),
+            bits{ bits }
+        {
+            trim();
+        };
+
+        [[nodiscard]] auto size() const noexcept -> size_t
+        {
+            return bits;
+        };
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return bits == 0;
+        };
+        [[nodiscard]] auto word_count() const noexcept -> size_t
+        {
+            return words.size();
+        };
+        auto resize(size_t new_size, bool value = false) -> void
+        {
+            const size_t old_size = bits;
+            words.resize(impl::bitset::word_count(new_size), value ? ~word_type{ 0 } : 0);
+            bits = new_size;
+            if (value and new_size > old_size and old_size % impl::bitset::word_bits != 0)
+            {
+                words[old_size / impl::bitset::word_bits] |= ~impl::bitset::tail_mask(old_size);
+            }
+            trim();
+        };
+        auto push_back(bool value) -> void
+        {
+            if (bits % impl::bitset::word_bits == 0)
+            {
+                words.push_back(0);
+            }
+            ++bits;
+            set(bits - 1, value);
+        };
+        auto clear() noexcept -> void
+        {
+            words.clear();
+            bits = 0;
+        };
+
+        [[nodiscard]] auto test(size_t i) const -> bool
+        {
+            if (i >= bits)
+            {
+                throw std::out_of_range{ "jpl::dynamic_bitset::test" };
+            }
+            return (*this)[i];
+        };
+        // unchecked.
+        [[nodiscard]] auto operator [](size_t i) const noexcept -> bool
+        {
+            return (words[i / impl::bitset::word_bits] >> (i % impl::bitset::word_bits)) & 1;
+        };
+
+        auto set() noexcept -> dynamic_bitset&
+        {
+            std::fill(words.begin(), words.end(), ~word_type{ 0 });
+            trim();
+            return *this;
+        };
+        auto set(size_t i, bool value = true) noexcept -> dynamic_bitset&
+        {
+            const word_type bit = word_type{ 1 } << (i % impl::bitset::word_bits);
+            word_type& word = words[i / impl::bitset::word_bits];
+            word = (word & ~bit) | (value ? bit : 0);
+            return *this;
+        };
+        auto reset() noexcept -> dynamic_bitset&
+        {
+            std::fill(words.begin(), words.end(), 0);
+            return *this;
+        };
+        auto reset(size_t i) noexcept -> dynamic_bitset&
+        {
+            return set(i, false);
+        };
+        auto flip() noexcept -> dynamic_bitset&
+        {
+            impl::bitset::bitwise_not(words.data(), words.size());
+            trim();
+            return *this;
+        };
+        auto flip(size_t i) noexcept -> dynamic_bitset&
+        {
+            words[i / impl::bitset::word_bits] ^= word_type{ 1 } << (i % impl::bitset::word_bits);
+            return *this;
+        };
+
+        [[nodiscard]] auto count() const noexcept -> size_t
+        {
+            return impl::bitset::popcount(words.data(), words.size());
+        };
+        [[nodiscard]] auto any() const noexcept -> bool
+        {
+            return impl::bitset::any(words.data(), words.size());
+        };
+        [[nodiscard]] auto none() const noexcept -> bool
+        {
+            return not any();
+        };
+        [[nodiscard]] auto all() const noexcept -> bool
+        {
+            return count() == bits;
+        };
+
+        // size() when no bit is set.
+        [[nodiscard]] auto find_first() const noexcept -> size_t
+        {
+            return impl::bitset::find_next(words.data(), bits, 0);
+        };
+        // the first set bit after i, or size().
+        [[nodiscard]] auto find_next(size_t i) const noexcept -> size_t
+        {
+            return impl::bitset::find_next(words.data(), bits, i + 1);
+        };
+        // the indices of the set bits, in increasing order.
+        [[nodiscard]] auto ones() const noexcept -> impl::bitset::ones
+        {
+            return impl::bitset::ones{ words.data(), words.size() };
+        };
+
+        auto operator &=(const dynamic_bitset& other) noexcept -> dynamic_bitset&
+        {
+            impl::bitset::bitwise_and(words.data(), other.words.data(), words.size());
+            return *this;
+        };
+        auto operator |=(const dynamic_bitset& other) noexcept -> dynamic_bitset&
+        {
+            impl::bitset::bitwise_or(words.data(), other.words.data(), words.size());
+            return *this;
+        };
+        auto operator ^=(const dynamic_bitset& other) noexcept -> dynamic_bitset&
+        {
+            impl::bitset::bitwise_xor(words.data(), other.words.data(), words.size());
+            return *this;
+        };
+        // clears every bit set in other.
+        auto and_not(const dynamic_bitset& other) noexcept -> dynamic_bitset&
+        {
+            impl::bitset::bitwise_and_not(words.data(), other.words.data(), words.size());
+            return *this;
+        };
+        auto operator <<=(size_t amount) noexcept -> dynamic_bitset&
+        {
+            impl::bitset::shift_up(words.data(), words.size(), amount);
+            trim();
+            return *this;
+        };
+        auto operator >>=(size_t amount) noexcept -> dynamic_bitset&
+        {
+            impl::bitset::shift_down(words.data(), words.size(), amount);
+            return *this;
+        };
+        [[nodiscard]] auto operator ~() const -> dynamic_bitset
+        {
+            return dynamic_bitset{ *this }.flip();
+        };
+        [[nodiscard]] friend auto operator &(dynamic_bitset left, const dynamic_bitset& right) noexcept -> dynamic_bitset
+        {
+            return left &= right;
+        };
+        [[nodiscard]] friend auto operator |(dynamic_bitset left, const dynamic_bitset& right) noexcept -> dynamic_bitset
+        {
+            return left |= right;
+        };
+        [[nodiscard]] friend auto operator ^(dynamic_bitset left, const dynamic_bitset& right) noexcept -> dynamic_bitset
+        {
+            return left ^= right;
+        };
+        [[nodiscard]] friend auto operator ==(const dynamic_bitset& left, const dynamic_bitset& right) noexcept -> bool
+        {
+            return left.bits == right.bits and impl::bitset::equal(left.words.data(), right.words.data(), left.words.size());
+        };
+
+        [[nodiscard]] auto byte_count() const noexcept -> size_t
+        {
+            return (bits + 7) / 8;
+        };
+        [[nodiscard]] auto get_byte(size_t i) const noexcept -> byte
+        {
+            return impl::bitset::get_byte(words.data(), i);
+        };
+        auto set_byte(size_t i, byte value) noexcept -> dynamic_bitset&
+        {
+            impl::bitset::set_byte(words.data(), i, value);
+            trim();
+            return *this;
+        };
+
+        [[nodiscard]] auto data() noexcept -> word_type*
+        {
+            return words.data();
+        };
+        [[nodiscard]] auto data() const noexcept -> const word_type*
+        {
+            return words.data();
+        };
+
+    private:
+        auto trim() noexcept -> void
+        {
+            if (not words.empty())
+            {
+                words.back() &= impl::bitset::tail_mask(bits);
+            }
+        };
+
+        std::vector<word_type> words;
+        size_t bits = 0;
+    };
+};
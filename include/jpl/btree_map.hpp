@@ -0,0 +1,849 @@
+#pragma once
+
+#include "algorithm.hpp"
+#include "cstddef.hpp"
+#include "new.hpp"
+#include "object_pool.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// btree_map
+namespace jpl
+{
+    namespace impl
+    {
+        namespace btree_map
+        {
+            inline constexpr size_t cache_line = hardware_constructive_interference_size;
+
+            // uninitialized storage for up to N objects; the owning node tracks how
+            // many of the leading slots are alive.
+            template <typename T, size_t N>
+            struct slots
+            {
+                alignas(T) unsigned char storage[sizeof(T) * N];
+
+                auto data() noexcept -> T*
+                {
+                    return std::launder(reinterpret_cast<T*>(storage));
+                };
+                auto data() const noexcept -> const T*
+                {
+                    return std::launder(reinterpret_cast<const T*>(storage));
+                };
+                auto operator [](size_t i) noexcept -> T&
+                {
+                    return data()[i];
+                };
+                auto operator [](size_t i) const noexcept -> const T&
+                {
+                    return data()[i];
+                };
+            };
+
+            // opens a hole at index in [0, count) and fills it with value.
+            template <typename T, typename U>
+            auto insert_at(T* array, size_t count, size_t index, U&& value) -> void
+            {
+                if (index == count)
+                {
+                    std::construct_at(array + count, jpl::forward<U>(value));
+                    return;
+                }
+                std::construct_at(array + count, jpl::move(array[count - 1]));
+                std::move_backward(array + index, array + count - 1, array + count);
+                array[index] = jpl::forward<U>(value);
+            };
+            template <typename T>
+            auto erase_at(T* array, size_t count, size_t index) -> void
+            {
+                std::move(array + index + 1, array + count, array + index);
+                std::destroy_at(array + count - 1);
+            };
+            // moves [from, to) of source into uninitialized destination, ending
+            // their lifetimes in source.
+            template <typename T>
+            auto transfer(T* source, size_t from, size_t to, T* destination) -> void
+            {
+                std::uninitialized_move(source + from, source + to, destination);
+                std::destroy(source + from, source + to);
+            };
+
+            template <typename Reference>
+            struct arrow_proxy
+            {
+                Reference reference;
+
+                auto operator ->() noexcept -> Reference*
+                {
+                    return &reference;
+                };
+            };
+        };
+    };
+
+    // a b+tree: every element lives in a leaf, leaves are linked for iteration,
+    // and internal nodes hold only separator keys and children. nodes are sized
+    // to a multiple of the cache line, keep keys apart from values so in-node
+    // searches scan only keys, and come from per-map pools.
+    //
+    // inserts and erases invalidate iterators.
+    template <typename Key, typename T, typename Compare = std::less<Key>, size_t NodeBytes = 4 * impl::btree_map::cache_line>
+    struct btree_map
+    {
+        static_assert(NodeBytes % impl::btree_map::cache_line == 0, "NodeBytes must be a multiple of the cache line.");
+
+    private:
+        struct internal_node;
+        struct node
+        {
+            internal_node* parent = nullptr;
+            unsigned int count = 0;
+            bool leaf;
+
+            explicit node(bool leaf) noexcept :
+                leaf{ leaf }
+            {};
+        };
+
+        static constexpr size_t leaf_capacity = std::max<size_t>(3, (NodeBytes - sizeof(node) - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(T)));
+        static constexpr size_t internal_capacity = std::max<size_t>(3, (NodeBytes - sizeof(node) - sizeof(void*)) / (sizeof(Key) + sizeof(void*)));
+        static constexpr size_t leaf_minimum = leaf_capacity / 2;
+        static constexpr size_t internal_minimum = internal_capacity / 2;
+
+        struct alignas(impl::btree_map::cache_line) leaf_node : node
+        {
+            impl::btree_map::slots<Key, leaf_capacity> keys;
+            impl::btree_map::slots<T, leaf_capacity> values;
+            leaf_node* previous = nullptr;
+            leaf_node* next = nullptr;
+
+            leaf_node() noexcept :
+                node{ true }
+            {};
+        };
+        struct alignas(impl::btree_map::cache_line) internal_node : node
+        {
+            impl::btree_map::slots<Key, internal_capacity> keys;
+            node* children[internal_capacity + 1];
+
+            internal_node() noexcept :
+                node{ false }
+            {};
+        };
+
+        template <bool Const>
+        struct iterator_type
+        {
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = ptrdiff_t;
+            using value_type = std::pair<Key, T>;
+            using reference = std::pair<const Key&, conditional_t<Const, const T&, T&>>;
+            using pointer = impl::btree_map::arrow_proxy<reference>;
+
+            iterator_type() = default;
+            iterator_type(leaf_node* leaf, size_t index) noexcept :
+                leaf{ leaf },
+                index{ index }
+            {};
+            template <bool C = Const> requires C
+            iterator_type(const iterator_type<false>& other) noexcept :
+                leaf{ other.leaf },
+                index{ other.index }
+            {};
+
+            auto operator *() const -> reference
+            {
+                return reference{ leaf->keys[index], leaf->values[index] };
+            };
+            auto operator ->() const -> pointer
+            {
+                return pointer{ **this };
+            };
+
+            auto operator ++() -> iterator_type&
+            {
+                if (++index == leaf->count and leaf->next != nullptr)
+                {
+                    leaf = leaf->next;
+                    index = 0;
+                }
+                return *this;
+            };
+            auto operator ++(int) -> iterator_type
+            {
+                auto old = *this;
+                ++*this;
+                return old;
+            };
+            auto operator --() -> iterator_type&
+            {
+                if (index == 0)
+                {
+                    leaf = leaf->previous;
+                    index = leaf->count;
+                }
+                --index;
+                return *this;
+            };
+            auto operator --(int) -> iterator_type
+            {
+                auto old = *this;
+                --*this;
+                return old;
+            };
+
+            friend auto operator ==(const iterator_type& left, const iterator_type& right) noexcept -> bool
+            {
+                return left.leaf == right.leaf and left.index == right.index;
+            };
+
+        private:
+            friend struct btree_map;
+            template <bool>
+            friend struct iterator_type;
+
+            leaf_node* leaf = nullptr;
+            size_t index = 0;
+        };
+
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<Key, T>;
+        using key_compare = Compare;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = iterator_type<false>;
+        using const_iterator = iterator_type<true>;
+
+        btree_map() = default;
+        explicit btree_map(const key_compare& compare) :
+            compare{ compare }
+        {};
+        template <std::input_iterator I>
+        btree_map(I first, I last, const key_compare& compare = key_compare{}) :
+            compare{ compare }
+        {
+            insert(first, last);
+        };
+        btree_map(std::initializer_list<value_type> values, const key_compare& compare = key_compare{}) :
+            btree_map(values.begin(), values.end(), compare)
+        {};
+        btree_map(const btree_map& other) :
+            compare{ other.compare }
+        {
+            for (const auto& [key, value] : other)
+            {
+                try_emplace(key, value);
+            }
+        };
+        btree_map(btree_map&& other) noexcept :
+            compare{ jpl::move(other.compare) },
+            leaves{ jpl::move(other.leaves) },
+            internals{ jpl::move(other.internals) },
+            root{ jpl::exchange(other.root, nullptr) },
+            first_leaf{ jpl::exchange(other.first_leaf, nullptr) },
+            last_leaf{ jpl::exchange(other.last_leaf, nullptr) },
+            element_count{ jpl::exchange(other.element_count, 0) }
+        {};
+        auto operator =(btree_map other) noexcept -> btree_map&
+        {
+            swap(other);
+            return *this;
+        };
+        ~btree_map()
+        {
+            clear();
+        };
+
+        auto swap(btree_map& other) noexcept -> void
+        {
+            using std::swap;
+            swap(compare, other.compare);
+            swap(leaves, other.leaves);
+            swap(internals, other.internals);
+            swap(root, other.root);
+            swap(first_leaf, other.first_leaf);
+            swap(last_leaf, other.last_leaf);
+            swap(element_count, other.element_count);
+        };
+
+        [[nodiscard]] auto begin() noexcept -> iterator
+        {
+            return iterator{ first_leaf, 0 };
+        };
+        [[nodiscard]] auto end() noexcept -> iterator
+        {
+            return iterator{ last_leaf, last_leaf != nullptr ? last_leaf->count : 0 };
+        };
+        [[nodiscard]] auto begin() const noexcept -> const_iterator
+        {
+            return const_cast<btree_map*>(this)->begin();
+        };
+        [[nodiscard]] auto end() const noexcept -> const_iterator
+        {
+            return const_cast<btree_map*>(this)->end();
+        };
+        [[nodiscard]] auto cbegin() const noexcept -> const_iterator
+        {
+            return begin();
+        };
+        [[nodiscard]] auto cend() const noexcept -> const_iterator
+        {
+            return end();
+        };
+
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return element_count == 0;
+        };
+        [[nodiscard]] auto size() const noexcept -> size_type
+        {
+            return element_count;
+        };
+        [[nodiscard]] auto key_comp() const -> key_compare
+        {
+            return compare;
+        };
+
+        auto clear() noexcept -> void
+        {
+            if (root != nullptr)
+            {
+                destroy_subtree(root);
+            }
+            root = nullptr;
+            first_leaf = nullptr;
+            last_leaf = nullptr;
+            element_count = 0;
+        };
+
+        [[nodiscard]] auto lower_bound(const key_type& key) -> iterator
+        {
+            if (root == nullptr)
+            {
+                return end();
+            }
+            leaf_node* leaf = find_leaf(key);
+            return normalized(leaf, count_less(leaf->keys.data(), leaf->count, key));
+        };
+        [[nodiscard]] auto lower_bound(const key_type& key) const -> const_iterator
+        {
+            return const_cast<btree_map*>(this)->lower_bound(key);
+        };
+        [[nodiscard]] auto upper_bound(const key_type& key) -> iterator
+        {
+            if (root == nullptr)
+            {
+                return end();
+            }
+            leaf_node* leaf = find_leaf(key);
+            return normalized(leaf, count_not_greater(leaf->keys.data(), leaf->count, key));
+        };
+        [[nodiscard]] auto upper_bound(const key_type& key) const -> const_iterator
+        {
+            return const_cast<btree_map*>(this)->upper_bound(key);
+        };
+        [[nodiscard]] auto find(const key_type& key) -> iterator
+        {
+            if (root == nullptr)
+            {
+                return end();
+            }
+            leaf_node* leaf = find_leaf(key);
+            const size_t index = count_less(leaf->keys.data(), leaf->count, key);
+            if (index == leaf->count or compare(key, leaf->keys[index]))
+            {
+                return end();
+            }
+            return iterator{ leaf, index };
+        };
+        [[nodiscard]] auto find(const key_type& key) const -> const_iterator
+        {
+            return const_cast<btree_map*>(this)->find(key);
+        };
+        [[nodiscard]] auto contains(const key_type& key) const -> bool
+        {
+            return find(key) != end();
+        };
+        [[nodiscard]] auto count(const key_type& key) const -> size_type
+        {
+            return contains(key) ? 1 : 0;
+        };
+
+        [[nodiscard]] auto at(const key_type& key) -> mapped_type&
+        {
+            const auto position = find(key);
+            if (position == end())
+            {
+                throw std::out_of_range{ "jpl::btree_map::at" };
+            }
+            return (*position).second;
+        };
+        [[nodiscard]] auto at(const key_type& key) const -> const mapped_type&
+        {
+            return const_cast<btree_map*>(this)->at(key);
+        };
+        auto operator [](const key_type& key) -> mapped_type&
+        {
+            return (*try_emplace(key).first).second;
+        };
+        auto operator [](key_type&& key) -> mapped_type&
+        {
+            return (*try_emplace(jpl::move(key)).first).second;
+        };
+
+        template <typename K, typename... Args>
+        auto try_emplace(K&& key, Args&&... args) -> std::pair<iterator, bool>
+        {
+            if (root == nullptr)
+            {
+                leaf_node* leaf = leaves.create();
+                root = leaf;
+                first_leaf = leaf;
+                last_leaf = leaf;
+            }
+
+            leaf_node* leaf = find_leaf(key);
+            size_t index = count_less(leaf->keys.data(), leaf->count, key);
+            if (index < leaf->count and not compare(key, leaf->keys[index]))
+            {
+                return { iterator{ leaf, index }, false };
+            }
+
+            key_type new_key(jpl::forward<K>(key));
+            mapped_type new_value(jpl::forward<Args>(args)...);
+            if (leaf->count == leaf_capacity)
+            {
+                leaf_node* right = split_leaf(leaf);
+                if (index > leaf->count)
+                {
+                    index -= leaf->count;
+                    leaf = right;
+                }
+            }
+            impl::btree_map::insert_at(leaf->keys.data(), leaf->count, index, jpl::move(new_key));
+            impl::btree_map::insert_at(leaf->values.data(), leaf->count, index, jpl::move(new_value));
+            ++leaf->count;
+            ++element_count;
+            return { iterator{ leaf, index }, true };
+        };
+        template <typename M>
+        auto insert_or_assign(const key_type& key, M&& value) -> std::pair<iterator, bool>
+        {
+            auto result = try_emplace(key, jpl::forward<M>(value));
+            if (not result.second)
+            {
+                (*result.first).second = jpl::forward<M>(value);
+            }
+            return result;
+        };
+        auto insert(const value_type& value) -> std::pair<iterator, bool>
+        {
+            return try_emplace(value.first, value.second);
+        };
+        auto insert(value_type&& value) -> std::pair<iterator, bool>
+        {
+            return try_emplace(jpl::move(value.first), jpl::move(value.second));
+        };
+        template <std::input_iterator I>
+        auto insert(I first, I last) -> void
+        {
+            for (; first != last; ++first)
+            {
+                const auto& [key, value] = *first;
+                try_emplace(key, value);
+            }
+        };
+
+        auto erase(const_iterator position) -> iterator
+        {
+            return erase_from_leaf(position.leaf, position.index);
+        };
+        auto erase(iterator position) -> iterator
+        {
+            return erase_from_leaf(position.leaf, position.index);
+        };
+        auto erase(const key_type& key) -> size_type
+        {
+            const auto position = find(key);
+            if (position == end())
+            {
+                return 0;
+            }
+            erase(position);
+            return 1;
+        };
+
+    private:
+        // number of keys less than key: the lower bound within a node. small
+        // nodes of arithmetic keys are scanned without early exit, which the
+        // compiler turns into a branch-free (and usually vectorized) count.
+        template <typename K>
+        auto count_less(const key_type* keys, size_t count, const K& key) const -> size_t
+        {
+            if constexpr (impl::sort::use_branchless<key_type, key_compare>)
+            {
+                size_t less = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    less += compare(keys[i], key) ? 1 : 0;
+                }
+                return less;
+            }
+            else
+            {
+                return static_cast<size_t>(jpl::branchless_lower_bound(keys, keys + count, key, compare) - keys);
+            }
+        };
+        // number of keys not greater than key: the upper bound within a node,
+        // and the child to descend into.
+        template <typename K>
+        auto count_not_greater(const key_type* keys, size_t count, const K& key) const -> size_t
+        {
+            if constexpr (impl::sort::use_branchless<key_type, key_compare>)
+            {
+                size_t not_greater = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    not_greater += compare(key, keys[i]) ? 0 : 1;
+                }
+                return not_greater;
+            }
+            else
+            {
+                return static_cast<size_t>(jpl::branchless_upper_bound(keys, keys + count, key, compare) - keys);
+            }
+        };
+
+        template <typename K>
+        auto find_leaf(const K& key) const -> leaf_node*
+        {
+            node* current = root;
+            while (not current->leaf)
+            {
+                auto* internal = static_cast<internal_node*>(current);
+                current = internal->children[count_not_greater(internal->keys.data(), internal->count, key)];
+            }
+            return static_cast<leaf_node*>(current);
+        };
+
+        // one past a leaf's last element is the next leaf's first, except at the end.
+        auto normalized(leaf_node* leaf, size_t index) noexcept -> iterator
+        {
+            if (index == leaf->count and leaf->next != nullptr)
+            {
+                return iterator{ leaf->next, 0 };
+            }
+            return iterator{ leaf, index };
+        };
+
+        static auto child_index(const internal_node* parent, const node* child) noexcept -> size_t
+        {
+            size_t index = 0;
+            while (parent->children[index] != child)
+            {
+                ++index;
+            }
+            return index;
+        };
+
+        auto split_leaf(leaf_node* leaf) -> leaf_node*
+        {
+            leaf_node* right = leaves.create();
+            const size_t middle = leaf->count / 2;
+            impl::btree_map::transfer(leaf->keys.data(), middle, leaf->count, right->keys.data());
+            impl::btree_map::transfer(leaf->values.data(), middle, leaf->count, right->values.data());
+            right->count = leaf->count - middle;
+            leaf->count = middle;
+
+            right->previous = leaf;
+            right->next = leaf->next;
+            if (leaf->next != nullptr)
+            {
+                leaf->next->previous = right;
+            }
+            leaf->next = right;
+            if (last_leaf == leaf)
+            {
+                last_leaf = right;
+            }
+
+            insert_into_parent(leaf, key_type(right->keys[0]), right);
+            return right;
+        };
+
+        // right becomes the child after left, separated by separator.
+        auto insert_into_parent(node* left, key_type&& separator, node* right) -> void
+        {
+            internal_node* parent = left->parent;
+            if (parent == nullptr)
+            {
+                internal_node* top = internals.create();
+                std::construct_at(top->keys.data(), jpl::move(separator));
+                top->children[0] = left;
+                top->children[1] = right;
+                top->count = 1;
+                left->parent = top;
+                right->parent = top;
+                root = top;
+                return;
+            }
+
+            size_t index = child_index(parent, left);
+            if (parent->count == internal_capacity)
+            {
+                // split around the middle key, which moves up a level.
+                internal_node* sibling = internals.create();
+                const size_t middle = internal_capacity / 2;
+                key_type promoted = jpl::move(parent->keys[middle]);
+                impl::btree_map::transfer(parent->keys.data(), middle + 1, parent->count, sibling->keys.data());
+                std::destroy_at(&parent->keys[middle]);
+                for (size_t child = middle + 1; child <= parent->count; ++child)
+                {
+                    sibling->children[child - middle - 1] = parent->children[child];
+                    parent->children[child]->parent = sibling;
+                }
+                sibling->count = parent->count - middle - 1;
+                parent->count = middle;
+
+                insert_into_parent(parent, jpl::move(promoted), sibling);
+                if (index > middle)
+                {
+                    index -= middle + 1;
+                    parent = sibling;
+                }
+            }
+
+            impl::btree_map::insert_at(parent->keys.data(), parent->count, index, jpl::move(separator));
+            std::move_backward(parent->children + index + 1, parent->children + parent->count + 1, parent->children + parent->count + 2);
+            parent->children[index + 1] = right;
+            right->parent = parent;
+            ++parent->count;
+        };
+
+        static auto remove_from_internal(internal_node* parent, size_t key_index, size_t child) -> void
+        {
+            impl::btree_map::erase_at(parent->keys.data(), parent->count, key_index);
+            std::move(parent->children + child + 1, parent->children + parent->count + 1, parent->children + child);
+            --parent->count;
+        };
+
+        auto unlink(leaf_node* leaf) noexcept -> void
+        {
+            if (leaf->previous != nullptr)
+            {
+                leaf->previous->next = leaf->next;
+            }
+            if (leaf->next != nullptr)
+            {
+                leaf->next->previous = leaf->previous;
+            }
+            if (last_leaf == leaf)
+            {
+                last_leaf = leaf->previous;
+            }
+            if (first_leaf == leaf)
+            {
+                first_leaf = leaf->next;
+            }
+        };
+
+        // removes one element and restores the minimum occupancy by borrowing
+        // from or merging with a sibling, tracking where the following element
+        // ends up so it can be returned.
+        auto erase_from_leaf(leaf_node* leaf, size_t index) -> iterator
+        {
+            impl::btree_map::erase_at(leaf->keys.data(), leaf->count, index);
+            impl::btree_map::erase_at(leaf->values.data(), leaf->count, index);
+            --leaf->count;
+            --element_count;
+
+            if (leaf == root)
+            {
+                if (leaf->count == 0)
+                {
+                    leaves.destroy(leaf);
+                    root = nullptr;
+                    first_leaf = nullptr;
+                    last_leaf = nullptr;
+                    return end();
+                }
+                return normalized(leaf, index);
+            }
+            if (leaf->count >= leaf_minimum)
+            {
+                return normalized(leaf, index);
+            }
+
+            internal_node* parent = leaf->parent;
+            const size_t position = child_index(parent, leaf);
+            auto* left = position > 0 ? static_cast<leaf_node*>(parent->children[position - 1]) : nullptr;
+            auto* right = position < parent->count ? static_cast<leaf_node*>(parent->children[position + 1]) : nullptr;
+
+            if (left != nullptr and left->count > leaf_minimum)
+            {
+                impl::btree_map::insert_at(leaf->keys.data(), leaf->count, 0, jpl::move(left->keys[left->count - 1]));
+                impl::btree_map::insert_at(leaf->values.data(), leaf->count, 0, jpl::move(left->values[left->count - 1]));
+                std::destroy_at(&left->keys[left->count - 1]);
+                std::destroy_at(&left->values[left->count - 1]);
+                --left->count;
+                ++leaf->count;
+                parent->keys[position - 1] = leaf->keys[0];
+                return normalized(leaf, index + 1);
+            }
+            if (right != nullptr and right->count > leaf_minimum)
+            {
+                std::construct_at(&leaf->keys[leaf->count], jpl::move(right->keys[0]));
+                std::construct_at(&leaf->values[leaf->count], jpl::move(right->values[0]));
+                impl::btree_map::erase_at(right->keys.data(), right->count, 0);
+                impl::btree_map::erase_at(right->values.data(), right->count, 0);
+                --right->count;
+                ++leaf->count;
+                parent->keys[position] = right->keys[0];
+                return normalized(leaf, index);
+            }
+
+            leaf_node* survivor;
+            size_t survivor_index;
+            if (left != nullptr)
+            {
+                survivor = left;
+                survivor_index = left->count + index;
+                merge_leaves(left, leaf, position - 1);
+            }
+            else
+            {
+                survivor = leaf;
+                survivor_index = index;
+                merge_leaves(leaf, right, position);
+            }
+            rebalance(parent);
+            return normalized(survivor, survivor_index);
+        };
+
+        // right is folded into left, its left neighbour, and freed.
+        auto merge_leaves(leaf_node* left, leaf_node* right, size_t separator) -> void
+        {
+            impl::btree_map::transfer(right->keys.data(), 0, right->count, left->keys.data() + left->count);
+            impl::btree_map::transfer(right->values.data(), 0, right->count, left->values.data() + left->count);
+            left->count += right->count;
+            right->count = 0;
+            unlink(right);
+            remove_from_internal(left->parent, separator, separator + 1);
+            leaves.destroy(right);
+        };
+
+        auto rebalance(internal_node* current) -> void
+        {
+            if (current == root)
+            {
+                if (current->count == 0)
+                {
+                    root = current->children[0];
+                    root->parent = nullptr;
+                    internals.destroy(current);
+                }
+                return;
+            }
+            if (current->count >= internal_minimum)
+            {
+                return;
+            }
+
+            internal_node* parent = current->parent;
+            const size_t position = child_index(parent, current);
+            auto* left = position > 0 ? static_cast<internal_node*>(parent->children[position - 1]) : nullptr;
+            auto* right = position < parent->count ? static_cast<internal_node*>(parent->children[position + 1]) : nullptr;
+
+            if (left != nullptr and left->count > internal_minimum)
+            {
+                // rotate through the parent: its separator comes down, the left
+                // sibling's last key goes up, and its last child moves across.
+                impl::btree_map::insert_at(current->keys.data(), current->count, 0, jpl::move(parent->keys[position - 1]));
+                std::move_backward(current->children, current->children + current->count + 1, current->children + current->count + 2);
+                current->children[0] = left->children[left->count];
+                current->children[0]->parent = current;
+                ++current->count;
+                parent->keys[position - 1] = jpl::move(left->keys[left->count - 1]);
+                std::destroy_at(&left->keys[left->count - 1]);
+                --left->count;
+                return;
+            }
+            if (right != nullptr and right->count > internal_minimum)
+            {
+                std::construct_at(&current->keys[current->count], jpl::move(parent->keys[position]));
+                current->children[current->count + 1] = right->children[0];
+                current->children[current->count + 1]->parent = current;
+                ++current->count;
+                parent->keys[position] = jpl::move(right->keys[0]);
+                remove_from_internal(right, 0, 0);
+                return;
+            }
+
+            if (left != nullptr)
+            {
+                merge_internals(left, current, position - 1);
+            }
+            else
+            {
+                merge_internals(current, right, position);
+            }
+            rebalance(parent);
+        };
+
+        // right is folded into left along with the separator between them.
+        auto merge_internals(internal_node* left, internal_node* right, size_t separator) -> void
+        {
+            internal_node* parent = left->parent;
+            std::construct_at(&left->keys[left->count], jpl::move(parent->keys[separator]));
+            impl::btree_map::transfer(right->keys.data(), 0, right->count, left->keys.data() + left->count + 1);
+            for (size_t child = 0; child <= right->count; ++child)
+            {
+                left->children[left->count + 1 + child] = right->children[child];
+                right->children[child]->parent = left;
+            }
+            left->count += right->count + 1;
+            right->count = 0;
+            remove_from_internal(parent, separator, separator + 1);
+            internals.destroy(right);
+        };
+
+        auto destroy_subtree(node* current) noexcept -> void
+        {
+            if (current->leaf)
+            {
+                auto* leaf = static_cast<leaf_node*>(current);
+                std::destroy(leaf->keys.data(), leaf->keys.data() + leaf->count);
+                std::destroy(leaf->values.data(), leaf->values.data() + leaf->count);
+                leaves.destroy(leaf);
+                return;
+            }
+            auto* internal = static_cast<internal_node*>(current);
+            for (size_t child = 0; child <= internal->count; ++child)
+            {
+                destroy_subtree(internal->children[child]);
+            }
+            std::destroy(internal->keys.data(), internal->keys.data() + internal->count);
+            internals.destroy(internal);
+        };
+
+        [[no_unique_address]] key_compare compare;
+        object_pool<leaf_node> leaves;
+        object_pool<internal_node> internals;
+        node* root = nullptr;
+        leaf_node* first_leaf = nullptr;
+        leaf_node* last_leaf = nullptr;
+        size_t element_count = 0;
+    };
+};
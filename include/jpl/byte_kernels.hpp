@@ -0,0 +1,268 @@
+#pragma once
+
+#include "cstddef.hpp"
+
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JPL_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// byte_kernels::npos
+// byte_kernels::find
+// byte_kernels::find_first_of
+// byte_kernels::mismatch
+// byte_kernels::compare
+namespace jpl
+{
+    // search and comparison over raw character ranges, processing 16 bytes per
+    // step with sse2 where available. in constant evaluation, and on targets
+    // without sse2, they fall back to plain loops with the same results.
+    namespace byte_kernels
+    {
+        inline constexpr size_t npos = static_cast<size_t>(-1);
+    };
+
+    namespace impl
+    {
+        namespace byte_kernels
+        {
+            constexpr auto find(const char* data, size_t size, char c, size_t from = 0) noexcept -> size_t
+            {
+                for (size_t i = from; i < size; ++i)
+                {
+                    if (data[i] == c)
+                    {
+                        return i;
+                    }
+                }
+                return jpl::byte_kernels::npos;
+            };
+            constexpr auto mismatch(const char* left, const char* right, size_t size, size_t from = 0) noexcept -> size_t
+            {
+                for (size_t i = from; i < size; ++i)
+                {
+                    if (left[i] != right[i])
+                    {
+                        return i;
+                    }
+                }
+                return size;
+            };
+            constexpr auto equal(const char* left, const char* right, size_t size) noexcept -> bool
+            {
+                return mismatch(left, right, size) == size;
+            };
+
+            // a 256-bit membership table; one test per haystack byte regardless
+            // of how many characters the set has.
+            struct byte_set
+            {
+                unsigned long long bits[4]{};
+
+                constexpr byte_set(const char* set, size_t size) noexcept
+                {
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        const auto value = static_cast<unsigned char>(set[i]);
+                        bits[value / 64] |= 1ull << (value % 64);
+                    }
+                };
+                constexpr auto contains(char c) const noexcept -> bool
+                {
+                    const auto value = static_cast<unsigned char>(c);
+                    return (bits[value / 64] >> (value % 64)) & 1;
+                };
+            };
+            constexpr auto find_first_of(const char* data, size_t size, const byte_set& set, size_t from = 0) noexcept -> size_t
+            {
+                for (size_t i = from; i < size; ++i)
+                {
+                    if (set.contains(data[i]))
+                    {
+                        return i;
+                    }
+                }
+                return jpl::byte_kernels::npos;
+            };
+
+            constexpr auto find_substring(const char* haystack, size_t size, const char* needle, size_t length, size_t from = 0) noexcept -> size_t
+            {
+                for (size_t i = from; i + length <= size; ++i)
+                {
+                    if (haystack[i] == needle[0] and equal(haystack + i + 1, needle + 1, length - 1))
+                    {
+                        return i;
+                    }
+                }
+                return jpl::byte_kernels::npos;
+            };
+
+#if defined(JPL_HAS_SSE2)
+            inline auto load(const char* data) noexcept -> __m128i
+            {
+                return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+            };
+            inline auto matches(__m128i block, __m128i value) noexcept -> unsigned int
+            {
+                return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, value)));
+            };
+#endif
+        };
+    };
+
+    namespace byte_kernels
+    {
+        // index of the first c in [data, data + size), or npos.
+        constexpr auto find(const char* data, size_t size, char c) noexcept -> size_t
+        {
+            if consteval
+            {
+                return impl::byte_kernels::find(data, size, c);
+            }
+            else
+            {
+                size_t i = 0;
+#if defined(JPL_HAS_SSE2)
+                const __m128i value = _mm_set1_epi8(c);
+                for (; i + 16 <= size; i += 16)
+                {
+                    if (const unsigned int mask = impl::byte_kernels::matches(impl::byte_kernels::load(data + i), value); mask != 0)
+                    {
+                        return i + static_cast<size_t>(std::countr_zero(mask));
+                    }
+                }
+#endif
+                return impl::byte_kernels::find(data, size, c, i);
+            }
+        };
+
+        // index of the first byte that is any of [set, set + set_size), or npos.
+        // small sets are compared against every byte of a block at once; larger
+        // ones go through a membership table.
+        constexpr auto find_first_of(const char* data, size_t size, const char* set, size_t set_size) noexcept -> size_t
+        {
+            if (set_size == 0)
+            {
+                return npos;
+            }
+            if (set_size == 1)
+            {
+                return byte_kernels::find(data, size, set[0]);
+            }
+            if consteval
+            {
+                return impl::byte_kernels::find_first_of(data, size, impl::byte_kernels::byte_set{ set, set_size });
+            }
+            else
+            {
+                size_t i = 0;
+#if defined(JPL_HAS_SSE2)
+                if (set_size <= 8)
+                {
+                    __m128i values[8];
+                    for (size_t j = 0; j < set_size; ++j)
+                    {
+                        values[j] = _mm_set1_epi8(set[j]);
+                    }
+                    for (; i + 16 <= size; i += 16)
+                    {
+                        const __m128i block = impl::byte_kernels::load(data + i);
+                        __m128i hits = _mm_cmpeq_epi8(block, values[0]);
+                        for (size_t j = 1; j < set_size; ++j)
+                        {
+                            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, values[j]));
+                        }
+                        if (const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(hits)); mask != 0)
+                        {
+                            return i + static_cast<size_t>(std::countr_zero(mask));
+                        }
+                    }
+                }
+#endif
+                return impl::byte_kernels::find_first_of(data, size, impl::byte_kernels::byte_set{ set, set_size }, i);
+            }
+        };
+
+        // index of the first occurrence of the needle, or npos. blocks are
+        // filtered on the needle's first and last characters together, which
+        // rejects almost every position before any full comparison.
+        constexpr auto find(const char* haystack, size_t size, const char* needle, size_t length) noexcept -> size_t
+        {
+            if (length == 0)
+            {
+                return 0;
+            }
+            if (length > size)
+            {
+                return npos;
+            }
+            if (length == 1)
+            {
+                return byte_kernels::find(haystack, size, needle[0]);
+            }
+            if consteval
+            {
+                return impl::byte_kernels::find_substring(haystack, size, needle, length);
+            }
+            else
+            {
+                size_t i = 0;
+#if defined(JPL_HAS_SSE2)
+                const __m128i first = _mm_set1_epi8(needle[0]);
+                const __m128i last = _mm_set1_epi8(needle[length - 1]);
+                for (; i + length - 1 + 16 <= size; i += 16)
+                {
+                    const __m128i first_hits = _mm_cmpeq_epi8(impl::byte_kernels::load(haystack + i), first);
+                    const __m128i last_hits = _mm_cmpeq_epi8(impl::byte_kernels::load(haystack + i + length - 1), last);
+                    for (auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_and_si128(first_hits, last_hits))); mask != 0; mask &= mask - 1)
+                    {
+                        const size_t candidate = i + static_cast<size_t>(std::countr_zero(mask));
+                        if (impl::byte_kernels::equal(haystack + candidate + 1, needle + 1, length - 2))
+                        {
+                            return candidate;
+                        }
+                    }
+                }
+#endif
+                return impl::byte_kernels::find_substring(haystack, size, needle, length, i);
+            }
+        };
+
+        // index of the first differing byte, or size when the ranges are equal.
+        constexpr auto mismatch(const char* left, const char* right, size_t size) noexcept -> size_t
+        {
+            if consteval
+            {
+                return impl::byte_kernels::mismatch(left, right, size);
+            }
+            else
+            {
+                size_t i = 0;
+#if defined(JPL_HAS_SSE2)
+                for (; i + 16 <= size; i += 16)
+                {
+                    const __m128i equal = _mm_cmpeq_epi8(impl::byte_kernels::load(left + i), impl::byte_kernels::load(right + i));
+                    if (const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(equal)); mask != 0xffff)
+                    {
+                        return i + static_cast<size_t>(std::countr_one(mask));
+                    }
+                }
+#endif
+                return impl::byte_kernels::mismatch(left, right, size, i);
+            }
+        };
+
+        // lexicographic comparison of bytes as unsigned char, like memcmp.
+        constexpr auto compare(const char* left, const char* right, size_t size) noexcept -> int
+        {
+            const size_t difference = byte_kernels::mismatch(left, right, size);
+            if (difference == size)
+            {
+                return 0;
+            }
+            return static_cast<unsigned char>(left[difference]) < static_cast<unsigned char>(right[difference]) ? -1 : 1;
+        };
+    };
+};
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "new.hpp"
+#include "utility.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+// cache_aligned
+// this_thread::index
+// per_thread
+// per_cpu
+namespace jpl
+{
+    // a T on cache lines of its own: aligned to, and padded out to, the
+    // destructive interference size, so neighbouring objects written by other
+    // threads never invalidate it.
+    template <typename T>
+    struct alignas(alignof(T) > hardware_destructive_interference_size ? alignof(T) : hardware_destructive_interference_size) cache_aligned
+    {
+        constexpr cache_aligned() = default;
+        template <typename... As>
+        constexpr explicit cache_aligned(in_place_t, As&&... arguments) :
+            value(jpl::forward<As>(arguments)...)
+        {};
+
+        [[nodiscard]] constexpr auto get() noexcept -> T&
+        {
+            return value;
+        };
+        [[nodiscard]] constexpr auto get() const noexcept -> const T&
+        {
+            return value;
+        };
+        [[nodiscard]] constexpr auto operator *() noexcept -> T&
+        {
+            return value;
+        };
+        [[nodiscard]] constexpr auto operator *() const noexcept -> const T&
+        {
+            return value;
+        };
+        [[nodiscard]] constexpr auto operator ->() noexcept -> T*
+        {
+            return &value;
+        };
+        [[nodiscard]] constexpr auto operator ->() const noexcept -> const T*
+        {
+            return &value;
+        };
+
+        T value{};
+    };
+
+    namespace impl
+    {
+        namespace per_thread
+        {
+            // small dense indices for live threads; an exiting thread's index
+            // goes to the next thread that asks, so slots indexed by it stay
+            // few and stay warm.
+            struct index_registry
+            {
+                std::mutex lock;
+                std::vector<size_t> released;
+                size_t next = 0;
+
+                auto acquire() -> size_t
+                {
+                    const std::lock_guard guard{ lock };
+                    if (released.empty())
+                    {
+                        return next++;
+                    }
+                    const size_t index = released.back();
+                    released.pop_back();
+                    return index;
+                };
+                auto release(size_t index) -> void
+                {
+                    const std::lock_guard guard{ lock };
+                    released.push_back(index);
+                };
+            };
+            inline auto registry() -> index_registry&
+            {
+                static index_registry instance;
+                return instance;
+            };
+
+            struct thread_index
+            {
+                size_t value = registry().acquire();
+
+                thread_index() = default;
+                thread_index(const thread_index&) = delete;
+                ~thread_index()
+                {
+                    registry().release(value);
+                };
+            };
+
+            // slots live in chunks that double in size and never move, so a
+            // slot's address is stable and finding it takes no lock.
+            inline constexpr size_t first_chunk = 8;
+            inline constexpr size_t chunk_count = 48;
+
+            struct location
+            {
+                size_t chunk;
+                size_t offset;
+            };
+            constexpr auto locate(size_t index) noexcept -> location
+            {
+                const auto chunk = static_cast<size_t>(std::bit_width(index / first_chunk + 1)) - 1;
+                return location{ chunk, index - first_chunk * ((size_t{ 1 } << chunk) - 1) };
+            };
+            constexpr auto chunk_size(size_t chunk) noexcept -> size_t
+            {
+                return first_chunk << chunk;
+            };
+        };
+    };
+
+    namespace this_thread
+    {
+        // a number unique among the threads alive right now, counting up from
+        // zero; reused once its thread exits.
+        [[nodiscard]] inline auto index() -> size_t
+        {
+            thread_local const impl::per_thread::thread_index instance;
+            return instance.value;
+        };
+    };
+
+    // one T per thread, each on its own cache lines, for state that every
+    // thread updates and that is read in aggregate: counters, histograms,
+    // free-list heads. a thread's slot outlives it and is inherited by the
+    // next thread given its index, so totals survive thread churn. reading
+    // other threads' slots while they write needs T to be atomic.
+    template <typename T>
+    struct per_thread
+    {
+        using value_type = T;
+
+        per_thread() noexcept = default;
+        per_thread(const per_thread&) = delete;
+        auto operator =(const per_thread&) -> per_thread& = delete;
+        ~per_thread()
+        {
+            for (auto& chunk : chunks)
+            {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        };
+
+        // the calling thread's slot, value-initialized on first use.
+        [[nodiscard]] auto local() -> T&
+        {
+            const auto [chunk, offset] = impl::per_thread::locate(this_thread::index());
+            cache_aligned<T>* slots = chunks[chunk].load(std::memory_order_acquire);
+            if (slots == nullptr)
+            {
+                slots = grow(chunk);
+            }
+            return slots[offset].value;
+        };
+
+        // calls f on every slot any thread has touched, and on some that no
+        // thread has.
+        template <typename F>
+        auto for_each(F f) const -> void
+        {
+            for (size_t chunk = 0; chunk < impl::per_thread::chunk_count; ++chunk)
+            {
+                if (const cache_aligned<T>* slots = chunks[chunk].load(std::memory_order_acquire))
+                {
+                    for (size_t i = 0; i < impl::per_thread::chunk_size(chunk); ++i)
+                    {
+                        f(slots[i].value);
+                    }
+                }
+            }
+        };
+        // folds every slot into init with op, by default summing them.
+        template <typename R = T, typename Op = std::plus<>>
+        [[nodiscard]] auto combine(R init = R{}, Op op = {}) const -> R
+        {
+            for_each([&](const T& slot)
+            {
+                init = op(jpl::move(init), slot);
+            });
+            return init;
+        };
+
+    private:
+        auto grow(size_t chunk) -> cache_aligned<T>*
+        {
+            auto* fresh = new cache_aligned<T>[impl::per_thread::chunk_size(chunk)];
+            cache_aligned<T>* expected = nullptr;
+            if (not chunks[chunk].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                delete[] fresh;
+                return expected;
+            }
+            return fresh;
+        };
+
+        std::array<std::atomic<cache_aligned<T>*>, impl::per_thread::chunk_count> chunks{};
+    };
+
+    namespace impl
+    {
+        namespace per_cpu
+        {
+            inline auto cpu_count() noexcept -> size_t
+            {
+#if defined(__linux__)
+                const long configured = ::sysconf(_SC_NPROCESSORS_CONF);
+                if (configured > 0)
+                {
+                    return static_cast<size_t>(configured);
+                }
+#endif
+                const unsigned int reported = std::thread::hardware_concurrency();
+                return reported == 0 ? 1 : reported;
+            };
+        };
+    };
+
+    // one T per cpu, each on its own cache lines. fewer slots than per_thread
+    // when threads outnumber cores, but a thread can be moved to another cpu
+    // between finding its slot and using it, so two threads may share a slot
+    // for a moment: T must tolerate concurrent use, typically with relaxed
+    // atomics. where the cpu cannot be asked for, slots are picked by thread.
+    template <typename T>
+    struct per_cpu
+    {
+        using value_type = T;
+
+        per_cpu() :
+            slot_count{ impl::per_cpu::cpu_count() },
+            slots{ std::make_unique<cache_aligned<T>[]>(slot_count) }
+        {};
+        per_cpu(const per_cpu&) = delete;
+        auto operator =(const per_cpu&) -> per_cpu& = delete;
+
+        // the slot of the cpu the calling thread is running on now.
+        [[nodiscard]] auto local() -> T&
+        {
+            return slots[current() % slot_count].value;
+        };
+        [[nodiscard]] auto size() const noexcept -> size_t
+        {
+            return slot_count;
+        };
+
+        template <typename F>
+        auto for_each(F f) const -> void
+        {
+            for (size_t i = 0; i < slot_count; ++i)
+            {
+                f(slots[i].value);
+            }
+        };
+        template <typename R = T, typename Op = std::plus<>>
+        [[nodiscard]] auto combine(R init = R{}, Op op = {}) const -> R
+        {
+            for_each([&](const T& slot)
+            {
+                init = op(jpl::move(init), slot);
+            });
+            return init;
+        };
+
+    private:
+        static auto current() -> size_t
+        {
+#if defined(__linux__)
+            // a vdso call or an rseq read, not a system call.
+            const int cpu = ::sched_getcpu();
+            if (cpu >= 0)
+            {
+                return static_cast<size_t>(cpu);
+            }
+#endif
+            return this_thread::index();
+        };
+
+        size_t slot_count;
+        std::unique_ptr<cache_aligned<T>[]> slots;
+    };
+};
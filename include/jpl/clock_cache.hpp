@@ -0,0 +1,301 @@
+#pragma once
+
+#include "cache_aligned.hpp"
+#include "concurrent_hash_map.hpp"
+#include "cstddef.hpp"
+#include "hazard_pointer.hpp"
+#include "intrusive.hpp"
+#include "memory.hpp"
+#include "spinlock.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <atomic>
+#include <bit>
+#include <functional>
+#include <mutex>
+
+// clock_cache_statistics
+// clock_cache
+namespace jpl
+{
+    struct clock_cache_statistics
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    };
+
+    namespace impl
+    {
+        namespace clock_cache
+        {
+            struct counters
+            {
+                std::atomic<size_t> hits{ 0 };
+                std::atomic<size_t> misses{ 0 };
+                std::atomic<size_t> evictions{ 0 };
+            };
+
+            // one per thread, shared by every cache: a lookup holds it only
+            // between finding an entry and counting a reference to it.
+            inline auto hazard() -> jpl::hazard_pointer&
+            {
+                thread_local jpl::hazard_pointer instance = make_hazard_pointer();
+                return instance;
+            };
+        };
+    };
+
+    // a concurrent cache holding at most capacity bytes, as charged by the
+    // caller per entry. hits take no lock and write nothing shared but the
+    // entry's reference bit: the index is a concurrent_hash_map, whose reads
+    // are lock-free, and an entry found there is counted under a hazard
+    // pointer, so eviction cannot free it in between. inserts and erases lock
+    // one of Shards shards, each with its own share of the capacity and its
+    // own CLOCK ring: an entry whose bit is set when the hand reaches it is
+    // given a second pass instead of being evicted. lookups return a handle
+    // that keeps the entry alive after eviction or replacement.
+    // Key must be trivially copyable, as for concurrent_hash_map.
+    template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>, size_t Shards = 16>
+    requires is_trivially_copyable_v<Key>
+    struct clock_cache
+    {
+        static_assert(std::has_single_bit(Shards), "Shards must be a power of two.");
+
+        struct entry;
+        struct retire_entry
+        {
+            // an entry can still be under a lookup's hazard pointer when its
+            // last reference goes.
+            auto operator ()(entry* released) const -> void
+            {
+                hazard_pointer_default_domain().retire(unique_ptr<entry>{ released });
+            };
+        };
+        struct entry : ref_counted<entry, retire_entry>
+        {
+            entry(const Key& key, T&& value, size_t charge) :
+                key{ key },
+                value{ jpl::move(value) },
+                charge{ charge }
+            {};
+
+            const Key key;
+            T value;
+            const size_t charge;
+            // set by hits, cleared by the clock hand.
+            mutable std::atomic<bool> referenced{ false };
+            list_hook clock;
+        };
+
+        using key_type = Key;
+        using mapped_type = T;
+        using handle = intrusive_ptr<const entry>;
+
+        explicit clock_cache(size_t capacity, const Hash& hash = Hash{}, const KeyEqual& equal = KeyEqual{}) :
+            index{ 0, hash, equal },
+            hash_function{ hash },
+            total_capacity{ capacity }
+        {};
+        clock_cache(const clock_cache&) = delete;
+        auto operator =(const clock_cache&) -> clock_cache& = delete;
+        ~clock_cache()
+        {
+            clear();
+        };
+
+        // the entry for key, or an empty handle.
+        [[nodiscard]] auto find(const Key& key) const -> handle
+        {
+            jpl::hazard_pointer& hazard = impl::clock_cache::hazard();
+            impl::clock_cache::counters& local = counters.local();
+            for (;;)
+            {
+                const optional<entry*> found = index.find(key);
+                if (not found)
+                {
+                    local.misses.fetch_add(1, std::memory_order_relaxed);
+                    return handle{};
+                }
+                entry* candidate = *found;
+                hazard.reset_protection(candidate);
+                // still indexed once the hazard is visible, so not yet retired,
+                // and retiring it now would wait for the hazard.
+                const optional<entry*> again = index.find(key);
+                if (not again or *again != candidate)
+                {
+                    continue;
+                }
+                const bool alive = intrusive_ptr_try_add_ref(static_cast<const entry*>(candidate));
+                hazard.reset_protection();
+                if (not alive)
+                {
+                    local.misses.fetch_add(1, std::memory_order_relaxed);
+                    return handle{};
+                }
+                // read first, so hot entries do not bounce their line on every hit.
+                if (not candidate->referenced.load(std::memory_order_relaxed))
+                {
+                    candidate->referenced.store(true, std::memory_order_relaxed);
+                }
+                local.hits.fetch_add(1, std::memory_order_relaxed);
+                return handle{ candidate, false };
+            }
+        };
+        [[nodiscard]] auto contains(const Key& key) const -> bool
+        {
+            return index.contains(key);
+        };
+
+        // caches value under key, replacing any entry already there, and
+        // evicts until the shard fits its share of the capacity again. an
+        // entry larger than that share is never cached, so it evicts nothing
+        // else; any entry already under key is dropped, as it would have been
+        // replaced, and the returned handle alone holds the new one.
+        auto insert(const Key& key, T value, size_t charge = 1) -> handle
+        {
+            intrusive_ptr<entry> created{ new entry{ key, jpl::move(value), charge } };
+            handle result{ created };
+            if (charge > share())
+            {
+                erase(key);
+                return result;
+            }
+            shard_type& shard = *shards[shard_of(key)];
+            const std::lock_guard guard{ shard.lock };
+            entry* replaced = nullptr;
+            const bool existed = index.update(key, [&](entry*& current)
+            {
+                replaced = jpl::exchange(current, created.get());
+            });
+            if (not existed)
+            {
+                index.insert(key, created.get());
+            }
+            // the index's reference, from here on.
+            entry* cached = created.detach();
+            if (replaced != nullptr)
+            {
+                unlink(shard, *replaced);
+            }
+            shard.ring.push_back(*cached);
+            shard.usage.store(shard.usage.load(std::memory_order_relaxed) + charge, std::memory_order_relaxed);
+            evict(shard);
+            return result;
+        };
+
+        auto erase(const Key& key) -> bool
+        {
+            shard_type& shard = *shards[shard_of(key)];
+            const std::lock_guard guard{ shard.lock };
+            const optional<entry*> found = index.find(key);
+            if (not found)
+            {
+                return false;
+            }
+            index.erase(key);
+            unlink(shard, **found);
+            return true;
+        };
+        auto clear() -> void
+        {
+            for (auto& shard : shards)
+            {
+                const std::lock_guard guard{ shard->lock };
+                while (not shard->ring.empty())
+                {
+                    entry& oldest = shard->ring.front();
+                    index.erase(oldest.key);
+                    unlink(*shard, oldest);
+                }
+            }
+        };
+
+        [[nodiscard]] auto size() const noexcept -> size_t
+        {
+            return index.size();
+        };
+        // bytes charged by the entries cached now.
+        [[nodiscard]] auto usage() const noexcept -> size_t
+        {
+            size_t total = 0;
+            for (const auto& shard : shards)
+            {
+                total += shard->usage.load(std::memory_order_relaxed);
+            }
+            return total;
+        };
+        [[nodiscard]] auto capacity() const noexcept -> size_t
+        {
+            return total_capacity;
+        };
+        [[nodiscard]] auto statistics() const -> clock_cache_statistics
+        {
+            clock_cache_statistics result;
+            counters.for_each([&](const impl::clock_cache::counters& slot)
+            {
+                result.hits += slot.hits.load(std::memory_order_relaxed);
+                result.misses += slot.misses.load(std::memory_order_relaxed);
+                result.evictions += slot.evictions.load(std::memory_order_relaxed);
+            });
+            return result;
+        };
+
+    private:
+        struct shard_type
+        {
+            spinlock lock;
+            intrusive_list<&entry::clock> ring;
+            // written under the lock, read without it.
+            std::atomic<size_t> usage{ 0 };
+        };
+
+        auto shard_of(const Key& key) const -> size_t
+        {
+            const auto hash = static_cast<size_t>(hash_function(key)) * 0x9e3779b97f4a7c15ull;
+            return Shards == 1 ? 0 : hash >> (sizeof(size_t) * 8 - std::countr_zero(Shards));
+        };
+        auto share() const noexcept -> size_t
+        {
+            return total_capacity / Shards;
+        };
+
+        // drops the cache's reference to an entry already out of the index.
+        auto unlink(shard_type& shard, entry& cached) -> void
+        {
+            shard.ring.erase(cached);
+            shard.usage.store(shard.usage.load(std::memory_order_relaxed) - cached.charge, std::memory_order_relaxed);
+            intrusive_ptr_release(static_cast<const entry*>(&cached));
+        };
+
+        // the clock hand is the front of the ring: a referenced entry has its
+        // bit cleared and goes to the back, anything else is evicted. a round
+        // of second chances is bounded by the ring, so hits racing the hand
+        // cannot keep it going.
+        auto evict(shard_type& shard) -> void
+        {
+            size_t chances = shard.ring.size();
+            while (shard.usage.load(std::memory_order_relaxed) > share() and not shard.ring.empty())
+            {
+                entry& oldest = shard.ring.front();
+                if (chances != 0 and oldest.referenced.load(std::memory_order_relaxed))
+                {
+                    --chances;
+                    oldest.referenced.store(false, std::memory_order_relaxed);
+                    shard.ring.splice(shard.ring.end(), oldest);
+                    continue;
+                }
+                index.erase(oldest.key);
+                unlink(shard, oldest);
+                counters.local().evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+
+        concurrent_hash_map<Key, entry*, Hash, KeyEqual> index;
+        [[no_unique_address]] Hash hash_function;
+        size_t total_capacity;
+        cache_aligned<shard_type> shards[Shards];
+        mutable per_cpu<impl::clock_cache::counters> counters;
+    };
+};
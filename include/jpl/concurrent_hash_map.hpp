@@ -0,0 +1,556 @@
+#pragma once
+
+#include "cache_aligned.hpp"
+#include "cstddef.hpp"
+#include "optional.hpp"
+#include "spinlock.hpp"
+#include "thread.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// concurrent_hash_map
+namespace jpl
+{
+    namespace impl
+    {
+        namespace concurrent_hash_map
+        {
+            using word = unsigned long long;
+
+            template <typename T>
+            inline constexpr size_t word_count = (sizeof(T) + sizeof(word) - 1) / sizeof(word);
+
+            // control bytes: a full slot holds 0x80 | seven bits of its hash,
+            // so most mismatches are rejected without touching the key.
+            inline constexpr unsigned char empty = 0;
+            inline constexpr unsigned char tombstone = 1;
+            inline constexpr unsigned char full = 0x80;
+
+            inline constexpr size_t minimum_capacity = 16;
+            // old slots moved to the new table by each write while a resize is
+            // in progress; a table of c slots is drained within c / 16 writes.
+            inline constexpr size_t migration_step = 16;
+
+            // spreads std::hash's identity hashes of integers over every bit,
+            // with splitmix64's finalizer: plain 64-bit multiplies and shifts,
+            // so every compiler has them.
+            constexpr auto mix(size_t hash) noexcept -> size_t
+            {
+                uint64_t mixed = hash;
+                mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ull;
+                mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebull;
+                return static_cast<size_t>(mixed ^ (mixed >> 31));
+            };
+            constexpr auto tag_of(size_t hash) noexcept -> unsigned char
+            {
+                return static_cast<unsigned char>(full | ((hash >> 32) & 0x7f));
+            };
+
+            // an open-addressing table with linear probing. every field a reader
+            // looks at is a relaxed atomic, so racing with a writer is defined
+            // behaviour; the shard's sequence tells the reader to retry.
+            template <typename Key, typename T>
+            struct table
+            {
+                static constexpr size_t key_words = word_count<Key>;
+                static constexpr size_t slot_words = key_words + word_count<T>;
+
+                size_t capacity;
+                std::unique_ptr<std::atomic<unsigned char>[]> control;
+                std::unique_ptr<std::atomic<word>[]> words;
+                // only touched by writers, under the shard lock.
+                size_t size = 0;
+                size_t used = 0;
+                size_t migrated = 0;
+
+                explicit table(size_t capacity) :
+                    capacity{ capacity },
+                    control{ std::make_unique<std::atomic<unsigned char>[]>(capacity) },
+                    words{ std::make_unique<std::atomic<word>[]>(capacity * slot_words) }
+                {};
+
+                template <typename U>
+                static auto load(const std::atomic<word>* source) noexcept -> U
+                {
+                    word buffer[word_count<U>];
+                    for (size_t i = 0; i < word_count<U>; ++i)
+                    {
+                        buffer[i] = source[i].load(std::memory_order_relaxed);
+                    }
+                    alignas(U) unsigned char bytes[sizeof(U)];
+                    std::memcpy(bytes, buffer, sizeof(U));
+                    return *std::launder(reinterpret_cast<U*>(bytes));
+                };
+                template <typename U>
+                static auto store(std::atomic<word>* destination, const U& value) noexcept -> void
+                {
+                    word buffer[word_count<U>]{};
+                    std::memcpy(buffer, static_cast<const void*>(&value), sizeof(U));
+                    for (size_t i = 0; i < word_count<U>; ++i)
+                    {
+                        destination[i].store(buffer[i], std::memory_order_relaxed);
+                    }
+                };
+
+                auto key_at(size_t slot) const noexcept -> Key
+                {
+                    return load<Key>(&words[slot * slot_words]);
+                };
+                auto value_at(size_t slot) const noexcept -> T
+                {
+                    return load<T>(&words[slot * slot_words + key_words]);
+                };
+                auto set_value(size_t slot, const T& value) noexcept -> void
+                {
+                    store(&words[slot * slot_words + key_words], value);
+                };
+
+                // whether another slot may be taken without passing three quarters full.
+                auto has_room() const noexcept -> bool
+                {
+                    return (used + 1) * 4 <= capacity * 3;
+                };
+
+                // the slot holding key, or capacity. bounded by the capacity so
+                // a reader racing a writer cannot loop forever.
+                template <typename KeyEqual>
+                auto find(const Key& key, size_t hash, const KeyEqual& equal) const -> size_t
+                {
+                    const unsigned char tag = tag_of(hash);
+                    const size_t mask = capacity - 1;
+                    for (size_t probe = 0, slot = hash & mask; probe < capacity; ++probe, slot = (slot + 1) & mask)
+                    {
+                        const unsigned char state = control[slot].load(std::memory_order_relaxed);
+                        if (state == empty)
+                        {
+                            break;
+                        }
+                        if (state == tag and equal(key_at(slot), key))
+                        {
+                            return slot;
+                        }
+                    }
+                    return capacity;
+                };
+
+                // writer only; key must not be present.
+                auto place(const Key& key, size_t hash, const T& value) noexcept -> void
+                {
+                    const size_t mask = capacity - 1;
+                    size_t slot = hash & mask;
+                    unsigned char state = control[slot].load(std::memory_order_relaxed);
+                    while (state & full)
+                    {
+                        slot = (slot + 1) & mask;
+                        state = control[slot].load(std::memory_order_relaxed);
+                    }
+                    store(&words[slot * slot_words], key);
+                    store(&words[slot * slot_words + key_words], value);
+                    control[slot].store(tag_of(hash), std::memory_order_relaxed);
+                    ++size;
+                    used += state == empty ? 1 : 0;
+                };
+                auto remove(size_t slot) noexcept -> void
+                {
+                    control[slot].store(tombstone, std::memory_order_relaxed);
+                    --size;
+                };
+            };
+        };
+    };
+
+    // a hash map split into Shards independently locked open-addressing
+    // tables. reads take no lock and write nothing shared: like seqlock, they
+    // copy optimistically and retry if a writer to the same shard overlapped,
+    // so Key and T must be trivially copyable; store handles to anything
+    // larger. writers lock one shard. growing a shard moves a few slots per
+    // write instead of rehashing at once; until the move finishes, lookups
+    // check both tables. replaced tables are kept until the map is destroyed,
+    // which is what lets readers go without hazard pointers. a table filled
+    // mostly by tombstones is cleaned in place rather than replaced, so only
+    // real growth retires tables; it at least doubles each time, so that at
+    // most doubles the footprint.
+    template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>, size_t Shards = 64>
+    requires is_trivially_copyable_v<Key> and is_trivially_copyable_v<T>
+    struct concurrent_hash_map
+    {
+        static_assert(std::has_single_bit(Shards), "Shards must be a power of two.");
+
+        using key_type = Key;
+        using mapped_type = T;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using size_type = size_t;
+
+        // sized so that expected elements fit without growing.
+        explicit concurrent_hash_map(size_t expected = 0, const Hash& hash = Hash{}, const KeyEqual& equal = KeyEqual{}) :
+            hash_function{ hash },
+            equal{ equal }
+        {
+            const size_t per_shard = std::bit_ceil(std::max(impl::concurrent_hash_map::minimum_capacity, expected / Shards * 4 / 3 + 1));
+            for (auto& shard : shards)
+            {
+                shard->current.store(new table_type{ per_shard }, std::memory_order_relaxed);
+            }
+        };
+        concurrent_hash_map(const concurrent_hash_map&) = delete;
+        auto operator =(const concurrent_hash_map&) -> concurrent_hash_map& = delete;
+        ~concurrent_hash_map()
+        {
+            for (auto& shard : shards)
+            {
+                delete shard->current.load(std::memory_order_relaxed);
+                delete shard->old.load(std::memory_order_relaxed);
+                for (table_type* retired : shard->retired)
+                {
+                    delete retired;
+                }
+            }
+        };
+
+        [[nodiscard]] auto find(const Key& key) const -> optional<T>
+        {
+            const size_t hash = hash_of(key);
+            const shard_type& shard = *shards[shard_of(hash)];
+            for (;;)
+            {
+                const size_t before = shard.sequence.load(std::memory_order_acquire);
+                if ((before & 1) != 0)
+                {
+                    this_thread::pause();
+                    continue;
+                }
+                optional<T> result;
+                const table_type* current = shard.current.load(std::memory_order_acquire);
+                size_t slot = current->find(key, hash, equal);
+                if (slot != current->capacity)
+                {
+                    result.emplace(current->value_at(slot));
+                }
+                else if (const table_type* old = shard.old.load(std::memory_order_acquire))
+                {
+                    slot = old->find(key, hash, equal);
+                    if (slot != old->capacity)
+                    {
+                        result.emplace(old->value_at(slot));
+                    }
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (shard.sequence.load(std::memory_order_relaxed) == before)
+                {
+                    return result;
+                }
+            }
+        };
+        [[nodiscard]] auto contains(const Key& key) const -> bool
+        {
+            return find(key).has_value();
+        };
+
+        // returns whether key was new; an existing value is left alone.
+        auto insert(const Key& key, const T& value) -> bool
+        {
+            return write(key, [&](table_type& current, size_t slot, size_t hash)
+            {
+                if (slot != current.capacity)
+                {
+                    return false;
+                }
+                current.place(key, hash, value);
+                return true;
+            });
+        };
+        // returns whether key was new; an existing value is overwritten.
+        auto insert_or_assign(const Key& key, const T& value) -> bool
+        {
+            return write(key, [&](table_type& current, size_t slot, size_t hash)
+            {
+                if (slot != current.capacity)
+                {
+                    current.set_value(slot, value);
+                    return false;
+                }
+                current.place(key, hash, value);
+                return true;
+            });
+        };
+        // calls modify(T&) on the value under the shard lock, if there is one,
+        // and returns whether there was.
+        template <typename F>
+        auto update(const Key& key, F modify) -> bool
+        {
+            return write(key, [&](table_type& current, size_t slot, size_t)
+            {
+                if (slot == current.capacity)
+                {
+                    return false;
+                }
+                T value = current.value_at(slot);
+                modify(value);
+                current.set_value(slot, value);
+                return true;
+            });
+        };
+        auto erase(const Key& key) -> bool
+        {
+            return write(key, [&](table_type& current, size_t slot, size_t)
+            {
+                if (slot == current.capacity)
+                {
+                    return false;
+                }
+                current.remove(slot);
+                return true;
+            });
+        };
+
+        // approximate while writers are active.
+        [[nodiscard]] auto size() const noexcept -> size_t
+        {
+            size_t total = 0;
+            for (const auto& shard : shards)
+            {
+                total += shard->count.load(std::memory_order_relaxed);
+            }
+            return total;
+        };
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return size() == 0;
+        };
+
+        // visits every element, one shard at a time under its lock; f must
+        // not call back into the map.
+        template <typename F>
+        auto for_each(F f) const -> void
+        {
+            for (const auto& shard : shards)
+            {
+                const std::lock_guard guard{ shard->lock };
+                for (const table_type* table : { shard->old.load(std::memory_order_relaxed), shard->current.load(std::memory_order_relaxed) })
+                {
+                    if (table == nullptr)
+                    {
+                        continue;
+                    }
+                    for (size_t slot = 0; slot < table->capacity; ++slot)
+                    {
+                        if (table->control[slot].load(std::memory_order_relaxed) & impl::concurrent_hash_map::full)
+                        {
+                            f(table->key_at(slot), table->value_at(slot));
+                        }
+                    }
+                }
+            }
+        };
+
+        auto clear() -> void
+        {
+            for (auto& shard : shards)
+            {
+                const std::lock_guard guard{ shard->lock };
+                begin_write(*shard);
+                for (table_type* table : { shard->old.load(std::memory_order_relaxed), shard->current.load(std::memory_order_relaxed) })
+                {
+                    if (table == nullptr)
+                    {
+                        continue;
+                    }
+                    for (size_t slot = 0; slot < table->capacity; ++slot)
+                    {
+                        table->control[slot].store(impl::concurrent_hash_map::empty, std::memory_order_relaxed);
+                    }
+                    table->size = 0;
+                    table->used = 0;
+                }
+                if (table_type* old = shard->old.exchange(nullptr, std::memory_order_relaxed))
+                {
+                    shard->retired.push_back(old);
+                }
+                shard->count.store(0, std::memory_order_relaxed);
+                end_write(*shard);
+            }
+        };
+
+    private:
+        using table_type = impl::concurrent_hash_map::table<Key, T>;
+
+        struct shard_type
+        {
+            mutable spinlock lock;
+            // odd while a write is in progress, as in seqlock.
+            std::atomic<size_t> sequence{ 0 };
+            std::atomic<table_type*> current{ nullptr };
+            // the table being drained into current, if a resize is under way.
+            std::atomic<table_type*> old{ nullptr };
+            std::atomic<size_t> count{ 0 };
+            std::vector<table_type*> retired;
+        };
+
+        auto hash_of(const Key& key) const -> size_t
+        {
+            return impl::concurrent_hash_map::mix(hash_function(key));
+        };
+        static constexpr auto shard_of(size_t hash) noexcept -> size_t
+        {
+            // the top bits, which the slot index (the low bits) never uses.
+            return Shards == 1 ? 0 : hash >> (sizeof(size_t) * 8 - std::countr_zero(Shards));
+        };
+
+        static auto begin_write(shard_type& shard) noexcept -> void
+        {
+            shard.sequence.store(shard.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            // keeps the table stores from being reordered ahead of the odd sequence.
+            std::atomic_thread_fence(std::memory_order_release);
+        };
+        static auto end_write(shard_type& shard) noexcept -> void
+        {
+            shard.sequence.store(shard.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        };
+
+        // moves up to limit slots of the old table into current, retiring the
+        // old table once it is empty.
+        auto migrate(shard_type& shard, size_t limit) -> void
+        {
+            table_type* old = shard.old.load(std::memory_order_relaxed);
+            if (old == nullptr)
+            {
+                return;
+            }
+            table_type* current = shard.current.load(std::memory_order_relaxed);
+            for (; limit != 0 and old->migrated != old->capacity; --limit, ++old->migrated)
+            {
+                const size_t slot = old->migrated;
+                if (old->control[slot].load(std::memory_order_relaxed) & impl::concurrent_hash_map::full)
+                {
+                    // grow leaves room for the whole drain, so this only guards
+                    // place against a full table; lookups still find what stays.
+                    if (not current->has_room())
+                    {
+                        break;
+                    }
+                    const Key key = old->key_at(slot);
+                    current->place(key, hash_of(key), old->value_at(slot));
+                    old->remove(slot);
+                }
+            }
+            if (old->migrated == old->capacity)
+            {
+                shard.retired.push_back(old);
+                shard.old.store(nullptr, std::memory_order_release);
+            }
+        };
+
+        // drops the tombstones of a table at most half live by placing its
+        // elements again. readers retry on the write section around it. the
+        // hashes are taken first, so a throwing hash loses nothing.
+        auto purge(shard_type& shard) -> void
+        {
+            table_type* current = shard.current.load(std::memory_order_relaxed);
+            struct element
+            {
+                Key key;
+                T value;
+                size_t hash;
+            };
+            std::vector<element> live;
+            live.reserve(current->size);
+            for (size_t slot = 0; slot < current->capacity; ++slot)
+            {
+                if (current->control[slot].load(std::memory_order_relaxed) & impl::concurrent_hash_map::full)
+                {
+                    const Key key = current->key_at(slot);
+                    live.push_back(element{ key, current->value_at(slot), hash_of(key) });
+                }
+            }
+            for (size_t slot = 0; slot < current->capacity; ++slot)
+            {
+                current->control[slot].store(impl::concurrent_hash_map::empty, std::memory_order_relaxed);
+            }
+            current->size = 0;
+            current->used = 0;
+            for (const element& moved : live)
+            {
+                current->place(moved.key, moved.hash, moved.value);
+            }
+        };
+
+        // a new table for a shard over half live, so at least twice the size.
+        // only called with no resize under way. every write drains
+        // migration_step old slots and adds at most one element, so twice the
+        // live elements plus the writes the drain takes keeps the new table
+        // under half full until the old one is gone, and it is never asked to
+        // grow mid-resize.
+        auto grow(shard_type& shard) -> void
+        {
+            table_type* current = shard.current.load(std::memory_order_relaxed);
+            const size_t draining = current->capacity / impl::concurrent_hash_map::migration_step + 1;
+            const size_t capacity = std::bit_ceil(std::max(impl::concurrent_hash_map::minimum_capacity, (current->size + draining + 1) * 2));
+            auto* fresh = new table_type{ capacity };
+            shard.old.store(current, std::memory_order_release);
+            shard.current.store(fresh, std::memory_order_release);
+        };
+
+        // locks the key's shard, makes progress on any resize, takes the key
+        // out of the old table if it is still there, and hands op the current
+        // table and the key's slot in it.
+        template <typename Op>
+        auto write(const Key& key, Op op) -> bool
+        {
+            const size_t hash = hash_of(key);
+            shard_type& shard = *shards[shard_of(hash)];
+            const std::lock_guard guard{ shard.lock };
+            begin_write(shard);
+            try
+            {
+                table_type* current = shard.current.load(std::memory_order_relaxed);
+                if (shard.old.load(std::memory_order_relaxed) == nullptr and not current->has_room())
+                {
+                    if (current->size * 2 <= current->capacity)
+                    {
+                        purge(shard);
+                    }
+                    else
+                    {
+                        grow(shard);
+                        current = shard.current.load(std::memory_order_relaxed);
+                    }
+                }
+                migrate(shard, impl::concurrent_hash_map::migration_step);
+                table_type* old = shard.old.load(std::memory_order_relaxed);
+                if (old != nullptr)
+                {
+                    const size_t stale = old->find(key, hash, equal);
+                    if (stale != old->capacity)
+                    {
+                        current->place(key, hash, old->value_at(stale));
+                        old->remove(stale);
+                    }
+                }
+                const bool result = op(*current, current->find(key, hash, equal), hash);
+                shard.count.store(current->size + (old != nullptr ? old->size : 0), std::memory_order_relaxed);
+                end_write(shard);
+                return result;
+            }
+            catch (...)
+            {
+                end_write(shard);
+                throw;
+            }
+        };
+
+        [[no_unique_address]] Hash hash_function;
+        [[no_unique_address]] KeyEqual equal;
+        cache_aligned<shard_type> shards[Shards];
+    };
+};
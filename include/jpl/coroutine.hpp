@@ -0,0 +1,614 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+
+// frame_allocator
+// scoped_frame_allocator
+namespace jpl
+{
+    // where coroutine frames come from. a coroutine uses the allocator passed as
+    // (std::allocator_arg, allocator, ...) leading arguments if it has them, else
+    // the innermost scoped_frame_allocator on the creating thread, else the heap.
+    struct frame_allocator
+    {
+        virtual ~frame_allocator() = default;
+        virtual auto allocate(size_t size) -> void* = 0;
+        virtual auto deallocate(void* frame, size_t size) noexcept -> void = 0;
+    };
+
+    namespace impl
+    {
+        namespace coroutine
+        {
+            inline thread_local frame_allocator* current_frame_allocator = nullptr;
+
+            // the owning allocator is stashed after the frame so deallocation does
+            // not depend on which hook is active when the coroutine is destroyed.
+            constexpr auto trailer_offset(size_t size) noexcept -> size_t
+            {
+                return (size + alignof(frame_allocator*) - 1) & ~(alignof(frame_allocator*) - 1);
+            };
+            inline auto allocate_frame(size_t size, frame_allocator* allocator) -> void*
+            {
+                const size_t offset = trailer_offset(size);
+                const size_t total = offset + sizeof(frame_allocator*);
+                void* frame = allocator != nullptr ? allocator->allocate(total) : ::operator new(total);
+                ::new (static_cast<void*>(static_cast<char*>(frame) + offset)) frame_allocator*{ allocator };
+                return frame;
+            };
+            inline auto deallocate_frame(void* frame, size_t size) noexcept -> void
+            {
+                const size_t offset = trailer_offset(size);
+                const size_t total = offset + sizeof(frame_allocator*);
+                frame_allocator* allocator = *static_cast<frame_allocator**>(static_cast<void*>(static_cast<char*>(frame) + offset));
+                if (allocator != nullptr)
+                {
+                    allocator->deallocate(frame, total);
+                }
+                else
+                {
+                    ::operator delete(frame, total);
+                }
+            };
+
+            struct frame_promise
+            {
+                static auto operator new(size_t size) -> void*
+                {
+                    return allocate_frame(size, current_frame_allocator);
+                };
+                template <typename... As>
+                static auto operator new(size_t size, std::allocator_arg_t, frame_allocator& allocator, As&...) -> void*
+                {
+                    return allocate_frame(size, &allocator);
+                };
+                // member coroutines see the object argument first.
+                template <typename C, typename... As>
+                static auto operator new(size_t size, C&, std::allocator_arg_t, frame_allocator& allocator, As&...) -> void*
+                {
+                    return allocate_frame(size, &allocator);
+                };
+                static auto operator delete(void* frame, size_t size) noexcept -> void
+                {
+                    deallocate_frame(frame, size);
+                };
+            };
+        };
+    };
+
+    struct scoped_frame_allocator
+    {
+        explicit scoped_frame_allocator(frame_allocator& allocator) noexcept :
+            previous{ jpl::exchange(impl::coroutine::current_frame_allocator, &allocator) }
+        {};
+        scoped_frame_allocator(const scoped_frame_allocator&) = delete;
+        auto operator =(const scoped_frame_allocator&) -> scoped_frame_allocator& = delete;
+        ~scoped_frame_allocator()
+        {
+            impl::coroutine::current_frame_allocator = previous;
+        };
+
+    private:
+        frame_allocator* previous;
+    };
+};
+
+// task
+namespace jpl
+{
+    template <typename T = void>
+    struct task;
+
+    namespace impl
+    {
+        namespace coroutine
+        {
+            // symmetric transfer: finishing a task resumes whoever awaited it as a
+            // tail call instead of growing the stack. that takes a compiler that
+            // emits the tail call; sanitizer builds often do not, and there a
+            // long chain of tasks completing synchronously can overflow.
+            struct final_awaiter
+            {
+                auto await_ready() const noexcept -> bool
+                {
+                    return false;
+                };
+                template <typename P>
+                auto await_suspend(std::coroutine_handle<P> self) const noexcept -> std::coroutine_handle<>
+                {
+                    if (auto continuation = self.promise().continuation)
+                    {
+                        return continuation;
+                    }
+                    return std::noop_coroutine();
+                };
+                auto await_resume() const noexcept -> void
+                {};
+            };
+
+            struct task_promise_base : frame_promise
+            {
+                std::coroutine_handle<> continuation;
+                std::exception_ptr exception;
+
+                auto initial_suspend() const noexcept -> std::suspend_always
+                {
+                    return {};
+                };
+                auto final_suspend() const noexcept -> final_awaiter
+                {
+                    return {};
+                };
+                auto unhandled_exception() noexcept -> void
+                {
+                    exception = std::current_exception();
+                };
+                auto rethrow_if_exception() const -> void
+                {
+                    if (exception)
+                    {
+                        std::rethrow_exception(exception);
+                    }
+                };
+            };
+
+            template <typename T>
+            struct task_promise : task_promise_base
+            {
+                union
+                {
+                    T value;
+                };
+                bool has_value = false;
+
+                task_promise() noexcept
+                {};
+                ~task_promise()
+                {
+                    if (has_value)
+                    {
+                        value.~T();
+                    }
+                };
+
+                auto get_return_object() noexcept -> task<T>;
+                template <typename U = T>
+                requires is_constructible_v<T, U&&>
+                auto return_value(U&& result) -> void
+                {
+                    jpl::construct_at(&value, jpl::forward<U>(result));
+                    has_value = true;
+                };
+                auto result() -> T
+                {
+                    rethrow_if_exception();
+                    return jpl::move(value);
+                };
+            };
+            template <typename T>
+            struct task_promise<T&> : task_promise_base
+            {
+                T* value = nullptr;
+
+                auto get_return_object() noexcept -> task<T&>;
+                auto return_value(T& result) noexcept -> void
+                {
+                    value = &result;
+                };
+                auto result() -> T&
+                {
+                    rethrow_if_exception();
+                    return *value;
+                };
+            };
+            template <>
+            struct task_promise<void> : task_promise_base
+            {
+                auto get_return_object() noexcept -> task<void>;
+                auto return_void() const noexcept -> void
+                {};
+                auto result() -> void
+                {
+                    rethrow_if_exception();
+                };
+            };
+        };
+    };
+
+    // lazy: nothing runs until the task is awaited (or handed to sync_wait), and
+    // the awaiting coroutine is resumed directly when it completes.
+    template <typename T>
+    struct [[nodiscard]] task
+    {
+        using promise_type = impl::coroutine::task_promise<T>;
+        using handle_type = std::coroutine_handle<promise_type>;
+        using value_type = T;
+
+        task() noexcept = default;
+        explicit task(handle_type handle) noexcept :
+            handle{ handle }
+        {};
+        task(task&& other) noexcept :
+            handle{ jpl::exchange(other.handle, nullptr) }
+        {};
+        auto operator =(task&& other) noexcept -> task&
+        {
+            if (this != &other)
+            {
+                if (handle)
+                {
+                    handle.destroy();
+                }
+                handle = jpl::exchange(other.handle, nullptr);
+            }
+            return *this;
+        };
+        task(const task&) = delete;
+        ~task()
+        {
+            if (handle)
+            {
+                handle.destroy();
+            }
+        };
+
+        [[nodiscard]] auto done() const noexcept -> bool
+        {
+            return not handle or handle.done();
+        };
+
+        auto operator co_await() noexcept
+        {
+            struct awaiter
+            {
+                handle_type handle;
+
+                auto await_ready() const noexcept -> bool
+                {
+                    return not handle or handle.done();
+                };
+                auto await_suspend(std::coroutine_handle<> awaiting) const noexcept -> std::coroutine_handle<>
+                {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                };
+                auto await_resume() const -> T
+                {
+                    return handle.promise().result();
+                };
+            };
+            return awaiter{ handle };
+        };
+
+    private:
+        template <typename U>
+        friend auto sync_wait(task<U> work) -> U;
+
+        handle_type handle;
+    };
+
+    namespace impl
+    {
+        namespace coroutine
+        {
+            template <typename T>
+            auto task_promise<T>::get_return_object() noexcept -> task<T>
+            {
+                return task<T>{ std::coroutine_handle<task_promise>::from_promise(*this) };
+            };
+            template <typename T>
+            auto task_promise<T&>::get_return_object() noexcept -> task<T&>
+            {
+                return task<T&>{ std::coroutine_handle<task_promise>::from_promise(*this) };
+            };
+            inline auto task_promise<void>::get_return_object() noexcept -> task<void>
+            {
+                return task<void>{ std::coroutine_handle<task_promise>::from_promise(*this) };
+            };
+        };
+    };
+};
+
+// sync_wait
+// scheduler
+// schedule_on
+namespace jpl
+{
+    namespace impl
+    {
+        namespace coroutine
+        {
+            struct sync_state
+            {
+                std::mutex mutex;
+                std::condition_variable ready;
+                bool done = false;
+            };
+
+            struct blocking_promise;
+            struct blocking
+            {
+                using promise_type = blocking_promise;
+                std::coroutine_handle<blocking_promise> handle;
+            };
+            struct blocking_promise : frame_promise
+            {
+                sync_state* state = nullptr;
+
+                auto get_return_object() noexcept -> blocking
+                {
+                    return blocking{ std::coroutine_handle<blocking_promise>::from_promise(*this) };
+                };
+                auto initial_suspend() const noexcept -> std::suspend_always
+                {
+                    return {};
+                };
+                auto final_suspend() const noexcept
+                {
+                    struct awaiter
+                    {
+                        auto await_ready() const noexcept -> bool
+                        {
+                            return false;
+                        };
+                        // notifying under the lock keeps the waiter from returning, and
+                        // destroying the state, before we are done touching it.
+                        auto await_suspend(std::coroutine_handle<blocking_promise> self) const noexcept -> void
+                        {
+                            sync_state& state = *self.promise().state;
+                            std::lock_guard lock{ state.mutex };
+                            state.done = true;
+                            state.ready.notify_one();
+                        };
+                        auto await_resume() const noexcept -> void
+                        {};
+                    };
+                    return awaiter{};
+                };
+                auto return_void() const noexcept -> void
+                {};
+                auto unhandled_exception() const noexcept -> void
+                {
+                    std::terminate();
+                };
+            };
+
+            // awaits completion without consuming the result, which sync_wait then
+            // takes straight out of the task's promise.
+            inline auto drive(task_promise_base& work, std::coroutine_handle<> handle) -> blocking
+            {
+                struct start
+                {
+                    task_promise_base& work;
+                    std::coroutine_handle<> handle;
+
+                    auto await_ready() const noexcept -> bool
+                    {
+                        return false;
+                    };
+                    auto await_suspend(std::coroutine_handle<> self) const noexcept -> std::coroutine_handle<>
+                    {
+                        work.continuation = self;
+                        return handle;
+                    };
+                    auto await_resume() const noexcept -> void
+                    {};
+                };
+                co_await start{ work, handle };
+            };
+        };
+    };
+
+    // runs the task to completion, blocking the calling thread while it is
+    // suspended on other threads.
+    template <typename T>
+    auto sync_wait(task<T> work) -> T
+    {
+        if (not work.handle.done())
+        {
+            impl::coroutine::sync_state state;
+            auto driver = impl::coroutine::drive(work.handle.promise(), work.handle);
+            driver.handle.promise().state = &state;
+            driver.handle.resume();
+            {
+                std::unique_lock lock{ state.mutex };
+                state.ready.wait(lock, [&] { return state.done; });
+            }
+            driver.handle.destroy();
+        }
+        return work.handle.promise().result();
+    };
+
+    // anything with post(std::coroutine_handle<>) can resume coroutines.
+    template <typename S>
+    concept scheduler = requires (S& target, std::coroutine_handle<> handle)
+    {
+        target.post(handle);
+    };
+
+    namespace impl
+    {
+        namespace coroutine
+        {
+            template <typename S>
+            struct schedule_awaiter
+            {
+                S& target;
+
+                auto await_ready() const noexcept -> bool
+                {
+                    return false;
+                };
+                auto await_suspend(std::coroutine_handle<> self) const -> void
+                {
+                    target.post(self);
+                };
+                auto await_resume() const noexcept -> void
+                {};
+            };
+        };
+    };
+
+    // co_await schedule_on(pool) continues the coroutine on one of pool's threads.
+    template <scheduler S>
+    auto schedule_on(S& target) noexcept -> impl::coroutine::schedule_awaiter<S>
+    {
+        return impl::coroutine::schedule_awaiter<S>{ target };
+    };
+};
+
+// generator
+namespace jpl
+{
+    template <typename T>
+    struct generator;
+
+    namespace impl
+    {
+        namespace coroutine
+        {
+            template <typename T>
+            struct generator_promise : frame_promise
+            {
+                using reference = conditional_t<is_reference_v<T>, T, T&>;
+
+                add_pointer_t<reference> current = nullptr;
+                std::exception_ptr exception;
+
+                auto get_return_object() noexcept -> generator<T>
+                {
+                    return generator<T>{ std::coroutine_handle<generator_promise>::from_promise(*this) };
+                };
+                auto initial_suspend() const noexcept -> std::suspend_always
+                {
+                    return {};
+                };
+                auto final_suspend() const noexcept -> std::suspend_always
+                {
+                    return {};
+                };
+
+                // a yielded temporary lives until the end of the co_yield
+                // full-expression, which spans the suspension, so keeping its
+                // address is safe.
+                auto yield_value(remove_reference_t<reference>& value) noexcept -> std::suspend_always
+                {
+                    current = &value;
+                    return {};
+                };
+                auto yield_value(remove_reference_t<reference>&& value) noexcept -> std::suspend_always
+                {
+                    current = &value;
+                    return {};
+                };
+                auto return_void() const noexcept -> void
+                {};
+                auto unhandled_exception() noexcept -> void
+                {
+                    exception = std::current_exception();
+                };
+
+                template <typename U>
+                auto await_transform(U&&) -> std::suspend_never = delete;
+            };
+        };
+    };
+
+    // a synchronous, single-pass range produced with co_yield.
+    template <typename T>
+    struct [[nodiscard]] generator
+    {
+        using promise_type = impl::coroutine::generator_promise<T>;
+        using handle_type = std::coroutine_handle<promise_type>;
+        using value_type = remove_cvref_t<T>;
+        using reference = typename promise_type::reference;
+
+        struct iterator
+        {
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = generator::value_type;
+            using difference_type = ptrdiff_t;
+
+            handle_type handle;
+
+            auto operator *() const noexcept -> reference
+            {
+                return static_cast<reference>(*handle.promise().current);
+            };
+            auto operator ++() -> iterator&
+            {
+                advance(handle);
+                return *this;
+            };
+            auto operator ++(int) -> void
+            {
+                ++*this;
+            };
+            friend auto operator ==(const iterator& it, std::default_sentinel_t) noexcept -> bool
+            {
+                return it.handle.done();
+            };
+        };
+
+        generator() noexcept = default;
+        explicit generator(handle_type handle) noexcept :
+            handle{ handle }
+        {};
+        generator(generator&& other) noexcept :
+            handle{ jpl::exchange(other.handle, nullptr) }
+        {};
+        auto operator =(generator&& other) noexcept -> generator&
+        {
+            if (this != &other)
+            {
+                if (handle)
+                {
+                    handle.destroy();
+                }
+                handle = jpl::exchange(other.handle, nullptr);
+            }
+            return *this;
+        };
+        generator(const generator&) = delete;
+        ~generator()
+        {
+            if (handle)
+            {
+                handle.destroy();
+            }
+        };
+
+        auto begin() -> iterator
+        {
+            advance(handle);
+            return iterator{ handle };
+        };
+        auto end() const noexcept -> std::default_sentinel_t
+        {
+            return std::default_sentinel;
+        };
+
+    private:
+        static auto advance(handle_type handle) -> void
+        {
+            handle.resume();
+            if (handle.promise().exception)
+            {
+                std::rethrow_exception(jpl::exchange(handle.promise().exception, nullptr));
+            }
+        };
+
+        handle_type handle;
+    };
+};
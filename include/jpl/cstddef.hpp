@@ -22,7 +22,7 @@ namespace jpl
     template <typename I>
     constexpr auto operator <<(byte b, I amount) noexcept -> byte
     {
-        return byte{ static_cast<unsigned int>(b) << amount };
+        return byte{ static_cast<unsigned char>(static_cast<unsigned int>(b) << amount) };
     };
     template <typename I>
     constexpr auto operator <<=(byte& b, I amount) noexcept -> byte&
@@ -32,7 +32,7 @@ namespace jpl
     template <typename I>
     constexpr auto operator >>(byte b, I amount) noexcept -> byte
     {
-        return byte{ static_cast<unsigned int>(b) >> amount };
+        return byte{ static_cast<unsigned char>(static_cast<unsigned int>(b) >> amount) };
     };
     template <typename I>
     constexpr auto operator >>=(byte& b, I amount) noexcept -> byte&
@@ -41,7 +41,7 @@ namespace jpl
     };
     constexpr auto operator |(byte l, byte r) noexcept -> byte
     {
-        return byte{ static_cast<unsigned int>(l) | static_cast<unsigned int>(r) };
+        return byte{ static_cast<unsigned char>(static_cast<unsigned int>(l) | static_cast<unsigned int>(r)) };
     };
     constexpr auto operator |=(byte& l, byte r) noexcept -> byte&
     {
@@ -49,7 +49,7 @@ namespace jpl
     };
     constexpr auto operator &(byte l, byte r) noexcept -> byte
     {
-        return byte{ static_cast<unsigned int>(l) & static_cast<unsigned int>(r) };
+        return byte{ static_cast<unsigned char>(static_cast<unsigned int>(l) & static_cast<unsigned int>(r)) };
     };
     constexpr auto operator &=(byte& l, byte r) noexcept -> byte&
     {
@@ -57,7 +57,7 @@ namespace jpl
     };
     constexpr auto operator ^(byte l, byte r) noexcept -> byte
     {
-        return byte{ static_cast<unsigned int>(l) ^ static_cast<unsigned int>(r) };
+        return byte{ static_cast<unsigned char>(static_cast<unsigned int>(l) ^ static_cast<unsigned int>(r)) };
     };
     constexpr auto operator ^=(byte& l, byte r) noexcept -> byte&
     {
@@ -65,6 +65,6 @@ namespace jpl
     };
     constexpr auto operator ~(byte b) noexcept -> byte
     {
-        return byte{ ~static_cast<unsigned int>(b) };
+        return byte{ static_cast<unsigned char>(~static_cast<unsigned int>(b)) };
     };
 };
\ No newline at end of file
@@ -0,0 +1,792 @@
+#pragma once
+
+#include "optional.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <exception>
+#include <functional>
+#include <memory>
+
+// unexpected
+// unexpect_t
+// unexpect
+// bad_expected_access
+// expected
+namespace jpl
+{
+    // an error on its way into an expected.
+    template <typename E>
+    struct unexpected
+    {
+        static_assert(is_object_v<E> and not is_array_v<E> and not is_const_v<E>, "jpl::unexpected needs a non-const object type.");
+
+        template <typename G = E>
+        requires is_constructible_v<E, G> and (not is_same_v<remove_cvref_t<G>, unexpected>) and (not is_same_v<remove_cvref_t<G>, in_place_t>)
+        constexpr explicit unexpected(G&& error) :
+            failure(jpl::forward<G>(error))
+        {};
+        template <typename... As>
+        requires is_constructible_v<E, As...>
+        constexpr explicit unexpected(in_place_t, As&&... arguments) :
+            failure(jpl::forward<As>(arguments)...)
+        {};
+
+        [[nodiscard]] constexpr auto error() & noexcept -> E&
+        {
+            return failure;
+        };
+        [[nodiscard]] constexpr auto error() const& noexcept -> const E&
+        {
+            return failure;
+        };
+        [[nodiscard]] constexpr auto error() && noexcept -> E&&
+        {
+            return jpl::move(failure);
+        };
+
+        template <typename G>
+        friend constexpr auto operator ==(const unexpected& left, const unexpected<G>& right) -> bool
+        {
+            return left.error() == right.error();
+        };
+
+    private:
+        E failure;
+    };
+
+    template <typename E>
+    unexpected(E) -> unexpected<E>;
+
+    struct unexpect_t
+    {
+        explicit unexpect_t() = default;
+    };
+    inline constexpr unexpect_t unexpect{};
+
+    template <typename E>
+    struct bad_expected_access : std::exception
+    {
+        explicit bad_expected_access(E error) :
+            failure(jpl::move(error))
+        {};
+
+        auto what() const noexcept -> const char* override
+        {
+            return "jpl::expected::value";
+        };
+        [[nodiscard]] auto error() const& noexcept -> const E&
+        {
+            return failure;
+        };
+        [[nodiscard]] auto error() && noexcept -> E&&
+        {
+            return jpl::move(failure);
+        };
+
+    private:
+        E failure;
+    };
+
+    template <typename T, typename E>
+    struct expected;
+
+    namespace impl
+    {
+        namespace expected
+        {
+            template <typename T>
+            inline constexpr bool is_expected = false;
+            template <typename T, typename E>
+            inline constexpr bool is_expected<jpl::expected<T, E>> = true;
+
+            // an error type with no state needs no room: the niche of an
+            // optional<T> says which side is held.
+            template <typename T, typename E>
+            concept packed = has_niche<T> and is_empty_v<E> and is_default_constructible_v<E>;
+
+            // a union of both sides and a flag.
+            template <typename T, typename E>
+            struct storage
+            {
+                union
+                {
+                    T value;
+                    E failure;
+                };
+                bool success;
+
+                template <typename... As>
+                constexpr explicit storage(in_place_t, As&&... arguments) :
+                    value(jpl::forward<As>(arguments)...),
+                    success{ true }
+                {};
+                template <typename... As>
+                constexpr explicit storage(unexpect_t, As&&... arguments) :
+                    failure(jpl::forward<As>(arguments)...),
+                    success{ false }
+                {};
+                constexpr ~storage() requires is_trivially_destructible_v<T> and is_trivially_destructible_v<E> = default;
+                // the owning expected destroys whichever side is held.
+                constexpr ~storage()
+                {};
+
+                [[nodiscard]] constexpr auto has_value() const noexcept -> bool
+                {
+                    return success;
+                };
+                [[nodiscard]] constexpr auto get() & noexcept -> T&
+                {
+                    return value;
+                };
+                [[nodiscard]] constexpr auto get() const& noexcept -> const T&
+                {
+                    return value;
+                };
+                [[nodiscard]] constexpr auto error() & noexcept -> E&
+                {
+                    return failure;
+                };
+                [[nodiscard]] constexpr auto error() const& noexcept -> const E&
+                {
+                    return failure;
+                };
+
+                constexpr auto destroy_held() noexcept -> void
+                {
+                    if (success)
+                    {
+                        std::destroy_at(&value);
+                    }
+                    else
+                    {
+                        std::destroy_at(&failure);
+                    }
+                };
+                // switches sides; if the new side throws, the old one is put
+                // back from a copy kept until then.
+                template <typename... As>
+                constexpr auto become_value(As&&... arguments) -> void
+                {
+                    E saved(jpl::move(failure));
+                    std::destroy_at(&failure);
+                    try
+                    {
+                        std::construct_at(&value, jpl::forward<As>(arguments)...);
+                    }
+                    catch (...)
+                    {
+                        std::construct_at(&failure, jpl::move(saved));
+                        throw;
+                    }
+                    success = true;
+                };
+                template <typename... As>
+                constexpr auto become_error(As&&... arguments) -> void
+                {
+                    T saved(jpl::move(value));
+                    std::destroy_at(&value);
+                    try
+                    {
+                        std::construct_at(&failure, jpl::forward<As>(arguments)...);
+                    }
+                    catch (...)
+                    {
+                        std::construct_at(&value, jpl::move(saved));
+                        throw;
+                    }
+                    success = false;
+                };
+            };
+
+            template <typename T, typename E>
+            requires packed<T, E>
+            struct storage<T, E>
+            {
+                jpl::optional<T> value;
+                [[no_unique_address]] E failure;
+
+                template <typename... As>
+                constexpr explicit storage(in_place_t, As&&... arguments) :
+                    value{ in_place, jpl::forward<As>(arguments)... }
+                {};
+                template <typename... As>
+                constexpr explicit storage(unexpect_t, As&&... arguments) :
+                    failure(jpl::forward<As>(arguments)...)
+                {};
+
+                [[nodiscard]] constexpr auto has_value() const noexcept -> bool
+                {
+                    return value.has_value();
+                };
+                [[nodiscard]] constexpr auto get() & noexcept -> T&
+                {
+                    return *value;
+                };
+                [[nodiscard]] constexpr auto get() const& noexcept -> const T&
+                {
+                    return *value;
+                };
+                [[nodiscard]] constexpr auto error() & noexcept -> E&
+                {
+                    return failure;
+                };
+                [[nodiscard]] constexpr auto error() const& noexcept -> const E&
+                {
+                    return failure;
+                };
+
+                template <typename... As>
+                constexpr auto become_value(As&&... arguments) -> void
+                {
+                    value.emplace(jpl::forward<As>(arguments)...);
+                };
+                template <typename... As>
+                constexpr auto become_error(As&&... arguments) -> void
+                {
+                    value.reset();
+                    failure = E(jpl::forward<As>(arguments)...);
+                };
+            };
+
+            template <typename T, typename E>
+            concept trivial_copy = packed<T, E> or (is_trivially_copy_constructible_v<T> and is_trivially_copy_constructible_v<E>);
+            template <typename T, typename E>
+            concept trivial_move = packed<T, E> or (is_trivially_move_constructible_v<T> and is_trivially_move_constructible_v<E>);
+            template <typename T, typename E>
+            concept trivial_copy_assign = packed<T, E> or (trivial_copy<T, E> and is_trivially_copy_assignable_v<T> and is_trivially_copy_assignable_v<E> and is_trivially_destructible_v<T> and is_trivially_destructible_v<E>);
+            template <typename T, typename E>
+            concept trivial_move_assign = packed<T, E> or (trivial_move<T, E> and is_trivially_move_assignable_v<T> and is_trivially_move_assignable_v<E> and is_trivially_destructible_v<T> and is_trivially_destructible_v<E>);
+            template <typename T, typename E>
+            concept trivial_destroy = packed<T, E> or (is_trivially_destructible_v<T> and is_trivially_destructible_v<E>);
+        };
+    };
+
+    // a T, or the E that explains why there is none. like optional, the
+    // special members are trivial when both sides' are. when E is an empty
+    // tag and T has a niche, the niche marks the error and
+    // sizeof(expected<T, E>) == sizeof(T); a T equal to the niche value then
+    // reads as the error.
+    template <typename T, typename E>
+    struct expected
+    {
+        static_assert(is_object_v<T> and not is_array_v<T>, "jpl::expected needs an object type or void.");
+        static_assert(not is_same_v<remove_cv_t<T>, in_place_t> and not is_same_v<remove_cv_t<T>, unexpect_t>, "jpl::expected cannot hold its own tags.");
+
+        using value_type = T;
+        using error_type = E;
+        using unexpected_type = unexpected<E>;
+        template <typename U>
+        using rebind = expected<U, error_type>;
+
+        constexpr expected() requires is_default_constructible_v<T> :
+            data{ in_place }
+        {};
+        template <typename U = T>
+        requires is_constructible_v<T, U> and (not is_same_v<remove_cvref_t<U>, in_place_t>) and (not is_same_v<remove_cvref_t<U>, expected>) and (not is_same_v<remove_cvref_t<U>, unexpect_t>) and (not is_same_v<remove_cvref_t<U>, unexpected<E>>)
+        constexpr explicit(not is_convertible_v<U, T>) expected(U&& value) :
+            data{ in_place, jpl::forward<U>(value) }
+        {};
+        template <typename G>
+        requires is_constructible_v<E, const G&>
+        constexpr explicit(not is_convertible_v<const G&, E>) expected(const unexpected<G>& error) :
+            data{ unexpect, error.error() }
+        {};
+        template <typename G>
+        requires is_constructible_v<E, G>
+        constexpr explicit(not is_convertible_v<G, E>) expected(unexpected<G>&& error) :
+            data{ unexpect, jpl::move(error).error() }
+        {};
+        template <typename... As>
+        requires is_constructible_v<T, As...>
+        constexpr explicit expected(in_place_t, As&&... arguments) :
+            data{ in_place, jpl::forward<As>(arguments)... }
+        {};
+        template <typename... As>
+        requires is_constructible_v<E, As...>
+        constexpr explicit expected(unexpect_t, As&&... arguments) :
+            data{ unexpect, jpl::forward<As>(arguments)... }
+        {};
+
+        constexpr expected(const expected&) requires impl::expected::trivial_copy<T, E> = default;
+        constexpr expected(const expected& other)
+        requires (not impl::expected::trivial_copy<T, E>) and is_copy_constructible_v<T> and is_copy_constructible_v<E> :
+            data{ copy_of(other) }
+        {};
+        constexpr expected(expected&&) requires impl::expected::trivial_move<T, E> = default;
+        constexpr expected(expected&& other) noexcept(is_nothrow_move_constructible_v<T> and is_nothrow_move_constructible_v<E>)
+        requires (not impl::expected::trivial_move<T, E>) and is_move_constructible_v<T> and is_move_constructible_v<E> :
+            data{ copy_of(jpl::move(other)) }
+        {};
+
+        constexpr auto operator =(const expected&) -> expected& requires impl::expected::trivial_copy_assign<T, E> = default;
+        constexpr auto operator =(const expected& other) -> expected&
+        requires (not impl::expected::trivial_copy_assign<T, E>) and is_copy_constructible_v<T> and is_copy_constructible_v<E> and is_copy_assignable_v<T> and is_copy_assignable_v<E>
+        {
+            assign(other);
+            return *this;
+        };
+        constexpr auto operator =(expected&&) -> expected& requires impl::expected::trivial_move_assign<T, E> = default;
+        constexpr auto operator =(expected&& other) -> expected&
+        requires (not impl::expected::trivial_move_assign<T, E>) and is_move_constructible_v<T> and is_move_constructible_v<E> and is_move_assignable_v<T> and is_move_assignable_v<E>
+        {
+            assign(jpl::move(other));
+            return *this;
+        };
+        template <typename U = T>
+        requires is_constructible_v<T, U> and is_assignable_v<T&, U> and (not is_same_v<remove_cvref_t<U>, expected>) and (not impl::expected::is_expected<remove_cvref_t<U>>) and (not is_same_v<remove_cvref_t<U>, unexpected<E>>)
+        constexpr auto operator =(U&& value) -> expected&
+        {
+            if (has_value())
+            {
+                data.get() = jpl::forward<U>(value);
+            }
+            else
+            {
+                data.become_value(jpl::forward<U>(value));
+            }
+            return *this;
+        };
+        template <typename G>
+        constexpr auto operator =(const unexpected<G>& error) -> expected&
+        {
+            set_error(error.error());
+            return *this;
+        };
+        template <typename G>
+        constexpr auto operator =(unexpected<G>&& error) -> expected&
+        {
+            set_error(jpl::move(error).error());
+            return *this;
+        };
+
+        constexpr ~expected() requires impl::expected::trivial_destroy<T, E> = default;
+        constexpr ~expected()
+        {
+            data.destroy_held();
+        };
+
+        template <typename... As>
+        requires is_nothrow_constructible_v<T, As...>
+        constexpr auto emplace(As&&... arguments) noexcept -> T&
+        {
+            if (has_value())
+            {
+                std::destroy_at(&data.get());
+                std::construct_at(&data.get(), jpl::forward<As>(arguments)...);
+            }
+            else
+            {
+                data.become_value(jpl::forward<As>(arguments)...);
+            }
+            return data.get();
+        };
+
+        [[nodiscard]] constexpr auto has_value() const noexcept -> bool
+        {
+            return data.has_value();
+        };
+        constexpr explicit operator bool() const noexcept
+        {
+            return has_value();
+        };
+
+        // unchecked; the expected must hold a value.
+        [[nodiscard]] constexpr auto operator *() & noexcept -> T&
+        {
+            return data.get();
+        };
+        [[nodiscard]] constexpr auto operator *() const& noexcept -> const T&
+        {
+            return data.get();
+        };
+        [[nodiscard]] constexpr auto operator *() && noexcept -> T&&
+        {
+            return jpl::move(data.get());
+        };
+        [[nodiscard]] constexpr auto operator *() const&& noexcept -> const T&&
+        {
+            return jpl::move(data.get());
+        };
+        [[nodiscard]] constexpr auto operator ->() noexcept -> T*
+        {
+            return &data.get();
+        };
+        [[nodiscard]] constexpr auto operator ->() const noexcept -> const T*
+        {
+            return &data.get();
+        };
+
+        // checked; throws bad_expected_access<E> holding a copy of the error.
+        [[nodiscard]] constexpr auto value() & -> T&
+        {
+            check();
+            return data.get();
+        };
+        [[nodiscard]] constexpr auto value() const& -> const T&
+        {
+            check();
+            return data.get();
+        };
+        [[nodiscard]] constexpr auto value() && -> T&&
+        {
+            check();
+            return jpl::move(data.get());
+        };
+        [[nodiscard]] constexpr auto value() const&& -> const T&&
+        {
+            check();
+            return jpl::move(data.get());
+        };
+
+        // unchecked; the expected must hold an error.
+        [[nodiscard]] constexpr auto error() & noexcept -> E&
+        {
+            return data.error();
+        };
+        [[nodiscard]] constexpr auto error() const& noexcept -> const E&
+        {
+            return data.error();
+        };
+        [[nodiscard]] constexpr auto error() && noexcept -> E&&
+        {
+            return jpl::move(data.error());
+        };
+
+        template <typename U>
+        [[nodiscard]] constexpr auto value_or(U&& fallback) const& -> T
+        {
+            return has_value() ? data.get() : static_cast<T>(jpl::forward<U>(fallback));
+        };
+        template <typename U>
+        [[nodiscard]] constexpr auto value_or(U&& fallback) && -> T
+        {
+            return has_value() ? jpl::move(data.get()) : static_cast<T>(jpl::forward<U>(fallback));
+        };
+        template <typename G = E>
+        [[nodiscard]] constexpr auto error_or(G&& fallback) const& -> E
+        {
+            return has_value() ? static_cast<E>(jpl::forward<G>(fallback)) : data.error();
+        };
+
+        // f(value), which returns an expected with the same error type, or
+        // this error.
+        template <typename F>
+        constexpr auto and_then(F&& f) &
+        {
+            return and_then_of(*this, jpl::forward<F>(f));
+        };
+        template <typename F>
+        constexpr auto and_then(F&& f) const&
+        {
+            return and_then_of(*this, jpl::forward<F>(f));
+        };
+        template <typename F>
+        constexpr auto and_then(F&& f) &&
+        {
+            return and_then_of(jpl::move(*this), jpl::forward<F>(f));
+        };
+
+        // expected{ f(value) }, or this error.
+        template <typename F>
+        constexpr auto transform(F&& f) &
+        {
+            return transform_of(*this, jpl::forward<F>(f));
+        };
+        template <typename F>
+        constexpr auto transform(F&& f) const&
+        {
+            return transform_of(*this, jpl::forward<F>(f));
+        };
+        template <typename F>
+        constexpr auto transform(F&& f) &&
+        {
+            return transform_of(jpl::move(*this), jpl::forward<F>(f));
+        };
+
+        // this value, or f(error), which returns an expected with the same
+        // value type.
+        template <typename F>
+        constexpr auto or_else(F&& f) const&
+        {
+            using result = remove_cvref_t<std::invoke_result_t<F, const E&>>;
+            static_assert(impl::expected::is_expected<result> and is_same_v<typename result::value_type, T>, "jpl::expected::or_else needs a function returning an expected of T.");
+            return has_value() ? result{ in_place, data.get() } : std::invoke(jpl::forward<F>(f), data.error());
+        };
+        template <typename F>
+        constexpr auto or_else(F&& f) &&
+        {
+            using result = remove_cvref_t<std::invoke_result_t<F, E&&>>;
+            static_assert(impl::expected::is_expected<result> and is_same_v<typename result::value_type, T>, "jpl::expected::or_else needs a function returning an expected of T.");
+            return has_value() ? result{ in_place, jpl::move(data.get()) } : std::invoke(jpl::forward<F>(f), jpl::move(data.error()));
+        };
+
+        // this value, or unexpected{ f(error) }.
+        template <typename F>
+        constexpr auto transform_error(F&& f) const&
+        {
+            using result = expected<T, remove_cv_t<std::invoke_result_t<F, const E&>>>;
+            return has_value() ? result{ in_place, data.get() } : result{ unexpect, std::invoke(jpl::forward<F>(f), data.error()) };
+        };
+        template <typename F>
+        constexpr auto transform_error(F&& f) &&
+        {
+            using result = expected<T, remove_cv_t<std::invoke_result_t<F, E&&>>>;
+            return has_value() ? result{ in_place, jpl::move(data.get()) } : result{ unexpect, std::invoke(jpl::forward<F>(f), jpl::move(data.error())) };
+        };
+
+        template <typename U, typename G>
+        requires (not is_void_v<U>)
+        friend constexpr auto operator ==(const expected& left, const expected<U, G>& right) -> bool
+        {
+            if (left.has_value() != right.has_value())
+            {
+                return false;
+            }
+            return left.has_value() ? *left == *right : left.error() == right.error();
+        };
+        template <typename U>
+        requires (not impl::expected::is_expected<U>)
+        friend constexpr auto operator ==(const expected& left, const U& right) -> bool
+        {
+            return left.has_value() and *left == right;
+        };
+        template <typename G>
+        friend constexpr auto operator ==(const expected& left, const unexpected<G>& right) -> bool
+        {
+            return not left.has_value() and left.error() == right.error();
+        };
+
+    private:
+        template <typename Other>
+        static constexpr auto copy_of(Other&& other) -> impl::expected::storage<T, E>
+        {
+            if (other.has_value())
+            {
+                return impl::expected::storage<T, E>{ in_place, *jpl::forward<Other>(other) };
+            }
+            return impl::expected::storage<T, E>{ unexpect, jpl::forward<Other>(other).error() };
+        };
+
+        constexpr auto check() const -> void
+        {
+            if (not has_value())
+            {
+                throw bad_expected_access<E>{ data.error() };
+            }
+        };
+
+        template <typename G>
+        constexpr auto set_error(G&& error) -> void
+        {
+            if (has_value())
+            {
+                data.become_error(jpl::forward<G>(error));
+            }
+            else
+            {
+                data.error() = jpl::forward<G>(error);
+            }
+        };
+
+        template <typename Other>
+        constexpr auto assign(Other&& other) -> void
+        {
+            if (other.has_value() and has_value())
+            {
+                data.get() = *jpl::forward<Other>(other);
+            }
+            else if (other.has_value())
+            {
+                data.become_value(*jpl::forward<Other>(other));
+            }
+            else
+            {
+                set_error(jpl::forward<Other>(other).error());
+            }
+        };
+
+        template <typename Self, typename F>
+        static constexpr auto and_then_of(Self&& self, F&& f)
+        {
+            using result = remove_cvref_t<std::invoke_result_t<F, decltype(*jpl::forward<Self>(self))>>;
+            static_assert(impl::expected::is_expected<result> and is_same_v<typename result::error_type, E>, "jpl::expected::and_then needs a function returning an expected with the same error type.");
+            if (self.has_value())
+            {
+                return std::invoke(jpl::forward<F>(f), *jpl::forward<Self>(self));
+            }
+            return result{ unexpect, jpl::forward<Self>(self).error() };
+        };
+        template <typename Self, typename F>
+        static constexpr auto transform_of(Self&& self, F&& f)
+        {
+            using value = remove_cv_t<std::invoke_result_t<F, decltype(*jpl::forward<Self>(self))>>;
+            using result = expected<value, E>;
+            if (self.has_value())
+            {
+                if constexpr (is_void_v<value>)
+                {
+                    std::invoke(jpl::forward<F>(f), *jpl::forward<Self>(self));
+                    return result{};
+                }
+                else
+                {
+                    return result{ in_place, std::invoke(jpl::forward<F>(f), *jpl::forward<Self>(self)) };
+                }
+            }
+            return result{ unexpect, jpl::forward<Self>(self).error() };
+        };
+
+        impl::expected::storage<T, E> data;
+    };
+
+    // success carries nothing, so the error alone is stored, as an optional:
+    // when E has a niche, sizeof(expected<void, E>) == sizeof(E).
+    template <typename E>
+    struct expected<void, E>
+    {
+        using value_type = void;
+        using error_type = E;
+        using unexpected_type = unexpected<E>;
+        template <typename U>
+        using rebind = expected<U, error_type>;
+
+        constexpr expected() noexcept = default;
+        template <typename G>
+        requires is_constructible_v<E, const G&>
+        constexpr explicit(not is_convertible_v<const G&, E>) expected(const unexpected<G>& error) :
+            failure{ in_place, error.error() }
+        {};
+        template <typename G>
+        requires is_constructible_v<E, G>
+        constexpr explicit(not is_convertible_v<G, E>) expected(unexpected<G>&& error) :
+            failure{ in_place, jpl::move(error).error() }
+        {};
+        constexpr explicit expected(in_place_t) noexcept
+        {};
+        template <typename... As>
+        requires is_constructible_v<E, As...>
+        constexpr explicit expected(unexpect_t, As&&... arguments) :
+            failure{ in_place, jpl::forward<As>(arguments)... }
+        {};
+
+        template <typename G>
+        constexpr auto operator =(const unexpected<G>& error) -> expected&
+        {
+            failure = error.error();
+            return *this;
+        };
+        template <typename G>
+        constexpr auto operator =(unexpected<G>&& error) -> expected&
+        {
+            failure = jpl::move(error).error();
+            return *this;
+        };
+
+        constexpr auto emplace() noexcept -> void
+        {
+            failure.reset();
+        };
+
+        [[nodiscard]] constexpr auto has_value() const noexcept -> bool
+        {
+            return not failure.has_value();
+        };
+        constexpr explicit operator bool() const noexcept
+        {
+            return has_value();
+        };
+
+        constexpr auto operator *() const noexcept -> void
+        {};
+        constexpr auto value() const& -> void
+        {
+            if (not has_value())
+            {
+                throw bad_expected_access<E>{ *failure };
+            }
+        };
+        constexpr auto value() && -> void
+        {
+            if (not has_value())
+            {
+                throw bad_expected_access<E>{ jpl::move(*failure) };
+            }
+        };
+
+        [[nodiscard]] constexpr auto error() & noexcept -> E&
+        {
+            return *failure;
+        };
+        [[nodiscard]] constexpr auto error() const& noexcept -> const E&
+        {
+            return *failure;
+        };
+        [[nodiscard]] constexpr auto error() && noexcept -> E&&
+        {
+            return jpl::move(*failure);
+        };
+        template <typename G = E>
+        [[nodiscard]] constexpr auto error_or(G&& fallback) const& -> E
+        {
+            return has_value() ? static_cast<E>(jpl::forward<G>(fallback)) : *failure;
+        };
+
+        template <typename F>
+        constexpr auto and_then(F&& f) const&
+        {
+            using result = remove_cvref_t<std::invoke_result_t<F>>;
+            static_assert(impl::expected::is_expected<result> and is_same_v<typename result::error_type, E>, "jpl::expected::and_then needs a function returning an expected with the same error type.");
+            return has_value() ? std::invoke(jpl::forward<F>(f)) : result{ unexpect, *failure };
+        };
+        template <typename F>
+        constexpr auto transform(F&& f) const&
+        {
+            using value = remove_cv_t<std::invoke_result_t<F>>;
+            using result = expected<value, E>;
+            if (not has_value())
+            {
+                return result{ unexpect, *failure };
+            }
+            if constexpr (is_void_v<value>)
+            {
+                std::invoke(jpl::forward<F>(f));
+                return result{};
+            }
+            else
+            {
+                return result{ in_place, std::invoke(jpl::forward<F>(f)) };
+            }
+        };
+        template <typename F>
+        constexpr auto or_else(F&& f) const&
+        {
+            using result = remove_cvref_t<std::invoke_result_t<F, const E&>>;
+            return has_value() ? result{} : std::invoke(jpl::forward<F>(f), *failure);
+        };
+        template <typename F>
+        constexpr auto transform_error(F&& f) const&
+        {
+            using result = expected<void, remove_cv_t<std::invoke_result_t<F, const E&>>>;
+            return has_value() ? result{} : result{ unexpect, std::invoke(jpl::forward<F>(f), *failure) };
+        };
+
+        template <typename G>
+        friend constexpr auto operator ==(const expected& left, const expected<void, G>& right) -> bool
+        {
+            if (left.has_value() != right.has_value())
+            {
+                return false;
+            }
+            return left.has_value() or left.error() == right.error();
+        };
+        template <typename G>
+        friend constexpr auto operator ==(const expected& left, const unexpected<G>& right) -> bool
+        {
+            return not left.has_value() and left.error() == right.error();
+        };
+
+    private:
+        optional<E> failure;
+    };
+};
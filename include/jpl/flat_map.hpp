@@ -0,0 +1,529 @@
+#pragma once
+
+#include "algorithm.hpp"
+#include "cstddef.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// flat_map
+namespace jpl
+{
+    namespace impl
+    {
+        namespace flat_map
+        {
+            template <typename Compare>
+            concept transparent = requires { typename Compare::is_transparent; };
+
+            // operator-> of an iterator whose reference is a prvalue pair.
+            template <typename Reference>
+            struct arrow_proxy
+            {
+                Reference reference;
+
+                auto operator ->() noexcept -> Reference*
+                {
+                    return &reference;
+                };
+            };
+
+            // walks the key and mapped containers in lockstep.
+            template <typename KeyIterator, typename MappedIterator>
+            struct iterator
+            {
+                using iterator_category = std::random_access_iterator_tag;
+                using iterator_concept = std::random_access_iterator_tag;
+                using difference_type = ptrdiff_t;
+                using value_type = std::pair<
+                    typename std::iterator_traits<KeyIterator>::value_type,
+                    typename std::iterator_traits<MappedIterator>::value_type
+                >;
+                using reference = std::pair<
+                    typename std::iterator_traits<KeyIterator>::reference,
+                    typename std::iterator_traits<MappedIterator>::reference
+                >;
+                using pointer = arrow_proxy<reference>;
+
+                iterator() = default;
+                iterator(KeyIterator key, MappedIterator mapped) :
+                    key{ key },
+                    mapped{ mapped }
+                {};
+                // iterator to const_iterator.
+                template <typename K, typename M>
+                requires (is_convertible_v<K, KeyIterator> and is_convertible_v<M, MappedIterator> and
+                          not (is_same_v<K, KeyIterator> and is_same_v<M, MappedIterator>))
+                iterator(const iterator<K, M>& other) :
+                    key{ other.key_iterator() },
+                    mapped{ other.mapped_iterator() }
+                {};
+
+                [[nodiscard]] auto key_iterator() const noexcept -> KeyIterator
+                {
+                    return key;
+                };
+                [[nodiscard]] auto mapped_iterator() const noexcept -> MappedIterator
+                {
+                    return mapped;
+                };
+
+                auto operator *() const -> reference
+                {
+                    return reference{ *key, *mapped };
+                };
+                auto operator ->() const -> pointer
+                {
+                    return pointer{ **this };
+                };
+                auto operator [](difference_type n) const -> reference
+                {
+                    return *(*this + n);
+                };
+
+                auto operator ++() -> iterator&
+                {
+                    ++key;
+                    ++mapped;
+                    return *this;
+                };
+                auto operator ++(int) -> iterator
+                {
+                    auto old = *this;
+                    ++*this;
+                    return old;
+                };
+                auto operator --() -> iterator&
+                {
+                    --key;
+                    --mapped;
+                    return *this;
+                };
+                auto operator --(int) -> iterator
+                {
+                    auto old = *this;
+                    --*this;
+                    return old;
+                };
+                auto operator +=(difference_type n) -> iterator&
+                {
+                    key += n;
+                    mapped += n;
+                    return *this;
+                };
+                auto operator -=(difference_type n) -> iterator&
+                {
+                    return *this += -n;
+                };
+                friend auto operator +(iterator it, difference_type n) -> iterator
+                {
+                    return it += n;
+                };
+                friend auto operator +(difference_type n, iterator it) -> iterator
+                {
+                    return it += n;
+                };
+                friend auto operator -(iterator it, difference_type n) -> iterator
+                {
+                    return it -= n;
+                };
+                friend auto operator -(const iterator& left, const iterator& right) -> difference_type
+                {
+                    return left.key - right.key;
+                };
+                friend auto operator ==(const iterator& left, const iterator& right) -> bool
+                {
+                    return left.key == right.key;
+                };
+                friend auto operator <=>(const iterator& left, const iterator& right) -> std::strong_ordering
+                {
+                    return left.key <=> right.key;
+                };
+
+            private:
+                KeyIterator key;
+                MappedIterator mapped;
+            };
+        };
+    };
+
+    // a sorted associative container keeping keys and mapped values in separate
+    // containers, so lookups only touch densely packed keys. like flat_set,
+    // single inserts and erases are linear; bulk construction sorts once.
+    template <typename Key, typename T, typename Compare = std::less<Key>, typename KeyContainer = std::vector<Key>, typename MappedContainer = std::vector<T>>
+    struct flat_map
+    {
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<key_type, mapped_type>;
+        using key_compare = Compare;
+        using reference = std::pair<const key_type&, mapped_type&>;
+        using const_reference = std::pair<const key_type&, const mapped_type&>;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = impl::flat_map::iterator<typename KeyContainer::const_iterator, typename MappedContainer::iterator>;
+        using const_iterator = impl::flat_map::iterator<typename KeyContainer::const_iterator, typename MappedContainer::const_iterator>;
+        using key_container_type = KeyContainer;
+        using mapped_container_type = MappedContainer;
+
+        struct containers
+        {
+            key_container_type keys;
+            mapped_container_type values;
+        };
+
+        flat_map() = default;
+        // keys and values pair up by position. among duplicate keys the first wins.
+        flat_map(key_container_type keys, mapped_container_type values, const key_compare& compare = key_compare{}) :
+            compare{ compare },
+            data{ jpl::move(keys), jpl::move(values) }
+        {
+            normalize(0);
+        };
+        flat_map(sorted_unique_t, key_container_type keys, mapped_container_type values, const key_compare& compare = key_compare{}) :
+            compare{ compare },
+            data{ jpl::move(keys), jpl::move(values) }
+        {};
+        template <std::input_iterator I>
+        flat_map(I first, I last, const key_compare& compare = key_compare{}) :
+            compare{ compare }
+        {
+            append(first, last);
+            normalize(0);
+        };
+        flat_map(std::initializer_list<value_type> values, const key_compare& compare = key_compare{}) :
+            flat_map(values.begin(), values.end(), compare)
+        {};
+
+        [[nodiscard]] auto begin() noexcept -> iterator
+        {
+            return iterator{ data.keys.cbegin(), data.values.begin() };
+        };
+        [[nodiscard]] auto end() noexcept -> iterator
+        {
+            return iterator{ data.keys.cend(), data.values.end() };
+        };
+        [[nodiscard]] auto begin() const noexcept -> const_iterator
+        {
+            return const_iterator{ data.keys.cbegin(), data.values.cbegin() };
+        };
+        [[nodiscard]] auto end() const noexcept -> const_iterator
+        {
+            return const_iterator{ data.keys.cend(), data.values.cend() };
+        };
+        [[nodiscard]] auto cbegin() const noexcept -> const_iterator
+        {
+            return begin();
+        };
+        [[nodiscard]] auto cend() const noexcept -> const_iterator
+        {
+            return end();
+        };
+
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return data.keys.empty();
+        };
+        [[nodiscard]] auto size() const noexcept -> size_type
+        {
+            return data.keys.size();
+        };
+        [[nodiscard]] auto key_comp() const -> key_compare
+        {
+            return compare;
+        };
+        [[nodiscard]] auto keys() const noexcept -> const key_container_type&
+        {
+            return data.keys;
+        };
+        [[nodiscard]] auto values() const noexcept -> const mapped_container_type&
+        {
+            return data.values;
+        };
+
+        auto operator [](const key_type& key) -> mapped_type&
+        {
+            return (*try_emplace(key).first).second;
+        };
+        auto operator [](key_type&& key) -> mapped_type&
+        {
+            return (*try_emplace(jpl::move(key)).first).second;
+        };
+        [[nodiscard]] auto at(const key_type& key) -> mapped_type&
+        {
+            const auto position = find(key);
+            if (position == end())
+            {
+                throw std::out_of_range{ "jpl::flat_map::at" };
+            }
+            return (*position).second;
+        };
+        [[nodiscard]] auto at(const key_type& key) const -> const mapped_type&
+        {
+            const auto position = find(key);
+            if (position == end())
+            {
+                throw std::out_of_range{ "jpl::flat_map::at" };
+            }
+            return (*position).second;
+        };
+
+        template <typename K, typename... Args>
+        auto try_emplace(K&& key, Args&&... args) -> std::pair<iterator, bool>
+        {
+            const size_type index = key_lower_bound(key);
+            if (index != size() and not compare(key, data.keys[index]))
+            {
+                return { begin() + index, false };
+            }
+            // the value is built first and the key taken back out if the value
+            // cannot be inserted, so keys and values never fall out of step.
+            mapped_type value(jpl::forward<Args>(args)...);
+            data.keys.insert(data.keys.begin() + index, key_type(jpl::forward<K>(key)));
+            try
+            {
+                data.values.insert(data.values.begin() + index, jpl::move(value));
+            }
+            catch (...)
+            {
+                data.keys.erase(data.keys.begin() + index);
+                throw;
+            }
+            return { begin() + index, true };
+        };
+        template <typename M>
+        auto insert_or_assign(const key_type& key, M&& value) -> std::pair<iterator, bool>
+        {
+            auto result = try_emplace(key, jpl::forward<M>(value));
+            if (not result.second)
+            {
+                (*result.first).second = jpl::forward<M>(value);
+            }
+            return result;
+        };
+        auto insert(const value_type& value) -> std::pair<iterator, bool>
+        {
+            return try_emplace(value.first, value.second);
+        };
+        auto insert(value_type&& value) -> std::pair<iterator, bool>
+        {
+            return try_emplace(jpl::move(value.first), jpl::move(value.second));
+        };
+        // existing entries win over incoming duplicates. sorts only the new
+        // tail and merges it in. if anything throws, the tail is dropped so
+        // the arrays stay in step and sorted.
+        template <std::input_iterator I>
+        auto insert(I first, I last) -> void
+        {
+            const size_type old_size = size();
+            try
+            {
+                append(first, last);
+                normalize(old_size);
+            }
+            catch (...)
+            {
+                data.keys.erase(data.keys.begin() + std::min(old_size, data.keys.size()), data.keys.end());
+                data.values.erase(data.values.begin() + std::min(old_size, data.values.size()), data.values.end());
+                throw;
+            }
+        };
+        auto insert(std::initializer_list<value_type> values) -> void
+        {
+            insert(values.begin(), values.end());
+        };
+
+        auto erase(const_iterator position) -> iterator
+        {
+            const auto index = position - cbegin();
+            data.keys.erase(data.keys.begin() + index);
+            data.values.erase(data.values.begin() + index);
+            return begin() + index;
+        };
+        auto erase(iterator position) -> iterator
+        {
+            return erase(const_iterator{ position });
+        };
+        auto erase(const key_type& key) -> size_type
+        {
+            const auto position = find(key);
+            if (position == end())
+            {
+                return 0;
+            }
+            erase(position);
+            return 1;
+        };
+        auto clear() noexcept -> void
+        {
+            data.keys.clear();
+            data.values.clear();
+        };
+
+        // hands the underlying containers back, leaving the map empty.
+        auto extract() && -> containers
+        {
+            return jpl::move(data);
+        };
+        auto replace(key_container_type&& keys, mapped_container_type&& values) -> void
+        {
+            data.keys = jpl::move(keys);
+            data.values = jpl::move(values);
+        };
+
+        [[nodiscard]] auto lower_bound(const key_type& key) -> iterator
+        {
+            return begin() + key_lower_bound(key);
+        };
+        [[nodiscard]] auto lower_bound(const key_type& key) const -> const_iterator
+        {
+            return begin() + key_lower_bound(key);
+        };
+        [[nodiscard]] auto upper_bound(const key_type& key) -> iterator
+        {
+            return begin() + key_upper_bound(key);
+        };
+        [[nodiscard]] auto upper_bound(const key_type& key) const -> const_iterator
+        {
+            return begin() + key_upper_bound(key);
+        };
+        [[nodiscard]] auto find(const key_type& key) -> iterator
+        {
+            return begin() + key_find(key);
+        };
+        [[nodiscard]] auto find(const key_type& key) const -> const_iterator
+        {
+            return begin() + key_find(key);
+        };
+        template <typename K>
+        requires impl::flat_map::transparent<Compare>
+        [[nodiscard]] auto find(const K& key) -> iterator
+        {
+            return begin() + key_find(key);
+        };
+        template <typename K>
+        requires impl::flat_map::transparent<Compare>
+        [[nodiscard]] auto find(const K& key) const -> const_iterator
+        {
+            return begin() + key_find(key);
+        };
+        [[nodiscard]] auto contains(const key_type& key) const -> bool
+        {
+            return key_find(key) != size();
+        };
+        template <typename K>
+        requires impl::flat_map::transparent<Compare>
+        [[nodiscard]] auto contains(const K& key) const -> bool
+        {
+            return key_find(key) != size();
+        };
+        [[nodiscard]] auto count(const key_type& key) const -> size_type
+        {
+            return contains(key) ? 1 : 0;
+        };
+
+        [[nodiscard]] friend auto operator ==(const flat_map& left, const flat_map& right) -> bool
+        {
+            return std::ranges::equal(left.data.keys, right.data.keys) and std::ranges::equal(left.data.values, right.data.values);
+        };
+
+    private:
+        template <typename K>
+        auto key_lower_bound(const K& key) const -> size_type
+        {
+            return static_cast<size_type>(jpl::branchless_lower_bound(data.keys.begin(), data.keys.end(), key, compare) - data.keys.begin());
+        };
+        template <typename K>
+        auto key_upper_bound(const K& key) const -> size_type
+        {
+            return static_cast<size_type>(jpl::branchless_upper_bound(data.keys.begin(), data.keys.end(), key, compare) - data.keys.begin());
+        };
+        template <typename K>
+        auto key_find(const K& key) const -> size_type
+        {
+            const size_type index = key_lower_bound(key);
+            return index != size() and not compare(key, data.keys[index]) ? index : size();
+        };
+
+        template <typename I>
+        auto append(I first, I last) -> void
+        {
+            for (; first != last; ++first)
+            {
+                data.keys.push_back((*first).first);
+                data.values.push_back((*first).second);
+            }
+        };
+
+        // [0, sorted) is already sorted and unique. sorts positions of the tail
+        // rather than elements so keys and values move once, breaking ties by
+        // position, then merges the tail in: of equivalent keys, one from the
+        // head wins, and otherwise the earliest of the tail.
+        auto normalize(size_type sorted) -> void
+        {
+            const size_type count = size();
+            const auto from = data.keys.begin() + (sorted == 0 ? 0 : sorted - 1);
+            const bool normalized = std::adjacent_find(from, data.keys.end(), [this](const key_type& left, const key_type& right)
+            {
+                return not compare(left, right);
+            }) == data.keys.end();
+            if (normalized)
+            {
+                return;
+            }
+
+            std::vector<size_type> order(count - sorted);
+            for (size_type i = 0; i < order.size(); ++i)
+            {
+                order[i] = sorted + i;
+            }
+            jpl::sort(order.begin(), order.end(), [this](size_type left, size_type right)
+            {
+                return compare(data.keys[left], data.keys[right]) or
+                    (not compare(data.keys[right], data.keys[left]) and left < right);
+            });
+
+            containers merged;
+            if constexpr (requires { merged.keys.reserve(count); merged.values.reserve(count); })
+            {
+                merged.keys.reserve(count);
+                merged.values.reserve(count);
+            }
+            const auto take = [&](size_type index)
+            {
+                merged.keys.push_back(jpl::move(data.keys[index]));
+                merged.values.push_back(jpl::move(data.values[index]));
+            };
+            size_type head = 0;
+            for (const size_type incoming : order)
+            {
+                while (head < sorted and compare(data.keys[head], data.keys[incoming]))
+                {
+                    take(head++);
+                }
+                const bool taken = not merged.keys.empty() and not compare(merged.keys.back(), data.keys[incoming]);
+                const bool existing = head < sorted and not compare(data.keys[incoming], data.keys[head]);
+                if (not taken and not existing)
+                {
+                    take(incoming);
+                }
+            }
+            while (head < sorted)
+            {
+                take(head++);
+            }
+            data = jpl::move(merged);
+        };
+
+        [[no_unique_address]] key_compare compare;
+        containers data;
+    };
+};
@@ -0,0 +1,246 @@
+#pragma once
+
+#include "algorithm.hpp"
+#include "cstddef.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// flat_set
+namespace jpl
+{
+    namespace impl
+    {
+        namespace flat_set
+        {
+            template <typename Compare>
+            concept transparent = requires { typename Compare::is_transparent; };
+        };
+    };
+
+    // a sorted, duplicate-free sequence container searched with a branchless
+    // binary search. single inserts and erases are linear; build in bulk through
+    // the constructors or the range insert, which sort and deduplicate once.
+    template <typename Key, typename Compare = std::less<Key>, typename KeyContainer = std::vector<Key>>
+    struct flat_set
+    {
+        using key_type = Key;
+        using value_type = Key;
+        using key_compare = Compare;
+        using value_compare = Compare;
+        using container_type = KeyContainer;
+        using size_type = typename KeyContainer::size_type;
+        using difference_type = typename KeyContainer::difference_type;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using iterator = typename KeyContainer::const_iterator;
+        using const_iterator = typename KeyContainer::const_iterator;
+
+        flat_set() = default;
+        explicit flat_set(container_type keys, const key_compare& compare = key_compare{}) :
+            compare{ compare },
+            data{ jpl::move(keys) }
+        {
+            normalize(0);
+        };
+        flat_set(sorted_unique_t, container_type keys, const key_compare& compare = key_compare{}) :
+            compare{ compare },
+            data{ jpl::move(keys) }
+        {};
+        template <std::input_iterator I>
+        flat_set(I first, I last, const key_compare& compare = key_compare{}) :
+            flat_set(container_type(first, last), compare)
+        {};
+        flat_set(std::initializer_list<key_type> keys, const key_compare& compare = key_compare{}) :
+            flat_set(container_type(keys), compare)
+        {};
+
+        [[nodiscard]] auto begin() const noexcept -> const_iterator
+        {
+            return data.begin();
+        };
+        [[nodiscard]] auto end() const noexcept -> const_iterator
+        {
+            return data.end();
+        };
+        [[nodiscard]] auto cbegin() const noexcept -> const_iterator
+        {
+            return data.begin();
+        };
+        [[nodiscard]] auto cend() const noexcept -> const_iterator
+        {
+            return data.end();
+        };
+
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return data.empty();
+        };
+        [[nodiscard]] auto size() const noexcept -> size_type
+        {
+            return data.size();
+        };
+        [[nodiscard]] auto key_comp() const -> key_compare
+        {
+            return compare;
+        };
+        [[nodiscard]] auto keys() const noexcept -> const container_type&
+        {
+            return data;
+        };
+
+        template <typename... Args>
+        auto emplace(Args&&... args) -> std::pair<iterator, bool>
+        {
+            key_type key(jpl::forward<Args>(args)...);
+            auto position = jpl::branchless_lower_bound(data.begin(), data.end(), key, compare);
+            if (position != data.end() and not compare(key, *position))
+            {
+                return { position, false };
+            }
+            return { data.insert(position, jpl::move(key)), true };
+        };
+        auto insert(const value_type& key) -> std::pair<iterator, bool>
+        {
+            return emplace(key);
+        };
+        auto insert(value_type&& key) -> std::pair<iterator, bool>
+        {
+            return emplace(jpl::move(key));
+        };
+        // appends, sorts only the new tail and merges it in.
+        template <std::input_iterator I>
+        auto insert(I first, I last) -> void
+        {
+            const size_type old_size = data.size();
+            data.insert(data.end(), first, last);
+            normalize(old_size);
+        };
+        template <std::input_iterator I>
+        auto insert(sorted_unique_t, I first, I last) -> void
+        {
+            const size_type old_size = data.size();
+            data.insert(data.end(), first, last);
+            merge_tail(old_size);
+        };
+        auto insert(std::initializer_list<key_type> keys) -> void
+        {
+            insert(keys.begin(), keys.end());
+        };
+
+        auto erase(const_iterator position) -> iterator
+        {
+            return data.erase(position);
+        };
+        auto erase(const key_type& key) -> size_type
+        {
+            const auto position = find(key);
+            if (position == end())
+            {
+                return 0;
+            }
+            data.erase(position);
+            return 1;
+        };
+        auto clear() noexcept -> void
+        {
+            data.clear();
+        };
+
+        // hands the underlying container back, leaving the set empty.
+        auto extract() && -> container_type
+        {
+            return jpl::move(data);
+        };
+        auto replace(container_type&& keys) -> void
+        {
+            data = jpl::move(keys);
+        };
+
+        [[nodiscard]] auto lower_bound(const key_type& key) const -> const_iterator
+        {
+            return jpl::branchless_lower_bound(data.begin(), data.end(), key, compare);
+        };
+        template <typename K>
+        requires impl::flat_set::transparent<Compare>
+        [[nodiscard]] auto lower_bound(const K& key) const -> const_iterator
+        {
+            return jpl::branchless_lower_bound(data.begin(), data.end(), key, compare);
+        };
+        [[nodiscard]] auto upper_bound(const key_type& key) const -> const_iterator
+        {
+            return jpl::branchless_upper_bound(data.begin(), data.end(), key, compare);
+        };
+        template <typename K>
+        requires impl::flat_set::transparent<Compare>
+        [[nodiscard]] auto upper_bound(const K& key) const -> const_iterator
+        {
+            return jpl::branchless_upper_bound(data.begin(), data.end(), key, compare);
+        };
+        [[nodiscard]] auto find(const key_type& key) const -> const_iterator
+        {
+            return find_impl(key);
+        };
+        template <typename K>
+        requires impl::flat_set::transparent<Compare>
+        [[nodiscard]] auto find(const K& key) const -> const_iterator
+        {
+            return find_impl(key);
+        };
+        [[nodiscard]] auto contains(const key_type& key) const -> bool
+        {
+            return find_impl(key) != end();
+        };
+        template <typename K>
+        requires impl::flat_set::transparent<Compare>
+        [[nodiscard]] auto contains(const K& key) const -> bool
+        {
+            return find_impl(key) != end();
+        };
+        [[nodiscard]] auto count(const key_type& key) const -> size_type
+        {
+            return contains(key) ? 1 : 0;
+        };
+
+        [[nodiscard]] friend auto operator ==(const flat_set& left, const flat_set& right) -> bool
+        {
+            return std::equal(left.begin(), left.end(), right.begin(), right.end());
+        };
+
+    private:
+        template <typename K>
+        auto find_impl(const K& key) const -> const_iterator
+        {
+            const auto position = jpl::branchless_lower_bound(data.begin(), data.end(), key, compare);
+            return position != data.end() and not compare(key, *position) ? position : data.end();
+        };
+
+        // [0, sorted) is already sorted and unique.
+        auto normalize(size_type sorted) -> void
+        {
+            jpl::sort(data.begin() + sorted, data.end(), compare);
+            merge_tail(sorted);
+        };
+        auto merge_tail(size_type sorted) -> void
+        {
+            if (sorted != 0 and sorted != data.size())
+            {
+                std::inplace_merge(data.begin(), data.begin() + sorted, data.end(), compare);
+            }
+            // neighbours in sorted order are equivalent exactly when the first is
+            // not less than the second.
+            data.erase(std::unique(data.begin(), data.end(), [this](const key_type& left, const key_type& right)
+            {
+                return not compare(left, right);
+            }), data.end());
+        };
+
+        [[no_unique_address]] key_compare compare;
+        container_type data;
+    };
+};
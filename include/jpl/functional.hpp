@@ -0,0 +1,151 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// inplace_function
+namespace jpl
+{
+    template <typename Signature, size_t Capacity = 32, size_t Alignment = alignof(max_align_t)>
+    struct inplace_function;
+
+    namespace impl
+    {
+        namespace inplace_function
+        {
+            template <typename R, typename... Args>
+            struct operations
+            {
+                R (*invoke)(void*, Args&&...);
+                // move-constructs into the first buffer from the second, then
+                // destroys the second.
+                void (*relocate)(void*, void*) noexcept;
+                void (*destroy)(void*) noexcept;
+            };
+
+            template <typename F, typename R, typename... Args>
+            inline constexpr operations<R, Args...> operations_for{
+                [](void* target, Args&&... arguments) -> R
+                {
+                    return std::invoke(*static_cast<F*>(target), jpl::forward<Args>(arguments)...);
+                },
+                [](void* destination, void* source) noexcept
+                {
+                    ::new (destination) F(jpl::move(*static_cast<F*>(source)));
+                    static_cast<F*>(source)->~F();
+                },
+                [](void* target) noexcept
+                {
+                    static_cast<F*>(target)->~F();
+                },
+            };
+
+            template <typename T>
+            inline constexpr bool is_inplace_function_v = false;
+            template <typename S, size_t C, size_t A>
+            inline constexpr bool is_inplace_function_v<jpl::inplace_function<S, C, A>> = true;
+        };
+    };
+
+    // a move-only function wrapper that keeps the callable in Capacity bytes
+    // of its own storage and never allocates. callables that do not fit are
+    // rejected at compile time rather than moved to the heap, so the cost of
+    // a callback is visible where it is declared.
+    template <typename R, typename... Args, size_t Capacity, size_t Alignment>
+    struct inplace_function<R(Args...), Capacity, Alignment>
+    {
+        using result_type = R;
+
+        inplace_function() noexcept = default;
+        inplace_function(std::nullptr_t) noexcept
+        {};
+        template <typename F>
+        requires (not impl::inplace_function::is_inplace_function_v<remove_cvref_t<F>>) and std::is_invocable_r_v<R, remove_cvref_t<F>&, Args...>
+        inplace_function(F&& callable)
+        {
+            using stored = remove_cvref_t<F>;
+            static_assert(sizeof(stored) <= Capacity, "jpl::inplace_function: callable does not fit in Capacity.");
+            static_assert(Alignment % alignof(stored) == 0, "jpl::inplace_function: callable is over-aligned for Alignment.");
+            static_assert(is_nothrow_move_constructible_v<stored>, "jpl::inplace_function: callable must be nothrow move constructible.");
+            ::new (static_cast<void*>(buffer)) stored(jpl::forward<F>(callable));
+            table = &impl::inplace_function::operations_for<stored, R, Args...>;
+        };
+        inplace_function(const inplace_function&) = delete;
+        inplace_function(inplace_function&& other) noexcept :
+            table{ other.table }
+        {
+            if (table != nullptr)
+            {
+                table->relocate(buffer, other.buffer);
+                other.table = nullptr;
+            }
+        };
+        auto operator =(const inplace_function&) -> inplace_function& = delete;
+        auto operator =(inplace_function&& other) noexcept -> inplace_function&
+        {
+            if (this != &other)
+            {
+                reset();
+                if (other.table != nullptr)
+                {
+                    other.table->relocate(buffer, other.buffer);
+                    table = jpl::exchange(other.table, nullptr);
+                }
+            }
+            return *this;
+        };
+        auto operator =(std::nullptr_t) noexcept -> inplace_function&
+        {
+            reset();
+            return *this;
+        };
+        ~inplace_function()
+        {
+            reset();
+        };
+
+        // throws std::bad_function_call when empty.
+        auto operator ()(Args... arguments) -> R
+        {
+            if (table == nullptr)
+            {
+                throw std::bad_function_call{};
+            }
+            return table->invoke(buffer, jpl::forward<Args>(arguments)...);
+        };
+
+        [[nodiscard]] explicit operator bool() const noexcept
+        {
+            return table != nullptr;
+        };
+        [[nodiscard]] friend auto operator ==(const inplace_function& function, std::nullptr_t) noexcept -> bool
+        {
+            return function.table == nullptr;
+        };
+
+        friend auto swap(inplace_function& left, inplace_function& right) noexcept -> void
+        {
+            inplace_function temporary{ jpl::move(left) };
+            left = jpl::move(right);
+            right = jpl::move(temporary);
+        };
+
+    private:
+        auto reset() noexcept -> void
+        {
+            if (table != nullptr)
+            {
+                jpl::exchange(table, nullptr)->destroy(buffer);
+            }
+        };
+
+        const impl::inplace_function::operations<R, Args...>* table = nullptr;
+        alignas(Alignment) unsigned char buffer[Capacity];
+    };
+};
@@ -0,0 +1,395 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "memory.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// hazard_pointer_domain
+// hazard_pointer_default_domain
+// hazard_pointer
+// make_hazard_pointer
+namespace jpl
+{
+    namespace impl
+    {
+        namespace hazard_pointer
+        {
+            struct record
+            {
+                std::atomic<const void*> pointer{ nullptr };
+                std::atomic<bool> active{ false };
+                record* next = nullptr;
+            };
+
+            struct retired
+            {
+                const void* pointer;
+                retired* next = nullptr;
+
+                explicit retired(const void* pointer) noexcept :
+                    pointer{ pointer }
+                {};
+                virtual ~retired() = default;
+            };
+            template <typename T, typename D>
+            struct retired_object : retired
+            {
+                jpl::unique_ptr<T, D> owner;
+
+                explicit retired_object(jpl::unique_ptr<T, D>&& owner) noexcept :
+                    retired{ owner.get() },
+                    owner{ jpl::move(owner) }
+                {};
+            };
+
+            inline constexpr size_t minimum_reclaim_threshold = 64;
+        };
+    };
+
+    struct hazard_pointer_domain
+    {
+        hazard_pointer_domain() noexcept = default;
+        hazard_pointer_domain(const hazard_pointer_domain&) = delete;
+        auto operator =(const hazard_pointer_domain&) -> hazard_pointer_domain& = delete;
+
+        ~hazard_pointer_domain()
+        {
+            // no hazard can outlive its domain, so everything retired is now unreachable.
+            auto* node = retired_list.exchange(nullptr, std::memory_order_acquire);
+            while (node != nullptr)
+            {
+                delete jpl::exchange(node, node->next);
+            }
+            auto* slot = records.exchange(nullptr, std::memory_order_acquire);
+            while (slot != nullptr)
+            {
+                delete jpl::exchange(slot, slot->next);
+            }
+        };
+
+        auto acquire() -> impl::hazard_pointer::record*
+        {
+            for (auto* slot = records.load(std::memory_order_acquire); slot != nullptr; slot = slot->next)
+            {
+                bool expected = false;
+                if (not slot->active.load(std::memory_order_relaxed) and
+                    slot->active.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                {
+                    return slot;
+                }
+            }
+
+            // records are never unlinked, so a plain push is safe against concurrent walkers.
+            auto* slot = new impl::hazard_pointer::record;
+            slot->active.store(true, std::memory_order_relaxed);
+            slot->next = records.load(std::memory_order_relaxed);
+            while (not records.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+            {}
+            record_count.fetch_add(1, std::memory_order_relaxed);
+            return slot;
+        };
+        auto release(impl::hazard_pointer::record* slot) noexcept -> void
+        {
+            slot->pointer.store(nullptr, std::memory_order_release);
+            slot->active.store(false, std::memory_order_release);
+        };
+
+        template <typename T, typename D>
+        auto retire(unique_ptr<T, D>&& owner) -> void
+        {
+            if (not owner)
+            {
+                return;
+            }
+
+            push_retired(new impl::hazard_pointer::retired_object<T, D>{ jpl::move(owner) });
+            const size_t threshold = std::max(impl::hazard_pointer::minimum_reclaim_threshold, 2 * record_count.load(std::memory_order_relaxed));
+            if (retired_count.fetch_add(1, std::memory_order_relaxed) + 1 >= threshold)
+            {
+                reclaim();
+            }
+        };
+
+        // frees every retired object that no hazard pointer currently protects.
+        auto reclaim() -> void
+        {
+            auto* list = retired_list.exchange(nullptr, std::memory_order_acquire);
+            if (list == nullptr)
+            {
+                return;
+            }
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::vector<const void*> hazards;
+            for (auto* slot = records.load(std::memory_order_acquire); slot != nullptr; slot = slot->next)
+            {
+                if (const void* protected_pointer = slot->pointer.load(std::memory_order_acquire))
+                {
+                    hazards.push_back(protected_pointer);
+                }
+            }
+            std::sort(hazards.begin(), hazards.end());
+
+            impl::hazard_pointer::retired* survivors = nullptr;
+            impl::hazard_pointer::retired* tail = nullptr;
+            size_t taken = 0;
+            size_t kept = 0;
+            while (list != nullptr)
+            {
+                auto* node = jpl::exchange(list, list->next);
+                ++taken;
+                if (std::binary_search(hazards.begin(), hazards.end(), node->pointer))
+                {
+                    node->next = survivors;
+                    survivors = node;
+                    tail = tail == nullptr ? node : tail;
+                    ++kept;
+                }
+                else
+                {
+                    delete node;
+                }
+            }
+            retired_count.fetch_sub(taken, std::memory_order_relaxed);
+
+            if (survivors != nullptr)
+            {
+                tail->next = retired_list.load(std::memory_order_relaxed);
+                while (not retired_list.compare_exchange_weak(tail->next, survivors, std::memory_order_release, std::memory_order_relaxed))
+                {}
+                retired_count.fetch_add(kept, std::memory_order_relaxed);
+            }
+        };
+
+    private:
+        auto push_retired(impl::hazard_pointer::retired* node) noexcept -> void
+        {
+            node->next = retired_list.load(std::memory_order_relaxed);
+            while (not retired_list.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+            {}
+        };
+
+        std::atomic<impl::hazard_pointer::record*> records{ nullptr };
+        std::atomic<impl::hazard_pointer::retired*> retired_list{ nullptr };
+        std::atomic<size_t> record_count{ 0 };
+        std::atomic<size_t> retired_count{ 0 };
+    };
+
+    inline auto hazard_pointer_default_domain() noexcept -> hazard_pointer_domain&
+    {
+        static hazard_pointer_domain domain;
+        return domain;
+    };
+
+    struct hazard_pointer
+    {
+        constexpr hazard_pointer() noexcept = default;
+        explicit hazard_pointer(hazard_pointer_domain& domain) :
+            domain{ &domain },
+            slot{ domain.acquire() }
+        {};
+        hazard_pointer(hazard_pointer&& other) noexcept :
+            domain{ other.domain },
+            slot{ jpl::exchange(other.slot, nullptr) }
+        {};
+        auto operator =(hazard_pointer&& other) noexcept -> hazard_pointer&
+        {
+            if (this != &other)
+            {
+                if (slot != nullptr)
+                {
+                    domain->release(slot);
+                }
+                domain = other.domain;
+                slot = jpl::exchange(other.slot, nullptr);
+            }
+            return *this;
+        };
+        hazard_pointer(const hazard_pointer&) = delete;
+
+        ~hazard_pointer()
+        {
+            if (slot != nullptr)
+            {
+                domain->release(slot);
+            }
+        };
+
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return slot == nullptr;
+        };
+
+        template <typename T>
+        auto try_protect(T*& expected, const std::atomic<T*>& source) noexcept -> bool
+        {
+            T* observed = expected;
+            reset_protection(observed);
+            // the seq_cst store above must be visible before we re-read the source,
+            // otherwise a concurrent reclaim could miss it.
+            expected = source.load(std::memory_order_seq_cst);
+            if (expected != observed)
+            {
+                reset_protection();
+                return false;
+            }
+            return true;
+        };
+        template <typename T>
+        auto protect(const std::atomic<T*>& source) noexcept -> T*
+        {
+            T* pointer = source.load(std::memory_order_relaxed);
+            while (not try_protect(pointer, source))
+            {}
+            return pointer;
+        };
+
+        template <typename T>
+        auto reset_protection(const T* pointer) noexcept -> void
+        {
+            slot->pointer.store(pointer, std::memory_order_seq_cst);
+        };
+        auto reset_protection(nullptr_t = nullptr) noexcept -> void
+        {
+            slot->pointer.store(nullptr, std::memory_order_release);
+        };
+
+    private:
+        hazard_pointer_domain* domain = nullptr;
+        impl::hazard_pointer::record* slot = nullptr;
+    };
+
+    inline auto make_hazard_pointer(hazard_pointer_domain& domain = hazard_pointer_default_domain()) -> hazard_pointer
+    {
+        return hazard_pointer{ domain };
+    };
+};
+
+// guarded_ptr
+// atomic_unique_ptr
+namespace jpl
+{
+    template <typename T>
+    struct guarded_ptr
+    {
+        using element_type = T;
+        using pointer = T*;
+
+        guarded_ptr() noexcept = default;
+        guarded_ptr(hazard_pointer&& hazard, pointer data) noexcept :
+            hazard{ jpl::move(hazard) },
+            data{ data }
+        {};
+
+        auto get() const noexcept -> pointer
+        {
+            return data;
+        };
+        explicit operator bool() const noexcept
+        {
+            return data != nullptr;
+        };
+        auto operator *() const noexcept -> T&
+        {
+            return *data;
+        };
+        auto operator ->() const noexcept -> pointer
+        {
+            return data;
+        };
+
+        // drops protection early; the pointee may be reclaimed at any point afterwards.
+        auto reset() noexcept -> void
+        {
+            hazard = jpl::hazard_pointer{};
+            data = nullptr;
+        };
+
+    private:
+        jpl::hazard_pointer hazard;
+        pointer data = nullptr;
+    };
+
+    template <typename T, typename D = default_delete<T>>
+    requires is_pointer_v<typename unique_ptr<T, D>::pointer>
+    struct atomic_unique_ptr
+    {
+        // store() and compare_exchange() take objects from other unique_ptrs,
+        // and every object is retired through the one deleter kept here, so a
+        // deleter carrying state would be silently swapped for this one.
+        static_assert(is_empty_v<D>, "jpl::atomic_unique_ptr requires a stateless deleter.");
+
+        using unique_type = unique_ptr<T, D>;
+        using pointer = typename unique_type::pointer;
+        using element_type = T;
+        using deleter_type = D;
+
+        compressed_pair<std::atomic<pointer>, deleter_type> data;
+
+        constexpr atomic_unique_ptr() noexcept
+        requires impl::unique_ptr::default_constructible<deleter_type> :
+            data{ nullptr }
+        {};
+        explicit atomic_unique_ptr(unique_type&& owner) noexcept :
+            data{ owner.release(), jpl::forward<deleter_type>(owner.get_deleter()) }
+        {};
+        atomic_unique_ptr(const atomic_unique_ptr&) = delete;
+        auto operator =(const atomic_unique_ptr&) -> atomic_unique_ptr& = delete;
+
+        // readers may still be looking at the final object, so it goes through
+        // the domain like any other replaced object.
+        ~atomic_unique_ptr()
+        {
+            retire(data.first.load(std::memory_order_acquire));
+        };
+
+        [[nodiscard]] auto load() const -> guarded_ptr<T>
+        {
+            auto hazard = make_hazard_pointer();
+            pointer current = hazard.protect(data.first);
+            return guarded_ptr<T>{ jpl::move(hazard), current };
+        };
+
+        // publishes the new object; the old one is deleted through the deleter
+        // once no reader protects it.
+        auto store(unique_type&& desired) -> void
+        {
+            retire(data.first.exchange(desired.release(), std::memory_order_acq_rel));
+        };
+        auto reset() -> void
+        {
+            retire(data.first.exchange(nullptr, std::memory_order_acq_rel));
+        };
+
+        // on success, ownership of desired is taken and the object at expected
+        // is retired; on failure, desired is left untouched and expected is updated.
+        auto compare_exchange(pointer& expected, unique_type& desired) -> bool
+        {
+            if (data.first.compare_exchange_strong(expected, desired.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                desired.release();
+                retire(expected);
+                return true;
+            }
+            return false;
+        };
+
+        [[nodiscard]] auto unsafe_get() const noexcept -> pointer
+        {
+            return data.first.load(std::memory_order_acquire);
+        };
+
+    private:
+        auto retire(pointer old) -> void
+        {
+            if (old != nullptr)
+            {
+                hazard_pointer_default_domain().retire(unique_type{ old, data.second });
+            }
+        };
+    };
+};
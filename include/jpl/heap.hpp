@@ -0,0 +1,447 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "memory.hpp"
+#include "memory_resource.hpp"
+#include "new.hpp"
+#include "spinlock.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <new>
+
+// heap::allocate
+// heap::deallocate
+// heap::usable_size
+// heap::resource
+// heap_allocator
+// heap_delete
+// make_heap_unique
+namespace jpl
+{
+    namespace impl
+    {
+        namespace heap
+        {
+            // small blocks are carved from slabs aligned to their own size, so
+            // the slab header of any block is found by masking its address.
+            inline constexpr size_t slab_bytes = size_t{ 1 } << 16;
+            inline constexpr size_t header_bytes = 64;
+            // every small block is at least this aligned.
+            inline constexpr size_t quantum = 16;
+            inline constexpr size_t largest_small = 8192;
+            inline constexpr size_t class_count = 32;
+            inline constexpr size_t large = class_count;
+
+            // sixteen-byte steps up to 128, then four classes per power of two,
+            // which bounds internal fragmentation at 25%.
+            constexpr auto class_of(size_t bytes) noexcept -> size_t
+            {
+                if (bytes <= 128)
+                {
+                    return bytes == 0 ? 0 : (bytes - 1) / quantum;
+                }
+                const auto bits = static_cast<size_t>(std::bit_width(bytes - 1));
+                return 8 + (bits - 8) * 4 + ((bytes - 1) >> (bits - 3)) - 4;
+            };
+            constexpr auto class_size(size_t index) noexcept -> size_t
+            {
+                if (index < 8)
+                {
+                    return (index + 1) * quantum;
+                }
+                const size_t bits = 8 + (index - 8) / 4;
+                return (size_t{ 1 } << (bits - 1)) + (size_t{ 1 } << (bits - 3)) * ((index - 8) % 4 + 1);
+            };
+            // blocks moved between a thread cache and the central lists at a time.
+            constexpr auto batch_of(size_t index) noexcept -> size_t
+            {
+                const size_t blocks = slab_bytes / 4 / class_size(index);
+                return blocks < 2 ? 2 : blocks > 32 ? 32 : blocks;
+            };
+
+            struct slab_header
+            {
+                size_t size_class;
+                // the whole allocation, for large blocks.
+                size_t bytes;
+            };
+            // a free block links to the rest of its batch, and the first block
+            // of a batch on a central list links to the next batch.
+            struct free_block
+            {
+                free_block* next;
+                free_block* next_batch;
+            };
+
+            inline auto header_of(const void* block) noexcept -> slab_header*
+            {
+                return reinterpret_cast<slab_header*>(reinterpret_cast<std::uintptr_t>(block) & ~(slab_bytes - 1));
+            };
+
+            // slabs are never returned: a heap that shrinks and regrows would
+            // trade the latency this is for against a smaller resident set.
+            inline auto new_slab(size_t index) -> byte*
+            {
+                auto* slab = static_cast<byte*>(::operator new(slab_bytes, std::align_val_t{ slab_bytes }));
+                ::new (static_cast<void*>(slab)) slab_header{ index, slab_bytes };
+                return slab + header_bytes;
+            };
+
+            // each class's list on lines of its own, so threads trading
+            // batches of different sizes do not contend.
+            struct alignas(hardware_destructive_interference_size) central_list
+            {
+                spinlock lock;
+                free_block* batches = nullptr;
+            };
+            inline central_list central[class_count];
+
+            inline auto push_batch(size_t index, free_block* batch) noexcept -> void
+            {
+                central_list& list = central[index];
+                list.lock.lock();
+                batch->next_batch = list.batches;
+                list.batches = batch;
+                list.lock.unlock();
+            };
+            inline auto pop_batch(size_t index) noexcept -> free_block*
+            {
+                central_list& list = central[index];
+                list.lock.lock();
+                free_block* batch = list.batches;
+                if (batch != nullptr)
+                {
+                    list.batches = batch->next_batch;
+                }
+                list.lock.unlock();
+                return batch;
+            };
+
+            // one per thread. allocation and deallocation touch only this, and
+            // the central lists are visited once per batch.
+            struct cache
+            {
+                struct bin
+                {
+                    free_block* list = nullptr;
+                    size_t count = 0;
+                    // the untouched tail of the newest slab.
+                    byte* cursor = nullptr;
+                    byte* limit = nullptr;
+                };
+
+                cache() noexcept = default;
+                cache(const cache&) = delete;
+                auto operator =(const cache&) -> cache& = delete;
+                ~cache();
+
+                auto allocate(size_t index) -> void*
+                {
+                    bin& slot = bins[index];
+                    if (slot.list == nullptr and slot.cursor == slot.limit)
+                    {
+                        refill(index);
+                    }
+                    if (slot.list != nullptr)
+                    {
+                        --slot.count;
+                        return jpl::exchange(slot.list, slot.list->next);
+                    }
+                    return jpl::exchange(slot.cursor, slot.cursor + class_size(index));
+                };
+                auto deallocate(size_t index, void* block) noexcept -> void
+                {
+                    bin& slot = bins[index];
+                    slot.list = ::new (block) free_block{ slot.list, nullptr };
+                    if (++slot.count >= 2 * batch_of(index))
+                    {
+                        release_batch(index);
+                    }
+                };
+
+            private:
+                auto refill(size_t index) -> void
+                {
+                    bin& slot = bins[index];
+                    if (free_block* batch = pop_batch(index))
+                    {
+                        slot.list = batch;
+                        for (; batch != nullptr; batch = batch->next)
+                        {
+                            ++slot.count;
+                        }
+                        return;
+                    }
+                    slot.cursor = new_slab(index);
+                    slot.limit = slot.cursor + (slab_bytes - header_bytes) / class_size(index) * class_size(index);
+                };
+                // hands the first batch of the list to the central list, keeping
+                // the cache between one and two batches deep.
+                auto release_batch(size_t index) noexcept -> void
+                {
+                    bin& slot = bins[index];
+                    free_block* batch = slot.list;
+                    free_block* last = batch;
+                    for (size_t i = 1; i < batch_of(index) and last->next != nullptr; ++i)
+                    {
+                        last = last->next;
+                    }
+                    slot.list = jpl::exchange(last->next, nullptr);
+                    slot.count -= batch_of(index) < slot.count ? batch_of(index) : slot.count;
+                    push_batch(index, batch);
+                };
+
+                bin bins[class_count];
+            };
+
+            // set once the calling thread's cache is destroyed, so frees from
+            // later thread_local destructors go straight to the central lists.
+            inline thread_local bool cache_destroyed = false;
+
+            inline cache::~cache()
+            {
+                for (size_t index = 0; index < class_count; ++index)
+                {
+                    bin& slot = bins[index];
+                    for (; slot.cursor != slot.limit; slot.cursor += class_size(index))
+                    {
+                        slot.list = ::new (static_cast<void*>(slot.cursor)) free_block{ slot.list, nullptr };
+                        ++slot.count;
+                    }
+                    while (slot.list != nullptr)
+                    {
+                        release_batch(index);
+                    }
+                }
+                cache_destroyed = true;
+            };
+
+            inline auto local() noexcept -> cache*
+            {
+                if (cache_destroyed)
+                {
+                    return nullptr;
+                }
+                thread_local cache instance;
+                return &instance;
+            };
+
+            // the uncached path, for threads that are shutting down.
+            inline auto allocate_central(size_t index) -> void*
+            {
+                free_block* batch = pop_batch(index);
+                if (batch == nullptr)
+                {
+                    // the rest of the slab is abandoned; this only happens
+                    // during thread exit.
+                    return new_slab(index);
+                }
+                if (batch->next != nullptr)
+                {
+                    push_batch(index, batch->next);
+                }
+                return batch;
+            };
+
+            // large blocks get a slab of their own, with the header at the
+            // front and the block at the first suitably aligned offset.
+            inline auto allocate_large(size_t bytes, size_t alignment) -> void*
+            {
+                const size_t offset = alignment > header_bytes ? alignment : header_bytes;
+                if (alignment >= slab_bytes or bytes > static_cast<size_t>(-1) - offset)
+                {
+                    throw std::bad_alloc{};
+                }
+                auto* region = static_cast<byte*>(::operator new(offset + bytes, std::align_val_t{ slab_bytes }));
+                ::new (static_cast<void*>(region)) slab_header{ large, offset + bytes };
+                return region + offset;
+            };
+
+            inline auto deallocate(void* block, size_t index) noexcept -> void
+            {
+                if (index == large)
+                {
+                    slab_header* header = header_of(block);
+                    ::operator delete(static_cast<void*>(header), header->bytes, std::align_val_t{ slab_bytes });
+                }
+                else if (cache* local_cache = local())
+                {
+                    local_cache->deallocate(index, block);
+                }
+                else
+                {
+                    push_batch(index, ::new (block) free_block{ nullptr, nullptr });
+                }
+            };
+        };
+    };
+
+    // a general purpose allocator with size classes and per-thread caches, in
+    // the style of tcmalloc. requests up to 8 KiB with at most 16-byte
+    // alignment are served from the calling thread's cache without locking;
+    // the cache trades batches of blocks with central per-class lists when it
+    // runs dry or grows too deep, so memory freed on one thread is reused by
+    // others. larger requests go to operator new. alignment must be below
+    // 64 KiB.
+    namespace heap
+    {
+        [[nodiscard]] inline auto allocate(size_t bytes, size_t alignment = alignof(max_align_t)) -> void*
+        {
+            if (bytes > impl::heap::largest_small or alignment > impl::heap::quantum)
+            {
+                return impl::heap::allocate_large(bytes, alignment);
+            }
+            const size_t index = impl::heap::class_of(bytes);
+            if (impl::heap::cache* local = impl::heap::local())
+            {
+                return local->allocate(index);
+            }
+            return impl::heap::allocate_central(index);
+        };
+
+        // finds the size class in the block's slab header.
+        inline auto deallocate(void* block) noexcept -> void
+        {
+            if (block != nullptr)
+            {
+                impl::heap::deallocate(block, impl::heap::header_of(block)->size_class);
+            }
+        };
+        // sized deallocation: bytes and alignment must be what the block was
+        // allocated with, and the size class is computed from them instead of
+        // read from the slab header.
+        inline auto deallocate(void* block, size_t bytes, size_t alignment = alignof(max_align_t)) noexcept -> void
+        {
+            if (block != nullptr)
+            {
+                const bool small = bytes <= impl::heap::largest_small and alignment <= impl::heap::quantum;
+                impl::heap::deallocate(block, small ? impl::heap::class_of(bytes) : impl::heap::large);
+            }
+        };
+
+        // the bytes actually reserved for block, at least what was asked for.
+        [[nodiscard]] inline auto usable_size(const void* block) noexcept -> size_t
+        {
+            const impl::heap::slab_header* header = impl::heap::header_of(block);
+            if (header->size_class == impl::heap::large)
+            {
+                return header->bytes - static_cast<size_t>(static_cast<const byte*>(block) - reinterpret_cast<const byte*>(header));
+            }
+            return impl::heap::class_size(header->size_class);
+        };
+    };
+
+    namespace impl
+    {
+        namespace heap
+        {
+            struct resource final : jpl::memory_resource
+            {
+            private:
+                auto do_allocate(size_t bytes, size_t alignment) -> void* override
+                {
+                    return jpl::heap::allocate(bytes, alignment);
+                };
+                auto do_deallocate(void* pointer, size_t bytes, size_t alignment) -> void override
+                {
+                    jpl::heap::deallocate(pointer, bytes, alignment);
+                };
+                auto do_is_equal(const jpl::memory_resource& other) const noexcept -> bool override
+                {
+                    return this == &other;
+                };
+            };
+        };
+    };
+
+    namespace heap
+    {
+        // the heap as a memory_resource, for polymorphic_allocator and as the
+        // upstream of the arenas and pools.
+        [[nodiscard]] inline auto resource() noexcept -> memory_resource*
+        {
+            static impl::heap::resource instance;
+            return &instance;
+        };
+    };
+
+    // a stateless allocator over heap, for the containers.
+    template <typename T>
+    struct heap_allocator
+    {
+        using value_type = T;
+        using is_always_equal = true_type;
+
+        constexpr heap_allocator() noexcept = default;
+        template <typename U>
+        constexpr heap_allocator(const heap_allocator<U>&) noexcept
+        {};
+
+        [[nodiscard]] auto allocate(size_t count) -> T*
+        {
+            if (count > static_cast<size_t>(-1) / sizeof(T))
+            {
+                throw std::bad_array_new_length{};
+            }
+            return static_cast<T*>(heap::allocate(count * sizeof(T), alignof(T)));
+        };
+        auto deallocate(T* pointer, size_t count) noexcept -> void
+        {
+            heap::deallocate(pointer, count * sizeof(T), alignof(T));
+        };
+
+        template <typename U>
+        friend constexpr auto operator ==(const heap_allocator&, const heap_allocator<U>&) noexcept -> bool
+        {
+            return true;
+        };
+    };
+
+    // destroys and frees an object made by make_heap_unique. the free is sized
+    // unless T has a virtual destructor, when the object may be larger than T
+    // and the size is read from its slab instead.
+    template <typename T>
+    struct heap_delete
+    {
+        constexpr heap_delete() noexcept = default;
+        template <typename U> requires is_convertible_v<U*, T*>
+        constexpr heap_delete(const heap_delete<U>&) noexcept
+        {};
+
+        auto operator ()(T* object) const noexcept -> void
+        {
+            static_assert(sizeof(T) > 0, "T is an incomplete type.");
+            if constexpr (has_virtual_destructor_v<T>)
+            {
+                // a base subobject need not start where its object does.
+                void* storage = const_cast<void*>(dynamic_cast<const volatile void*>(object));
+                object->~T();
+                heap::deallocate(storage);
+            }
+            else
+            {
+                object->~T();
+                heap::deallocate(const_cast<void*>(static_cast<const volatile void*>(object)), sizeof(T), alignof(T));
+            }
+        };
+    };
+
+    template <typename T, typename... As>
+    [[nodiscard]] auto make_heap_unique(As&&... arguments) -> unique_ptr<T, heap_delete<T>>
+    {
+        void* storage = heap::allocate(sizeof(T), alignof(T));
+        try
+        {
+            return unique_ptr<T, heap_delete<T>>{ ::new (storage) T(jpl::forward<As>(arguments)...) };
+        }
+        catch (...)
+        {
+            heap::deallocate(storage, sizeof(T), alignof(T));
+            throw;
+        }
+    };
+};
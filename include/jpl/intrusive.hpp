@@ -0,0 +1,834 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+
+// list_hook
+// hash_set_hook
+// hook_traits
+// intrusive_list
+// intrusive_hash_set
+// ref_counted
+// intrusive_ptr
+namespace jpl
+{
+    // links embedded in an element, so that containers of references to it
+    // need no nodes of their own. a copy of an element starts out unlinked,
+    // and an element must be removed from its container before it dies.
+    struct list_hook
+    {
+        list_hook() noexcept = default;
+        list_hook(const list_hook&) noexcept
+        {};
+        auto operator =(const list_hook&) noexcept -> list_hook&
+        {
+            return *this;
+        };
+
+        [[nodiscard]] auto is_linked() const noexcept -> bool
+        {
+            return next != nullptr;
+        };
+
+        list_hook* previous = nullptr;
+        list_hook* next = nullptr;
+    };
+    struct hash_set_hook
+    {
+        hash_set_hook() noexcept = default;
+        hash_set_hook(const hash_set_hook&) noexcept
+        {};
+        auto operator =(const hash_set_hook&) noexcept -> hash_set_hook&
+        {
+            return *this;
+        };
+
+        [[nodiscard]] auto is_linked() const noexcept -> bool
+        {
+            return link != nullptr;
+        };
+
+        hash_set_hook* next = nullptr;
+        // the pointer that points at this hook, either a bucket or the
+        // previous hook's next, which is what makes unlinking O(1).
+        hash_set_hook** link = nullptr;
+        // cached so rehashing never calls the hash function.
+        size_t hash = 0;
+    };
+
+    namespace impl
+    {
+        namespace intrusive
+        {
+            template <typename M>
+            struct member_pointer;
+            template <typename H, typename T>
+            struct member_pointer<H T::*>
+            {
+                using owner = T;
+                using hook = H;
+            };
+        };
+    };
+
+    // names the hook inside an element by member pointer, as in
+    // intrusive_list<&connection::hook>, and converts between the two.
+    template <auto Member>
+    requires is_member_object_pointer_v<decltype(Member)>
+    struct hook_traits
+    {
+        using value_type = typename impl::intrusive::member_pointer<decltype(Member)>::owner;
+        using hook_type = typename impl::intrusive::member_pointer<decltype(Member)>::hook;
+
+        [[nodiscard]] static auto to_hook(value_type& value) noexcept -> hook_type*
+        {
+            hook_type* hook = &(value.*Member);
+            if (offset().load(std::memory_order_relaxed) < 0)
+            {
+                offset().store(static_cast<ptrdiff_t>(reinterpret_cast<std::uintptr_t>(hook) - reinterpret_cast<std::uintptr_t>(&value)), std::memory_order_relaxed);
+            }
+            return hook;
+        };
+        [[nodiscard]] static auto to_value(hook_type* hook) noexcept -> value_type*
+        {
+            return reinterpret_cast<value_type*>(reinterpret_cast<std::uintptr_t>(hook) - static_cast<std::uintptr_t>(offset().load(std::memory_order_relaxed)));
+        };
+        [[nodiscard]] static auto to_value(const hook_type* hook) noexcept -> const value_type*
+        {
+            return to_value(const_cast<hook_type*>(hook));
+        };
+
+    private:
+        // the same for every object, so it is measured on the first live one
+        // to_hook sees. every hook to_value is given came from to_hook, so the
+        // offset is known by then; every writer stores the same value, so a
+        // race between them is harmless.
+        static auto offset() noexcept -> std::atomic<ptrdiff_t>&
+        {
+            static constinit std::atomic<ptrdiff_t> measured{ -1 };
+            return measured;
+        };
+    };
+
+    namespace impl
+    {
+        namespace intrusive_list
+        {
+            template <typename Traits, typename Value>
+            struct iterator
+            {
+                using iterator_category = std::bidirectional_iterator_tag;
+                using iterator_concept = std::bidirectional_iterator_tag;
+                using difference_type = ptrdiff_t;
+                using value_type = remove_const_t<Value>;
+                using reference = Value&;
+                using pointer = Value*;
+
+                iterator() = default;
+                explicit iterator(list_hook* hook) noexcept :
+                    hook{ hook }
+                {};
+                // iterator to const_iterator.
+                template <typename V>
+                requires (is_same_v<const V, Value> and not is_same_v<V, Value>)
+                iterator(const iterator<Traits, V>& other) noexcept :
+                    hook{ other.node() }
+                {};
+
+                [[nodiscard]] auto node() const noexcept -> list_hook*
+                {
+                    return hook;
+                };
+
+                auto operator *() const noexcept -> reference
+                {
+                    return *Traits::to_value(hook);
+                };
+                auto operator ->() const noexcept -> pointer
+                {
+                    return Traits::to_value(hook);
+                };
+                auto operator ++() noexcept -> iterator&
+                {
+                    hook = hook->next;
+                    return *this;
+                };
+                auto operator ++(int) noexcept -> iterator
+                {
+                    auto old = *this;
+                    ++*this;
+                    return old;
+                };
+                auto operator --() noexcept -> iterator&
+                {
+                    hook = hook->previous;
+                    return *this;
+                };
+                auto operator --(int) noexcept -> iterator
+                {
+                    auto old = *this;
+                    --*this;
+                    return old;
+                };
+
+                friend auto operator ==(const iterator& left, const iterator& right) noexcept -> bool
+                {
+                    return left.hook == right.hook;
+                };
+
+            private:
+                list_hook* hook = nullptr;
+            };
+        };
+    };
+
+    // a doubly linked list of elements it does not own, linked through a
+    // list_hook member. linking and unlinking never allocate, and an element
+    // can be removed knowing only the element. an element is in at most one
+    // list per hook; give it several hooks to be in several lists.
+    template <auto Hook>
+    requires is_same_v<typename hook_traits<Hook>::hook_type, list_hook>
+    struct intrusive_list
+    {
+        using traits = hook_traits<Hook>;
+        using value_type = typename traits::value_type;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using iterator = impl::intrusive_list::iterator<traits, value_type>;
+        using const_iterator = impl::intrusive_list::iterator<traits, const value_type>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        intrusive_list() noexcept
+        {
+            root.previous = &root;
+            root.next = &root;
+        };
+        intrusive_list(const intrusive_list&) = delete;
+        intrusive_list(intrusive_list&& other) noexcept :
+            intrusive_list{}
+        {
+            splice(end(), other);
+        };
+        auto operator =(const intrusive_list&) -> intrusive_list& = delete;
+        auto operator =(intrusive_list&& other) noexcept -> intrusive_list&
+        {
+            if (this != &other)
+            {
+                clear();
+                splice(end(), other);
+            }
+            return *this;
+        };
+        // unlinks every element; none are destroyed.
+        ~intrusive_list()
+        {
+            clear();
+        };
+
+        [[nodiscard]] auto begin() noexcept -> iterator
+        {
+            return iterator{ root.next };
+        };
+        [[nodiscard]] auto begin() const noexcept -> const_iterator
+        {
+            return const_iterator{ root.next };
+        };
+        [[nodiscard]] auto end() noexcept -> iterator
+        {
+            return iterator{ &root };
+        };
+        [[nodiscard]] auto end() const noexcept -> const_iterator
+        {
+            return const_iterator{ const_cast<list_hook*>(&root) };
+        };
+        [[nodiscard]] auto rbegin() noexcept -> reverse_iterator
+        {
+            return reverse_iterator{ end() };
+        };
+        [[nodiscard]] auto rbegin() const noexcept -> const_reverse_iterator
+        {
+            return const_reverse_iterator{ end() };
+        };
+        [[nodiscard]] auto rend() noexcept -> reverse_iterator
+        {
+            return reverse_iterator{ begin() };
+        };
+        [[nodiscard]] auto rend() const noexcept -> const_reverse_iterator
+        {
+            return const_reverse_iterator{ begin() };
+        };
+
+        // the element's position, found from its hook alone.
+        [[nodiscard]] auto iterator_to(value_type& value) noexcept -> iterator
+        {
+            return iterator{ traits::to_hook(value) };
+        };
+        [[nodiscard]] auto iterator_to(const value_type& value) const noexcept -> const_iterator
+        {
+            return const_iterator{ traits::to_hook(const_cast<value_type&>(value)) };
+        };
+
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return count == 0;
+        };
+        [[nodiscard]] auto size() const noexcept -> size_t
+        {
+            return count;
+        };
+
+        [[nodiscard]] auto front() noexcept -> reference
+        {
+            return *begin();
+        };
+        [[nodiscard]] auto front() const noexcept -> const_reference
+        {
+            return *begin();
+        };
+        [[nodiscard]] auto back() noexcept -> reference
+        {
+            return *--end();
+        };
+        [[nodiscard]] auto back() const noexcept -> const_reference
+        {
+            return *--end();
+        };
+
+        // value must not be linked through this hook already.
+        auto insert(const_iterator position, value_type& value) noexcept -> iterator
+        {
+            list_hook* hook = traits::to_hook(value);
+            list_hook* after = position.node();
+            hook->previous = after->previous;
+            hook->next = after;
+            after->previous->next = hook;
+            after->previous = hook;
+            ++count;
+            return iterator{ hook };
+        };
+        auto push_front(value_type& value) noexcept -> void
+        {
+            insert(begin(), value);
+        };
+        auto push_back(value_type& value) noexcept -> void
+        {
+            insert(end(), value);
+        };
+
+        auto erase(const_iterator position) noexcept -> iterator
+        {
+            list_hook* hook = position.node();
+            list_hook* next = hook->next;
+            hook->previous->next = next;
+            next->previous = hook->previous;
+            hook->previous = nullptr;
+            hook->next = nullptr;
+            --count;
+            return iterator{ next };
+        };
+        // value must be in this list.
+        auto erase(value_type& value) noexcept -> void
+        {
+            erase(iterator_to(value));
+        };
+        auto pop_front() noexcept -> void
+        {
+            erase(begin());
+        };
+        auto pop_back() noexcept -> void
+        {
+            erase(--end());
+        };
+        auto clear() noexcept -> void
+        {
+            while (not empty())
+            {
+                pop_front();
+            }
+        };
+
+        // moves value, which must be in this list, to just before position, as
+        // an lru list does on every hit.
+        auto splice(const_iterator position, value_type& value) noexcept -> void
+        {
+            list_hook* hook = traits::to_hook(value);
+            if (hook == position.node())
+            {
+                return;
+            }
+            erase(iterator_to(value));
+            insert(position, value);
+        };
+        // moves every element of other to just before position.
+        auto splice(const_iterator position, intrusive_list& other) noexcept -> void
+        {
+            if (other.empty() or &other == this)
+            {
+                return;
+            }
+            list_hook* after = position.node();
+            list_hook* first = other.root.next;
+            list_hook* last = other.root.previous;
+            first->previous = after->previous;
+            last->next = after;
+            after->previous->next = first;
+            after->previous = last;
+            count += jpl::exchange(other.count, 0);
+            other.root.previous = &other.root;
+            other.root.next = &other.root;
+        };
+
+    private:
+        list_hook root;
+        size_t count = 0;
+    };
+
+    namespace impl
+    {
+        namespace intrusive_hash_set
+        {
+            // fibonacci hashing: the top bits of the product, so weak hashes
+            // such as std::hash's identity on integers still spread.
+            constexpr auto bucket_of(size_t hash, unsigned shift) noexcept -> size_t
+            {
+                return shift == sizeof(size_t) * 8 ? 0 : (hash * 0x9e3779b97f4a7c15ull) >> shift;
+            };
+
+            template <typename Traits, typename Value>
+            struct iterator
+            {
+                using iterator_category = std::forward_iterator_tag;
+                using iterator_concept = std::forward_iterator_tag;
+                using difference_type = ptrdiff_t;
+                using value_type = remove_const_t<Value>;
+                using reference = Value&;
+                using pointer = Value*;
+
+                iterator() = default;
+                iterator(hash_set_hook* hook, hash_set_hook** bucket, hash_set_hook** last) noexcept :
+                    hook{ hook },
+                    bucket{ bucket },
+                    last{ last }
+                {
+                    if (hook == nullptr)
+                    {
+                        advance();
+                    }
+                };
+                // iterator to const_iterator.
+                template <typename V>
+                requires (is_same_v<const V, Value> and not is_same_v<V, Value>)
+                iterator(const iterator<Traits, V>& other) noexcept :
+                    hook{ other.hook },
+                    bucket{ other.bucket },
+                    last{ other.last }
+                {};
+
+                auto operator *() const noexcept -> reference
+                {
+                    return *Traits::to_value(hook);
+                };
+                auto operator ->() const noexcept -> pointer
+                {
+                    return Traits::to_value(hook);
+                };
+                auto operator ++() noexcept -> iterator&
+                {
+                    hook = hook->next;
+                    if (hook == nullptr)
+                    {
+                        advance();
+                    }
+                    return *this;
+                };
+                auto operator ++(int) noexcept -> iterator
+                {
+                    auto old = *this;
+                    ++*this;
+                    return old;
+                };
+
+                friend auto operator ==(const iterator& left, const iterator& right) noexcept -> bool
+                {
+                    return left.hook == right.hook;
+                };
+
+                hash_set_hook* hook = nullptr;
+                hash_set_hook** bucket = nullptr;
+                hash_set_hook** last = nullptr;
+
+            private:
+                // to the first element of a later bucket, or the end.
+                auto advance() noexcept -> void
+                {
+                    while (hook == nullptr and bucket != last)
+                    {
+                        ++bucket;
+                        hook = bucket == last ? nullptr : *bucket;
+                    }
+                };
+            };
+        };
+    };
+
+    // a hash set of elements it does not own, chained through a hash_set_hook
+    // member. the bucket array is allocated only by the constructor and
+    // rehash: inserting and erasing never allocate and never rehash, so the
+    // owner decides when the load factor is worth a rehash. erasing an
+    // element needs only the element. lookups take any key that Hash and
+    // KeyEqual accept alongside the element.
+    template <auto Hook, typename Hash = std::hash<typename hook_traits<Hook>::value_type>, typename KeyEqual = std::equal_to<>>
+    requires is_same_v<typename hook_traits<Hook>::hook_type, hash_set_hook>
+    struct intrusive_hash_set
+    {
+        using traits = hook_traits<Hook>;
+        using value_type = typename traits::value_type;
+        using size_type = size_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using iterator = impl::intrusive_hash_set::iterator<traits, value_type>;
+        using const_iterator = impl::intrusive_hash_set::iterator<traits, const value_type>;
+
+        // rounded up to a power of two.
+        explicit intrusive_hash_set(size_t bucket_count = 64, const Hash& hash = Hash{}, const KeyEqual& equal = KeyEqual{}) :
+            hash_function{ hash },
+            equal{ equal }
+        {
+            rehash(bucket_count);
+        };
+        intrusive_hash_set(const intrusive_hash_set&) = delete;
+        auto operator =(const intrusive_hash_set&) -> intrusive_hash_set& = delete;
+        // unlinks every element; none are destroyed.
+        ~intrusive_hash_set()
+        {
+            clear();
+        };
+
+        [[nodiscard]] auto begin() noexcept -> iterator
+        {
+            return iterator{ buckets[0], &buckets[0], &buckets[0] + buckets_size };
+        };
+        [[nodiscard]] auto begin() const noexcept -> const_iterator
+        {
+            return const_iterator{ buckets[0], &buckets[0], &buckets[0] + buckets_size };
+        };
+        [[nodiscard]] auto end() noexcept -> iterator
+        {
+            return iterator{ nullptr, &buckets[0] + buckets_size, &buckets[0] + buckets_size };
+        };
+        [[nodiscard]] auto end() const noexcept -> const_iterator
+        {
+            return const_iterator{ nullptr, &buckets[0] + buckets_size, &buckets[0] + buckets_size };
+        };
+
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return count == 0;
+        };
+        [[nodiscard]] auto size() const noexcept -> size_t
+        {
+            return count;
+        };
+        [[nodiscard]] auto bucket_count() const noexcept -> size_t
+        {
+            return buckets_size;
+        };
+        [[nodiscard]] auto load_factor() const noexcept -> float
+        {
+            return static_cast<float>(count) / static_cast<float>(buckets_size);
+        };
+
+        // links value unless an equal element is already in the set, and
+        // returns that element or value, and whether value was linked.
+        auto insert(value_type& value) -> std::pair<iterator, bool>
+        {
+            const size_t hash = hash_function(value);
+            const size_t bucket = impl::intrusive_hash_set::bucket_of(hash, shift);
+            if (hash_set_hook* found = find_in(bucket, hash, value))
+            {
+                return { make_iterator(found, bucket), false };
+            }
+            hash_set_hook* hook = traits::to_hook(value);
+            hook->hash = hash;
+            link(hook, bucket);
+            ++count;
+            return { make_iterator(hook, bucket), true };
+        };
+
+        template <typename K>
+        [[nodiscard]] auto find(const K& key) -> iterator
+        {
+            const size_t hash = hash_function(key);
+            const size_t bucket = impl::intrusive_hash_set::bucket_of(hash, shift);
+            hash_set_hook* found = find_in(bucket, hash, key);
+            return found == nullptr ? end() : make_iterator(found, bucket);
+        };
+        template <typename K>
+        [[nodiscard]] auto find(const K& key) const -> const_iterator
+        {
+            return const_cast<intrusive_hash_set&>(*this).find(key);
+        };
+        template <typename K>
+        [[nodiscard]] auto contains(const K& key) const -> bool
+        {
+            return find(key) != end();
+        };
+
+        // value must be in this set.
+        auto erase(value_type& value) noexcept -> void
+        {
+            hash_set_hook* hook = traits::to_hook(value);
+            *hook->link = hook->next;
+            if (hook->next != nullptr)
+            {
+                hook->next->link = hook->link;
+            }
+            hook->next = nullptr;
+            hook->link = nullptr;
+            --count;
+        };
+        auto erase(const_iterator position) noexcept -> iterator
+        {
+            iterator next{ position.hook, position.bucket, position.last };
+            ++next;
+            erase(*traits::to_value(position.hook));
+            return next;
+        };
+        // returns how many elements were unlinked, zero or one.
+        template <typename K>
+        requires (not is_convertible_v<const K&, const_iterator>)
+        auto erase(const K& key) -> size_t
+        {
+            const iterator found = find(key);
+            if (found == end())
+            {
+                return 0;
+            }
+            erase(*found);
+            return 1;
+        };
+        auto clear() noexcept -> void
+        {
+            for (size_t bucket = 0; bucket < buckets_size; ++bucket)
+            {
+                while (buckets[bucket] != nullptr)
+                {
+                    erase(*traits::to_value(buckets[bucket]));
+                }
+            }
+        };
+
+        // relinks every element into bucket_count buckets, rounded up to a
+        // power of two, using the hashes cached in their hooks.
+        auto rehash(size_t bucket_count) -> void
+        {
+            const size_t size = std::bit_ceil(bucket_count == 0 ? size_t{ 1 } : bucket_count);
+            auto fresh = std::make_unique<hash_set_hook*[]>(size);
+            std::unique_ptr<hash_set_hook*[]> old = jpl::exchange(buckets, jpl::move(fresh));
+            const size_t old_size = jpl::exchange(buckets_size, size);
+            shift = static_cast<unsigned>(sizeof(size_t) * 8 - static_cast<size_t>(std::countr_zero(size)));
+            for (size_t bucket = 0; bucket < old_size; ++bucket)
+            {
+                for (hash_set_hook* hook = old[bucket]; hook != nullptr;)
+                {
+                    hash_set_hook* next = hook->next;
+                    link(hook, impl::intrusive_hash_set::bucket_of(hook->hash, shift));
+                    hook = next;
+                }
+            }
+        };
+
+    private:
+        auto link(hash_set_hook* hook, size_t bucket) noexcept -> void
+        {
+            hook->next = buckets[bucket];
+            hook->link = &buckets[bucket];
+            if (hook->next != nullptr)
+            {
+                hook->next->link = &hook->next;
+            }
+            buckets[bucket] = hook;
+        };
+        template <typename K>
+        auto find_in(size_t bucket, size_t hash, const K& key) const -> hash_set_hook*
+        {
+            for (hash_set_hook* hook = buckets[bucket]; hook != nullptr; hook = hook->next)
+            {
+                if (hook->hash == hash and equal(*traits::to_value(hook), key))
+                {
+                    return hook;
+                }
+            }
+            return nullptr;
+        };
+        auto make_iterator(hash_set_hook* hook, size_t bucket) noexcept -> iterator
+        {
+            return iterator{ hook, &buckets[bucket], &buckets[0] + buckets_size };
+        };
+
+        [[no_unique_address]] Hash hash_function;
+        [[no_unique_address]] KeyEqual equal;
+        std::unique_ptr<hash_set_hook*[]> buckets;
+        size_t buckets_size = 0;
+        unsigned shift = sizeof(size_t) * 8;
+        size_t count = 0;
+    };
+
+    // an atomic reference count embedded in Derived, handed to Disposer when
+    // the last reference goes. a copy starts with a count of its own.
+    template <typename Derived, typename Disposer = default_delete<Derived>>
+    struct ref_counted
+    {
+        ref_counted() noexcept = default;
+        ref_counted(const ref_counted&) noexcept
+        {};
+        auto operator =(const ref_counted&) noexcept -> ref_counted&
+        {
+            return *this;
+        };
+
+        [[nodiscard]] auto use_count() const noexcept -> size_t
+        {
+            return references.load(std::memory_order_relaxed);
+        };
+
+        friend auto intrusive_ptr_add_ref(const Derived* object) noexcept -> void
+        {
+            static_cast<const ref_counted*>(object)->references.fetch_add(1, std::memory_order_relaxed);
+        };
+        // takes a reference unless the count has already reached zero, for
+        // objects found through a pointer that does not own them.
+        friend auto intrusive_ptr_try_add_ref(const Derived* object) noexcept -> bool
+        {
+            auto& references = static_cast<const ref_counted*>(object)->references;
+            size_t count = references.load(std::memory_order_relaxed);
+            while (count != 0)
+            {
+                if (references.compare_exchange_weak(count, count + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+        friend auto intrusive_ptr_release(const Derived* object) -> void
+        {
+            if (static_cast<const ref_counted*>(object)->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                Disposer{}(const_cast<Derived*>(object));
+            }
+        };
+
+    private:
+        mutable std::atomic<size_t> references{ 0 };
+    };
+
+    // shares an object that counts its own references, found through
+    // intrusive_ptr_add_ref and intrusive_ptr_release, as ref_counted
+    // provides. the count lives in the object, so a raw pointer to it can
+    // always be turned back into an owning one.
+    template <typename T>
+    struct intrusive_ptr
+    {
+        using element_type = T;
+
+        constexpr intrusive_ptr() noexcept = default;
+        constexpr intrusive_ptr(nullptr_t) noexcept
+        {};
+        // with add_ref false, takes over a reference the caller already holds.
+        explicit intrusive_ptr(T* object, bool add_ref = true) noexcept :
+            object{ object }
+        {
+            if (object != nullptr and add_ref)
+            {
+                intrusive_ptr_add_ref(object);
+            }
+        };
+        intrusive_ptr(const intrusive_ptr& other) noexcept :
+            intrusive_ptr{ other.object }
+        {};
+        template <typename U>
+        requires is_convertible_v<U*, T*>
+        intrusive_ptr(const intrusive_ptr<U>& other) noexcept :
+            intrusive_ptr{ other.get() }
+        {};
+        intrusive_ptr(intrusive_ptr&& other) noexcept :
+            object{ jpl::exchange(other.object, nullptr) }
+        {};
+        auto operator =(const intrusive_ptr& other) noexcept -> intrusive_ptr&
+        {
+            intrusive_ptr{ other }.swap(*this);
+            return *this;
+        };
+        auto operator =(intrusive_ptr&& other) noexcept -> intrusive_ptr&
+        {
+            intrusive_ptr{ jpl::move(other) }.swap(*this);
+            return *this;
+        };
+        ~intrusive_ptr()
+        {
+            if (object != nullptr)
+            {
+                intrusive_ptr_release(object);
+            }
+        };
+
+        [[nodiscard]] auto get() const noexcept -> T*
+        {
+            return object;
+        };
+        [[nodiscard]] auto operator *() const noexcept -> T&
+        {
+            return *object;
+        };
+        [[nodiscard]] auto operator ->() const noexcept -> T*
+        {
+            return object;
+        };
+        [[nodiscard]] explicit operator bool() const noexcept
+        {
+            return object != nullptr;
+        };
+
+        auto reset() noexcept -> void
+        {
+            intrusive_ptr{}.swap(*this);
+        };
+        // gives up the reference without releasing it.
+        [[nodiscard]] auto detach() noexcept -> T*
+        {
+            return jpl::exchange(object, nullptr);
+        };
+        auto swap(intrusive_ptr& other) noexcept -> void
+        {
+            object = jpl::exchange(other.object, object);
+        };
+
+        template <typename U>
+        [[nodiscard]] friend auto operator ==(const intrusive_ptr& left, const intrusive_ptr<U>& right) noexcept -> bool
+        {
+            return left.get() == right.get();
+        };
+        [[nodiscard]] friend auto operator ==(const intrusive_ptr& left, nullptr_t) noexcept -> bool
+        {
+            return left.object == nullptr;
+        };
+
+    private:
+        T* object = nullptr;
+    };
+};
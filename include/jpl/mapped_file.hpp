@@ -0,0 +1,311 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "memory.hpp"
+#include "memory_resource.hpp"
+#include "span.hpp"
+#include "utility.hpp"
+
+#include <cerrno>
+#include <new>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// mapped_file
+// mapped_arena
+namespace jpl
+{
+    namespace impl
+    {
+        namespace mapped_file
+        {
+            // the region's length travels with the deleter, so the unique_ptr
+            // alone is enough to unmap it.
+            struct unmap
+            {
+                using pointer = byte*;
+
+                size_t length = 0;
+
+                auto operator ()(byte* region) const noexcept -> void
+                {
+                    ::munmap(region, length);
+                };
+            };
+
+            [[noreturn]] inline auto fail(const char* what) -> void
+            {
+                throw std::system_error{ errno, std::generic_category(), what };
+            };
+
+            // closes the descriptor on every path out of the constructor; the
+            // mapping stays valid without it.
+            struct descriptor
+            {
+                int value = -1;
+
+                ~descriptor()
+                {
+                    if (value != -1)
+                    {
+                        ::close(value);
+                    }
+                };
+            };
+        };
+    };
+
+    // a file, or anonymous memory, mapped into the address space. pages are
+    // read in by the kernel on first touch and shared with the page cache, so
+    // large read-only data costs neither a copy nor a heap buffer. posix only.
+    struct mapped_file
+    {
+        enum struct mode
+        {
+            // shared with the page cache; writing is an error.
+            read_only,
+            // writes go through to the file.
+            read_write,
+            // writes stay private to this mapping.
+            copy_on_write,
+        };
+        // advisory only: the kernel may ignore any of these.
+        enum struct hint
+        {
+            normal,
+            sequential,
+            random,
+            willneed,
+            dontneed,
+            hugepage,
+        };
+
+        mapped_file() noexcept = default;
+        explicit mapped_file(const char* path, mode access = mode::read_only)
+        {
+            impl::mapped_file::descriptor file{ ::open(path, access == mode::read_write ? O_RDWR : O_RDONLY) };
+            if (file.value == -1)
+            {
+                impl::mapped_file::fail("jpl::mapped_file: open");
+            }
+            struct stat status;
+            if (::fstat(file.value, &status) == -1)
+            {
+                impl::mapped_file::fail("jpl::mapped_file: fstat");
+            }
+            map(file.value, static_cast<size_t>(status.st_size), access);
+        };
+        // creates the file if needed and sets its length to size.
+        mapped_file(const char* path, size_t size)
+        {
+            impl::mapped_file::descriptor file{ ::open(path, O_RDWR | O_CREAT, 0644) };
+            if (file.value == -1)
+            {
+                impl::mapped_file::fail("jpl::mapped_file: open");
+            }
+            if (::ftruncate(file.value, static_cast<off_t>(size)) == -1)
+            {
+                impl::mapped_file::fail("jpl::mapped_file: ftruncate");
+            }
+            map(file.value, size, mode::read_write);
+        };
+
+        // zero-filled private memory with no file behind it. address space is
+        // reserved up front, pages are only committed when touched.
+        [[nodiscard]] static auto anonymous(size_t size) -> mapped_file
+        {
+            mapped_file result;
+            result.map(-1, size, mode::copy_on_write);
+            return result;
+        };
+
+        mapped_file(mapped_file&&) noexcept = default;
+        auto operator =(mapped_file&&) noexcept -> mapped_file& = default;
+
+        [[nodiscard]] auto data() const noexcept -> const byte*
+        {
+            return region.get();
+        };
+        [[nodiscard]] auto size() const noexcept -> size_t
+        {
+            return region ? region.get_deleter().length : 0;
+        };
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return size() == 0;
+        };
+        [[nodiscard]] auto writable() const noexcept -> bool
+        {
+            return access != mode::read_only;
+        };
+
+        [[nodiscard]] auto bytes() const noexcept -> span<const byte>
+        {
+            return span<const byte>{ region.get(), size() };
+        };
+        // only meaningful for writable mappings; a read-only one faults on store.
+        [[nodiscard]] auto writable_bytes() noexcept -> span<byte>
+        {
+            return span<byte>{ region.get(), size() };
+        };
+
+        // applies to the pages covering [offset, offset + length). returns
+        // whether the kernel accepted the hint; it is never an error to ignore.
+        auto advise(hint advice, size_t offset = 0, size_t length = dynamic_extent) const noexcept -> bool
+        {
+            if (empty() or offset >= size())
+            {
+                return false;
+            }
+            length = length > size() - offset ? size() - offset : length;
+            // madvise wants a page-aligned start.
+            const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            const size_t aligned = offset & ~(page - 1);
+            const int flag = advice_flag(advice);
+            if (flag == -1)
+            {
+                return false;
+            }
+            return ::madvise(region.get() + aligned, length + (offset - aligned), flag) == 0;
+        };
+
+        // writes dirty pages of a read_write mapping back to the file.
+        auto flush() const -> void
+        {
+            if (not empty() and ::msync(region.get(), size(), MS_SYNC) == -1)
+            {
+                impl::mapped_file::fail("jpl::mapped_file: msync");
+            }
+        };
+        auto close() noexcept -> void
+        {
+            region.reset();
+        };
+
+    private:
+        auto map(int file, size_t size, mode access) -> void
+        {
+            this->access = access;
+            // mmap rejects empty lengths; an empty file is an empty mapping.
+            if (size == 0)
+            {
+                return;
+            }
+            const int protection = access == mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            int flags = access == mode::read_write ? MAP_SHARED : MAP_PRIVATE;
+            if (file == -1)
+            {
+                flags |= MAP_ANONYMOUS;
+#if defined(MAP_NORESERVE)
+                flags |= MAP_NORESERVE;
+#endif
+            }
+            void* address = ::mmap(nullptr, size, protection, flags, file, 0);
+            if (address == MAP_FAILED)
+            {
+                impl::mapped_file::fail("jpl::mapped_file: mmap");
+            }
+            region = unique_ptr<byte, impl::mapped_file::unmap>{ static_cast<byte*>(address), impl::mapped_file::unmap{ size } };
+        };
+
+        static auto advice_flag(hint advice) noexcept -> int
+        {
+            switch (advice)
+            {
+            case hint::normal:
+                return MADV_NORMAL;
+            case hint::sequential:
+                return MADV_SEQUENTIAL;
+            case hint::random:
+                return MADV_RANDOM;
+            case hint::willneed:
+                return MADV_WILLNEED;
+            case hint::dontneed:
+                return MADV_DONTNEED;
+            case hint::hugepage:
+#if defined(MADV_HUGEPAGE)
+                return MADV_HUGEPAGE;
+#else
+                return -1;
+#endif
+            }
+            return -1;
+        };
+
+        unique_ptr<byte, impl::mapped_file::unmap> region;
+        mode access = mode::read_only;
+    };
+
+    // a bump allocating memory_resource over a writable mapping. allocation is
+    // a pointer increment; individual deallocation is a no-op and everything is
+    // handed back at once by release(). backed by a file, the arena's contents
+    // live in the page cache rather than anonymous memory.
+    struct mapped_arena : memory_resource
+    {
+        explicit mapped_arena(mapped_file file) noexcept :
+            file{ jpl::move(file) }
+        {};
+        explicit mapped_arena(size_t capacity) :
+            file{ mapped_file::anonymous(capacity) }
+        {};
+        mapped_arena(const mapped_arena&) = delete;
+        auto operator =(const mapped_arena&) -> mapped_arena& = delete;
+        mapped_arena(mapped_arena&& other) noexcept :
+            file{ jpl::move(other.file) },
+            offset{ jpl::exchange(other.offset, 0) }
+        {};
+        auto operator =(mapped_arena&& other) noexcept -> mapped_arena&
+        {
+            file = jpl::move(other.file);
+            offset = jpl::exchange(other.offset, 0);
+            return *this;
+        };
+
+        auto release() noexcept -> void
+        {
+            offset = 0;
+        };
+
+        [[nodiscard]] auto used() const noexcept -> size_t
+        {
+            return offset;
+        };
+        [[nodiscard]] auto capacity() const noexcept -> size_t
+        {
+            return file.size();
+        };
+        [[nodiscard]] auto mapping() noexcept -> mapped_file&
+        {
+            return file;
+        };
+
+    private:
+        // throws std::bad_alloc once the mapping is exhausted; the arena never
+        // grows, since growing would move memory already handed out.
+        auto do_allocate(size_t bytes, size_t alignment) -> void* override
+        {
+            // the mapping is page aligned, so aligning the offset aligns the
+            // address for anything up to a page.
+            const size_t start = (offset + alignment - 1) & ~(alignment - 1);
+            if (start > file.size() or bytes > file.size() - start)
+            {
+                throw std::bad_alloc{};
+            }
+            offset = start + bytes;
+            return file.writable_bytes().data() + start;
+        };
+        auto do_deallocate(void*, size_t, size_t) -> void override
+        {};
+        auto do_is_equal(const memory_resource& other) const noexcept -> bool override
+        {
+            return this == &other;
+        };
+
+        mapped_file file;
+        size_t offset = 0;
+    };
+};
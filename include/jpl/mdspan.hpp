@@ -0,0 +1,516 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "span.hpp"
+#include "type_traits.hpp"
+
+#include <array>
+#include <utility>
+
+// extents
+// dextents
+// layout_right
+// layout_left
+// layout_stride
+// default_accessor
+// mdspan
+namespace jpl
+{
+    template <typename IndexType, size_t... Extents>
+    struct extents;
+
+    namespace impl
+    {
+        namespace mdspan
+        {
+            // the runtime extents; nothing at all when every extent is static.
+            template <typename IndexType, size_t Count>
+            struct dynamic_values
+            {
+                constexpr auto operator [](size_t i) noexcept -> IndexType&
+                {
+                    return values[i];
+                };
+                constexpr auto operator [](size_t i) const noexcept -> IndexType
+                {
+                    return values[i];
+                };
+
+                IndexType values[Count]{};
+            };
+            template <typename IndexType>
+            struct dynamic_values<IndexType, 0>
+            {
+                constexpr auto operator [](size_t) const noexcept -> IndexType
+                {
+                    return 0;
+                };
+            };
+
+            template <typename IndexType, typename Sequence>
+            struct dextents;
+            template <typename IndexType, size_t... I>
+            struct dextents<IndexType, std::index_sequence<I...>>
+            {
+                using type = jpl::extents<IndexType, ((void)I, dynamic_extent)...>;
+            };
+
+            template <typename E>
+            constexpr auto product(const E& extents, size_t first, size_t last) noexcept -> typename E::index_type
+            {
+                typename E::index_type result = 1;
+                for (size_t r = first; r < last; ++r)
+                {
+                    result *= extents.extent(r);
+                }
+                return result;
+            };
+        };
+    };
+
+    // the shape of a multidimensional index space. dimensions known at compile
+    // time take no storage; only the dynamic ones are kept.
+    template <typename IndexType, size_t... Extents>
+    struct extents
+    {
+        using index_type = IndexType;
+        using size_type = size_t;
+        using rank_type = size_t;
+
+        [[nodiscard]] static constexpr auto rank() noexcept -> rank_type
+        {
+            return sizeof...(Extents);
+        };
+        [[nodiscard]] static constexpr auto rank_dynamic() noexcept -> rank_type
+        {
+            return ((Extents == dynamic_extent ? 1 : 0) + ... + 0);
+        };
+        [[nodiscard]] static constexpr auto static_extent(rank_type r) noexcept -> size_t
+        {
+            constexpr size_t values[] = { Extents..., 0 };
+            return values[r];
+        };
+
+        constexpr extents() noexcept = default;
+        // either every dynamic extent, or every extent with the static ones
+        // repeated.
+        template <typename... I>
+        requires (sizeof...(I) != 0 and (sizeof...(I) == rank_dynamic() or sizeof...(I) == rank()) and (is_convertible_v<I, index_type> and ...))
+        constexpr explicit extents(I... values) noexcept
+        {
+            const index_type given[] = { static_cast<index_type>(values)... };
+            if constexpr (sizeof...(I) == rank_dynamic())
+            {
+                for (rank_type r = 0; r < rank_dynamic(); ++r)
+                {
+                    dynamic[r] = given[r];
+                }
+            }
+            else
+            {
+                if constexpr (rank_dynamic() != 0)
+                {
+                    for (rank_type r = 0; r < rank(); ++r)
+                    {
+                        if (static_extent(r) == dynamic_extent)
+                        {
+                            dynamic[dynamic_index(r)] = given[r];
+                        }
+                    }
+                }
+            }
+        };
+
+        [[nodiscard]] constexpr auto extent(rank_type r) const noexcept -> index_type
+        {
+            if (static_extent(r) != dynamic_extent)
+            {
+                return static_cast<index_type>(static_extent(r));
+            }
+            return dynamic[dynamic_index(r)];
+        };
+
+        template <typename OtherIndex, size_t... OtherExtents>
+        friend constexpr auto operator ==(const extents& left, const extents<OtherIndex, OtherExtents...>& right) noexcept -> bool
+        {
+            if constexpr (rank() != sizeof...(OtherExtents))
+            {
+                return false;
+            }
+            else
+            {
+                for (rank_type r = 0; r < rank(); ++r)
+                {
+                    if (static_cast<size_t>(left.extent(r)) != static_cast<size_t>(right.extent(r)))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        };
+
+    private:
+        static constexpr auto dynamic_index(rank_type r) noexcept -> rank_type
+        {
+            rank_type index = 0;
+            for (rank_type i = 0; i < r; ++i)
+            {
+                index += static_extent(i) == dynamic_extent ? 1 : 0;
+            }
+            return index;
+        };
+
+        [[no_unique_address]] impl::mdspan::dynamic_values<index_type, rank_dynamic()> dynamic;
+    };
+
+    template <typename IndexType, size_t Rank>
+    using dextents = typename impl::mdspan::dextents<IndexType, std::make_index_sequence<Rank>>::type;
+
+    // row major: the last index is contiguous.
+    struct layout_right
+    {
+        template <typename Extents>
+        struct mapping
+        {
+            using extents_type = Extents;
+            using index_type = typename Extents::index_type;
+            using rank_type = typename Extents::rank_type;
+            using layout_type = layout_right;
+
+            constexpr mapping() noexcept = default;
+            constexpr mapping(const extents_type& extents) noexcept :
+                shape{ extents }
+            {};
+
+            [[nodiscard]] constexpr auto extents() const noexcept -> const extents_type&
+            {
+                return shape;
+            };
+            [[nodiscard]] constexpr auto required_span_size() const noexcept -> index_type
+            {
+                return impl::mdspan::product(shape, 0, Extents::rank());
+            };
+            template <typename... I>
+            requires (sizeof...(I) == Extents::rank())
+            [[nodiscard]] constexpr auto operator ()(I... indices) const noexcept -> index_type
+            {
+                index_type offset = 0;
+                rank_type r = 0;
+                ((offset = offset * (r == 0 ? 1 : shape.extent(r)) + static_cast<index_type>(indices), ++r), ...);
+                return offset;
+            };
+            [[nodiscard]] constexpr auto stride(rank_type r) const noexcept -> index_type
+            {
+                return impl::mdspan::product(shape, r + 1, Extents::rank());
+            };
+
+            [[nodiscard]] static constexpr auto is_always_unique() noexcept -> bool
+            {
+                return true;
+            };
+            [[nodiscard]] static constexpr auto is_always_exhaustive() noexcept -> bool
+            {
+                return true;
+            };
+            [[nodiscard]] static constexpr auto is_always_strided() noexcept -> bool
+            {
+                return true;
+            };
+
+            friend constexpr auto operator ==(const mapping& left, const mapping& right) noexcept -> bool
+            {
+                return left.shape == right.shape;
+            };
+
+        private:
+            [[no_unique_address]] extents_type shape;
+        };
+    };
+
+    // column major: the first index is contiguous.
+    struct layout_left
+    {
+        template <typename Extents>
+        struct mapping
+        {
+            using extents_type = Extents;
+            using index_type = typename Extents::index_type;
+            using rank_type = typename Extents::rank_type;
+            using layout_type = layout_left;
+
+            constexpr mapping() noexcept = default;
+            constexpr mapping(const extents_type& extents) noexcept :
+                shape{ extents }
+            {};
+
+            [[nodiscard]] constexpr auto extents() const noexcept -> const extents_type&
+            {
+                return shape;
+            };
+            [[nodiscard]] constexpr auto required_span_size() const noexcept -> index_type
+            {
+                return impl::mdspan::product(shape, 0, Extents::rank());
+            };
+            template <typename... I>
+            requires (sizeof...(I) == Extents::rank())
+            [[nodiscard]] constexpr auto operator ()(I... indices) const noexcept -> index_type
+            {
+                const index_type values[] = { static_cast<index_type>(indices)..., 0 };
+                index_type offset = 0;
+                for (rank_type r = Extents::rank(); r-- > 0;)
+                {
+                    offset = offset * shape.extent(r) + values[r];
+                }
+                return offset;
+            };
+            [[nodiscard]] constexpr auto stride(rank_type r) const noexcept -> index_type
+            {
+                return impl::mdspan::product(shape, 0, r);
+            };
+
+            [[nodiscard]] static constexpr auto is_always_unique() noexcept -> bool
+            {
+                return true;
+            };
+            [[nodiscard]] static constexpr auto is_always_exhaustive() noexcept -> bool
+            {
+                return true;
+            };
+            [[nodiscard]] static constexpr auto is_always_strided() noexcept -> bool
+            {
+                return true;
+            };
+
+            friend constexpr auto operator ==(const mapping& left, const mapping& right) noexcept -> bool
+            {
+                return left.shape == right.shape;
+            };
+
+        private:
+            [[no_unique_address]] extents_type shape;
+        };
+    };
+
+    // arbitrary per-dimension strides, e.g. a tile inside a larger matrix.
+    struct layout_stride
+    {
+        template <typename Extents>
+        struct mapping
+        {
+            using extents_type = Extents;
+            using index_type = typename Extents::index_type;
+            using rank_type = typename Extents::rank_type;
+            using layout_type = layout_stride;
+            using strides_type = std::array<index_type, Extents::rank()>;
+
+            constexpr mapping() noexcept = default;
+            template <typename S>
+            requires is_convertible_v<const S&, index_type>
+            constexpr mapping(const extents_type& extents, const std::array<S, Extents::rank()>& strides) noexcept :
+                shape{ extents }
+            {
+                for (rank_type r = 0; r < Extents::rank(); ++r)
+                {
+                    steps[r] = static_cast<index_type>(strides[r]);
+                }
+            };
+            // the strides of any other strided mapping, e.g. layout_right.
+            template <typename Mapping>
+            requires (Mapping::is_always_strided() and is_same_v<typename Mapping::extents_type, Extents>)
+            constexpr explicit mapping(const Mapping& other) noexcept :
+                shape{ other.extents() }
+            {
+                for (rank_type r = 0; r < Extents::rank(); ++r)
+                {
+                    steps[r] = other.stride(r);
+                }
+            };
+
+            [[nodiscard]] constexpr auto extents() const noexcept -> const extents_type&
+            {
+                return shape;
+            };
+            [[nodiscard]] constexpr auto strides() const noexcept -> const strides_type&
+            {
+                return steps;
+            };
+            [[nodiscard]] constexpr auto required_span_size() const noexcept -> index_type
+            {
+                index_type size = 1;
+                for (rank_type r = 0; r < Extents::rank(); ++r)
+                {
+                    if (shape.extent(r) == 0)
+                    {
+                        return 0;
+                    }
+                    size += (shape.extent(r) - 1) * steps[r];
+                }
+                return size;
+            };
+            template <typename... I>
+            requires (sizeof...(I) == Extents::rank())
+            [[nodiscard]] constexpr auto operator ()(I... indices) const noexcept -> index_type
+            {
+                index_type offset = 0;
+                rank_type r = 0;
+                ((offset += static_cast<index_type>(indices) * steps[r++]), ...);
+                return offset;
+            };
+            [[nodiscard]] constexpr auto stride(rank_type r) const noexcept -> index_type
+            {
+                return steps[r];
+            };
+
+            [[nodiscard]] static constexpr auto is_always_unique() noexcept -> bool
+            {
+                return true;
+            };
+            [[nodiscard]] static constexpr auto is_always_exhaustive() noexcept -> bool
+            {
+                return false;
+            };
+            [[nodiscard]] static constexpr auto is_always_strided() noexcept -> bool
+            {
+                return true;
+            };
+
+            friend constexpr auto operator ==(const mapping& left, const mapping& right) noexcept -> bool
+            {
+                return left.shape == right.shape and left.steps == right.steps;
+            };
+
+        private:
+            [[no_unique_address]] extents_type shape;
+            strides_type steps{};
+        };
+    };
+
+    template <typename T>
+    struct default_accessor
+    {
+        using offset_policy = default_accessor;
+        using element_type = T;
+        using reference = T&;
+        using data_handle_type = T*;
+
+        constexpr default_accessor() noexcept = default;
+        template <typename U>
+        requires is_convertible_v<U(*)[], T(*)[]>
+        constexpr default_accessor(default_accessor<U>) noexcept
+        {};
+
+        [[nodiscard]] constexpr auto access(data_handle_type pointer, size_t i) const noexcept -> reference
+        {
+            return pointer[i];
+        };
+        [[nodiscard]] constexpr auto offset(data_handle_type pointer, size_t i) const noexcept -> data_handle_type
+        {
+            return pointer + i;
+        };
+    };
+
+    // a non-owning multidimensional view: a data handle, a layout mapping from
+    // indices to offsets, and an accessor from offsets to elements.
+    template <typename T, typename Extents, typename Layout = layout_right, typename Accessor = default_accessor<T>>
+    struct mdspan
+    {
+        using extents_type = Extents;
+        using layout_type = Layout;
+        using accessor_type = Accessor;
+        using mapping_type = typename Layout::template mapping<Extents>;
+        using element_type = T;
+        using value_type = remove_cv_t<T>;
+        using index_type = typename Extents::index_type;
+        using size_type = typename Extents::size_type;
+        using rank_type = typename Extents::rank_type;
+        using data_handle_type = typename Accessor::data_handle_type;
+        using reference = typename Accessor::reference;
+
+        constexpr mdspan() = default;
+        constexpr explicit mdspan(data_handle_type pointer) requires (Extents::rank_dynamic() == 0) :
+            handle{ pointer }
+        {};
+        template <typename... I>
+        requires (sizeof...(I) != 0 and (is_convertible_v<I, index_type> and ...))
+        constexpr explicit mdspan(data_handle_type pointer, I... extents) :
+            handle{ pointer },
+            index_mapping{ extents_type{ static_cast<index_type>(extents)... } }
+        {};
+        constexpr mdspan(data_handle_type pointer, const extents_type& extents) :
+            handle{ pointer },
+            index_mapping{ extents }
+        {};
+        constexpr mdspan(data_handle_type pointer, const mapping_type& mapping, const accessor_type& accessor = accessor_type{}) :
+            handle{ pointer },
+            index_mapping{ mapping },
+            element_accessor{ accessor }
+        {};
+
+        [[nodiscard]] static constexpr auto rank() noexcept -> rank_type
+        {
+            return Extents::rank();
+        };
+        [[nodiscard]] static constexpr auto rank_dynamic() noexcept -> rank_type
+        {
+            return Extents::rank_dynamic();
+        };
+        [[nodiscard]] static constexpr auto static_extent(rank_type r) noexcept -> size_t
+        {
+            return Extents::static_extent(r);
+        };
+        [[nodiscard]] constexpr auto extent(rank_type r) const noexcept -> index_type
+        {
+            return index_mapping.extents().extent(r);
+        };
+        [[nodiscard]] constexpr auto stride(rank_type r) const -> index_type
+        {
+            return index_mapping.stride(r);
+        };
+        [[nodiscard]] constexpr auto size() const noexcept -> size_type
+        {
+            return static_cast<size_type>(impl::mdspan::product(index_mapping.extents(), 0, rank()));
+        };
+        [[nodiscard]] constexpr auto empty() const noexcept -> bool
+        {
+            return size() == 0;
+        };
+
+        template <typename... I>
+        requires (sizeof...(I) == Extents::rank() and (is_convertible_v<I, index_type> and ...))
+        [[nodiscard]] constexpr auto operator [](I... indices) const -> reference
+        {
+            return element_accessor.access(handle, static_cast<size_t>(index_mapping(static_cast<index_type>(indices)...)));
+        };
+
+        [[nodiscard]] constexpr auto data_handle() const noexcept -> const data_handle_type&
+        {
+            return handle;
+        };
+        [[nodiscard]] constexpr auto mapping() const noexcept -> const mapping_type&
+        {
+            return index_mapping;
+        };
+        [[nodiscard]] constexpr auto accessor() const noexcept -> const accessor_type&
+        {
+            return element_accessor;
+        };
+        [[nodiscard]] constexpr auto extents() const noexcept -> const extents_type&
+        {
+            return index_mapping.extents();
+        };
+
+    private:
+        data_handle_type handle{};
+        [[no_unique_address]] mapping_type index_mapping;
+        [[no_unique_address]] accessor_type element_accessor;
+    };
+
+    template <typename T, typename... I>
+    requires (sizeof...(I) != 0 and (is_convertible_v<I, size_t> and ...))
+    mdspan(T*, I...) -> mdspan<T, dextents<size_t, sizeof...(I)>>;
+    template <typename T, typename IndexType, size_t... Extents>
+    mdspan(T*, const extents<IndexType, Extents...>&) -> mdspan<T, extents<IndexType, Extents...>>;
+    template <typename T, typename Mapping>
+    mdspan(T*, const Mapping&) -> mdspan<T, typename Mapping::extents_type, typename Mapping::layout_type>;
+};
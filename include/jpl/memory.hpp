@@ -1,6 +1,7 @@
 #pragma once
 
 #include "type_traits.hpp"
+#include "utility.hpp"
 
 namespace jpl
 {
@@ -8,7 +9,7 @@ namespace jpl
     requires requires { ::new(declval<void*>()) T(declval<As>()...); }
     constexpr auto construct_at(T* pointer, As&&... arguments) -> T*
     {
-        return ::new (static_cast<void*>(pointer)) T(forward<As>(arguments)...);
+        return ::new (static_cast<void*>(pointer)) T(jpl::forward<As>(arguments)...);
     };
 
     template <typename T>
@@ -107,29 +108,29 @@ namespace jpl
 
         constexpr unique_ptr(pointer data, const deleter_type& deleter) noexcept
         requires impl::unique_ptr::nonreference_deleter_copy<deleter_type, decltype(deleter)> :
-            data{ data, forward<decltype(deleter)>(deleter) }
+            data{ data, jpl::forward<decltype(deleter)>(deleter) }
         {};
         constexpr unique_ptr(pointer data, deleter_type&& deleter) noexcept
         requires impl::unique_ptr::nonreference_deleter_move<deleter_type, decltype(deleter)> :
-            data{ data, forward<decltype(deleter)>(deleter) }
+            data{ data, jpl::forward<decltype(deleter)>(deleter) }
         {};
         constexpr unique_ptr(pointer data, deleter_type& deleter) noexcept
         requires impl::unique_ptr::nonconst_reference_deleter<deleter_type, decltype(deleter)> :
-            data{ data, forward<decltype(deleter)>(deleter) }
+            data{ data, jpl::forward<decltype(deleter)>(deleter) }
         {};
         constexpr unique_ptr(pointer data, remove_reference_t<deleter_type>&& deleter) noexcept
         requires impl::unique_ptr::nonconst_reference_deleter<deleter_type, decltype(deleter)>
         = delete;
         constexpr unique_ptr(pointer data, const deleter_type& deleter) noexcept
         requires impl::unique_ptr::const_reference_deleter<deleter_type, decltype(deleter)> :
-            data{ data, forward<decltype(deleter)>(deleter) }
+            data{ data, jpl::forward<decltype(deleter)>(deleter) }
         {};
         constexpr unique_ptr(pointer data, const remove_reference_t<deleter_type>&& deleter) noexcept
         requires impl::unique_ptr::const_reference_deleter<deleter_type, decltype(deleter)>
         = delete;
         constexpr unique_ptr(unique_ptr&& other) noexcept
         requires impl::unique_ptr::move_constructible<deleter_type> :
-            data{ other.data.first, forward<deleter_type>(other.data.second) }
+            data{ other.data.first, jpl::forward<deleter_type>(other.data.second) }
         {
             other.data.first = nullptr;
         };
@@ -150,11 +151,19 @@ namespace jpl
                  impl::unique_ptr::convertible_pointers<unique_ptr, unique_ptr<U, E>> and
                  impl::unique_ptr::not_array<U> and
                  impl::unique_ptr::compatible_deleters<deleter_type, E> :
-            data{ other.data.first, move(other.data.second) }
+            data{ other.data.first, jpl::move(other.data.second) }
         {
             other.data.first = nullptr;
         };
         unique_ptr(const unique_ptr&) = delete;
+        auto operator =(const unique_ptr&) -> unique_ptr& = delete;
+        constexpr auto operator =(unique_ptr&& other) noexcept -> unique_ptr&
+        requires (not is_reference_v<deleter_type>)
+        {
+            reset(other.release());
+            data.second = jpl::move(other.data.second);
+            return *this;
+        };
 
         constexpr ~unique_ptr()
         {
@@ -163,6 +172,48 @@ namespace jpl
                 data.second(data.first);
             }
         };
+
+        constexpr auto release() noexcept -> pointer
+        {
+            pointer old = data.first;
+            data.first = nullptr;
+            return old;
+        };
+        constexpr auto reset(pointer replacement = pointer{}) noexcept -> void
+        {
+            pointer old = data.first;
+            data.first = replacement;
+            if (old != nullptr)
+            {
+                data.second(old);
+            }
+        };
+
+        constexpr auto get() const noexcept -> pointer
+        {
+            return data.first;
+        };
+        constexpr auto get_deleter() noexcept -> deleter_type&
+        {
+            return data.second;
+        };
+        constexpr auto get_deleter() const noexcept -> const deleter_type&
+        {
+            return data.second;
+        };
+        constexpr explicit operator bool() const noexcept
+        {
+            return data.first != nullptr;
+        };
+
+        constexpr auto operator *() const -> add_lvalue_reference_t<T>
+        {
+            return *data.first;
+        };
+        constexpr auto operator ->() const noexcept -> pointer
+        {
+            return data.first;
+        };
     };
     template <typename T, typename D>
     struct unique_ptr<T[], D>
@@ -0,0 +1,638 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "memory.hpp"
+#include "new.hpp"
+#include "spinlock.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <new>
+
+// memory_resource
+// new_delete_resource
+// null_memory_resource
+// get_default_resource
+// set_default_resource
+// pool_options
+// monotonic_buffer_resource
+// unsynchronized_pool_resource
+// synchronized_pool_resource
+// polymorphic_allocator
+// resource_delete
+// allocate_unique
+namespace jpl
+{
+    // an abstract source of memory. code that takes a memory_resource* can be
+    // pointed at the heap, an arena or a pool at runtime without changing type.
+    struct memory_resource
+    {
+        memory_resource() noexcept = default;
+        memory_resource(const memory_resource&) noexcept = default;
+        auto operator =(const memory_resource&) noexcept -> memory_resource& = default;
+        virtual ~memory_resource() = default;
+
+        [[nodiscard]] auto allocate(size_t bytes, size_t alignment = alignof(max_align_t)) -> void*
+        {
+            return do_allocate(bytes, alignment);
+        };
+        auto deallocate(void* pointer, size_t bytes, size_t alignment = alignof(max_align_t)) -> void
+        {
+            do_deallocate(pointer, bytes, alignment);
+        };
+        // whether memory from one may be returned to the other.
+        [[nodiscard]] auto is_equal(const memory_resource& other) const noexcept -> bool
+        {
+            return do_is_equal(other);
+        };
+
+        friend auto operator ==(const memory_resource& left, const memory_resource& right) noexcept -> bool
+        {
+            return &left == &right or left.is_equal(right);
+        };
+
+    private:
+        virtual auto do_allocate(size_t bytes, size_t alignment) -> void* = 0;
+        virtual auto do_deallocate(void* pointer, size_t bytes, size_t alignment) -> void = 0;
+        virtual auto do_is_equal(const memory_resource& other) const noexcept -> bool = 0;
+    };
+
+    namespace impl
+    {
+        namespace memory_resource
+        {
+            struct new_delete_resource final : jpl::memory_resource
+            {
+            private:
+                auto do_allocate(size_t bytes, size_t alignment) -> void* override
+                {
+                    return ::operator new(bytes, std::align_val_t{ alignment });
+                };
+                auto do_deallocate(void* pointer, size_t bytes, size_t alignment) -> void override
+                {
+                    ::operator delete(pointer, bytes, std::align_val_t{ alignment });
+                };
+                auto do_is_equal(const jpl::memory_resource& other) const noexcept -> bool override
+                {
+                    return this == &other;
+                };
+            };
+            struct null_memory_resource final : jpl::memory_resource
+            {
+            private:
+                auto do_allocate(size_t, size_t) -> void* override
+                {
+                    throw std::bad_alloc{};
+                };
+                auto do_deallocate(void*, size_t, size_t) -> void override
+                {};
+                auto do_is_equal(const jpl::memory_resource& other) const noexcept -> bool override
+                {
+                    return this == &other;
+                };
+            };
+
+            inline auto new_delete() noexcept -> jpl::memory_resource*
+            {
+                static new_delete_resource instance;
+                return &instance;
+            };
+            inline auto default_resource() noexcept -> std::atomic<jpl::memory_resource*>&
+            {
+                static std::atomic<jpl::memory_resource*> instance{ new_delete() };
+                return instance;
+            };
+
+            constexpr auto align_up(size_t value, size_t alignment) noexcept -> size_t
+            {
+                return (value + alignment - 1) & ~(alignment - 1);
+            };
+        };
+    };
+
+    // ::operator new and ::operator delete, honouring the alignment.
+    inline auto new_delete_resource() noexcept -> memory_resource*
+    {
+        return impl::memory_resource::new_delete();
+    };
+    // throws std::bad_alloc on every allocation; an upstream that turns running
+    // out of a fixed buffer into an error.
+    inline auto null_memory_resource() noexcept -> memory_resource*
+    {
+        static impl::memory_resource::null_memory_resource instance;
+        return &instance;
+    };
+    inline auto get_default_resource() noexcept -> memory_resource*
+    {
+        return impl::memory_resource::default_resource().load(std::memory_order_acquire);
+    };
+    // a null resource restores new_delete_resource(). returns the previous one.
+    inline auto set_default_resource(memory_resource* resource) noexcept -> memory_resource*
+    {
+        return impl::memory_resource::default_resource().exchange(resource != nullptr ? resource : new_delete_resource(), std::memory_order_acq_rel);
+    };
+
+    // a bump allocator: allocation is a pointer increment, deallocation does
+    // nothing, and everything goes back upstream on release() or destruction.
+    // an initial buffer is used first; further chunks grow geometrically.
+    struct monotonic_buffer_resource : memory_resource
+    {
+        static constexpr size_t default_chunk_size = 1024;
+
+        explicit monotonic_buffer_resource(memory_resource* upstream = get_default_resource()) noexcept :
+            upstream{ upstream }
+        {};
+        monotonic_buffer_resource(size_t chunk_size, memory_resource* upstream = get_default_resource()) noexcept :
+            upstream{ upstream },
+            next_size{ chunk_size > 0 ? chunk_size : 1 }
+        {};
+        monotonic_buffer_resource(void* buffer, size_t buffer_size, memory_resource* upstream = get_default_resource()) noexcept :
+            upstream{ upstream },
+            initial_buffer{ static_cast<byte*>(buffer) },
+            initial_size{ buffer_size },
+            cursor{ static_cast<byte*>(buffer) },
+            remaining{ buffer_size },
+            next_size{ buffer_size > 0 ? buffer_size * 2 : default_chunk_size }
+        {};
+        monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+        auto operator =(const monotonic_buffer_resource&) -> monotonic_buffer_resource& = delete;
+        ~monotonic_buffer_resource() override
+        {
+            release();
+        };
+
+        // returns every chunk upstream and starts over from the initial buffer.
+        auto release() noexcept -> void
+        {
+            while (chunks != nullptr)
+            {
+                chunk* current = chunks;
+                chunks = current->next;
+                upstream->deallocate(current->memory, current->bytes, current->alignment);
+            }
+            cursor = initial_buffer;
+            remaining = initial_size;
+            next_size = initial_size > 0 ? initial_size * 2 : default_chunk_size;
+        };
+        [[nodiscard]] auto upstream_resource() const noexcept -> memory_resource*
+        {
+            return upstream;
+        };
+
+    private:
+        // kept at the end of each chunk, so the chunk list needs no memory of
+        // its own.
+        struct chunk
+        {
+            void* memory;
+            size_t bytes;
+            size_t alignment;
+            chunk* next;
+        };
+
+        auto do_allocate(size_t bytes, size_t alignment) -> void* override
+        {
+            if (void* result = bump(bytes, alignment); result != nullptr)
+            {
+                return result;
+            }
+            const size_t usable = std::max(next_size, bytes + alignment);
+            const size_t total = impl::memory_resource::align_up(usable, alignof(chunk)) + sizeof(chunk);
+            const size_t chunk_alignment = std::max(alignment, alignof(chunk));
+            auto* memory = static_cast<byte*>(upstream->allocate(total, chunk_alignment));
+            chunks = ::new (static_cast<void*>(memory + total - sizeof(chunk))) chunk{ memory, total, chunk_alignment, chunks };
+            cursor = memory;
+            remaining = total - sizeof(chunk);
+            next_size = usable * 2;
+            return bump(bytes, alignment);
+        };
+        auto do_deallocate(void*, size_t, size_t) -> void override
+        {};
+        auto do_is_equal(const memory_resource& other) const noexcept -> bool override
+        {
+            return this == &other;
+        };
+
+        auto bump(size_t bytes, size_t alignment) noexcept -> void*
+        {
+            if (cursor == nullptr)
+            {
+                return nullptr;
+            }
+            const size_t padding = impl::memory_resource::align_up(reinterpret_cast<size_t>(cursor), alignment) - reinterpret_cast<size_t>(cursor);
+            if (padding > remaining or bytes > remaining - padding)
+            {
+                return nullptr;
+            }
+            byte* result = cursor + padding;
+            cursor = result + bytes;
+            remaining -= padding + bytes;
+            return result;
+        };
+
+        memory_resource* upstream;
+        byte* initial_buffer = nullptr;
+        size_t initial_size = 0;
+        byte* cursor = nullptr;
+        size_t remaining = 0;
+        size_t next_size = default_chunk_size;
+        chunk* chunks = nullptr;
+    };
+
+    // zero fields pick the defaults.
+    struct pool_options
+    {
+        size_t max_blocks_per_chunk = 0;
+        size_t largest_required_pool_block = 0;
+    };
+
+    namespace impl
+    {
+        namespace memory_resource
+        {
+            inline constexpr size_t smallest_block = 8;
+            inline constexpr size_t default_largest_block = 4096;
+            inline constexpr size_t maximum_largest_block = size_t{ 1 } << 20;
+            inline constexpr size_t default_max_blocks = 1024;
+            inline constexpr size_t first_chunk_blocks = 16;
+            inline constexpr size_t maximum_pools = std::bit_width(maximum_largest_block) - std::bit_width(smallest_block) + 1;
+
+            // blocks of one power-of-two size. chunks are aligned to the block
+            // size, so every block is aligned to its own size, and each chunk's
+            // bookkeeping sits past its last block.
+            struct pool
+            {
+                struct free_block
+                {
+                    free_block* next;
+                };
+                struct chunk
+                {
+                    void* memory;
+                    size_t bytes;
+                    chunk* next;
+                };
+
+                size_t block_size = 0;
+                size_t next_blocks = first_chunk_blocks;
+                free_block* free = nullptr;
+                byte* cursor = nullptr;
+                byte* limit = nullptr;
+                chunk* chunks = nullptr;
+
+                auto allocate(jpl::memory_resource* upstream, size_t max_blocks) -> void*
+                {
+                    if (free != nullptr)
+                    {
+                        return jpl::exchange(free, free->next);
+                    }
+                    if (cursor == limit)
+                    {
+                        grow(upstream, max_blocks);
+                    }
+                    return jpl::exchange(cursor, cursor + block_size);
+                };
+                auto deallocate(void* block) noexcept -> void
+                {
+                    free = ::new (block) free_block{ free };
+                };
+                auto release(jpl::memory_resource* upstream) noexcept -> void
+                {
+                    while (chunks != nullptr)
+                    {
+                        chunk* current = chunks;
+                        chunks = current->next;
+                        upstream->deallocate(current->memory, current->bytes, block_size);
+                    }
+                    free = nullptr;
+                    cursor = nullptr;
+                    limit = nullptr;
+                    next_blocks = first_chunk_blocks;
+                };
+
+            private:
+                auto grow(jpl::memory_resource* upstream, size_t max_blocks) -> void
+                {
+                    const size_t blocks_bytes = next_blocks * block_size;
+                    const size_t total = align_up(blocks_bytes, alignof(chunk)) + sizeof(chunk);
+                    auto* memory = static_cast<byte*>(upstream->allocate(total, block_size));
+                    chunks = ::new (static_cast<void*>(memory + total - sizeof(chunk))) chunk{ memory, total, chunks };
+                    cursor = memory;
+                    limit = memory + blocks_bytes;
+                    next_blocks = std::min(next_blocks * 2, max_blocks);
+                };
+            };
+
+            // allocations too large for any pool go straight upstream, behind a
+            // header linking them into a list so release() can find them.
+            struct oversized
+            {
+                oversized* previous;
+                oversized* next;
+                size_t bytes;
+                size_t alignment;
+            };
+
+            struct no_lock
+            {
+                auto lock() noexcept -> void
+                {};
+                auto unlock() noexcept -> void
+                {};
+            };
+
+            template <typename Lock>
+            struct pool_resource : jpl::memory_resource
+            {
+                pool_resource(const pool_options& options, jpl::memory_resource* upstream) noexcept :
+                    upstream{ upstream },
+                    options{ normalize(options) },
+                    pool_count{ static_cast<size_t>(std::bit_width(this->options.largest_required_pool_block) - std::bit_width(smallest_block) + 1) }
+                {
+                    for (size_t i = 0; i < pool_count; ++i)
+                    {
+                        classes[i].blocks.block_size = smallest_block << i;
+                    }
+                };
+                pool_resource(const pool_resource&) = delete;
+                auto operator =(const pool_resource&) -> pool_resource& = delete;
+                ~pool_resource() override
+                {
+                    release();
+                };
+
+                // returns every chunk and oversized block upstream, whether or
+                // not it was deallocated.
+                auto release() noexcept -> void
+                {
+                    for (size_t i = 0; i < pool_count; ++i)
+                    {
+                        classes[i].blocks.release(upstream);
+                    }
+                    while (large != nullptr)
+                    {
+                        oversized* current = large;
+                        large = current->next;
+                        const size_t header = header_size(current->alignment);
+                        upstream->deallocate(reinterpret_cast<byte*>(current) + sizeof(oversized) - header, current->bytes + header, current->alignment);
+                    }
+                };
+                [[nodiscard]] auto upstream_resource() const noexcept -> jpl::memory_resource*
+                {
+                    return upstream;
+                };
+                [[nodiscard]] auto pool_settings() const noexcept -> pool_options
+                {
+                    return options;
+                };
+
+            private:
+                static auto normalize(pool_options options) noexcept -> pool_options
+                {
+                    if (options.max_blocks_per_chunk == 0)
+                    {
+                        options.max_blocks_per_chunk = default_max_blocks;
+                    }
+                    options.max_blocks_per_chunk = std::max(options.max_blocks_per_chunk, first_chunk_blocks);
+                    if (options.largest_required_pool_block == 0)
+                    {
+                        options.largest_required_pool_block = default_largest_block;
+                    }
+                    options.largest_required_pool_block = std::bit_ceil(std::clamp(options.largest_required_pool_block, smallest_block, maximum_largest_block));
+                    return options;
+                };
+                static constexpr auto header_size(size_t alignment) noexcept -> size_t
+                {
+                    return align_up(sizeof(oversized), alignment);
+                };
+                // the pool whose blocks fit bytes at the given alignment.
+                auto pool_index(size_t bytes, size_t alignment) const noexcept -> size_t
+                {
+                    const size_t block = std::bit_ceil(std::max({ bytes, alignment, smallest_block }));
+                    return static_cast<size_t>(std::bit_width(block) - std::bit_width(smallest_block));
+                };
+
+                auto do_allocate(size_t bytes, size_t alignment) -> void* override
+                {
+                    if (const size_t index = pool_index(bytes, alignment); index < pool_count)
+                    {
+                        const lock_guard guard{ classes[index].lock };
+                        return classes[index].blocks.allocate(upstream, options.max_blocks_per_chunk);
+                    }
+                    alignment = std::max(alignment, alignof(oversized));
+                    const size_t header = header_size(alignment);
+                    auto* memory = static_cast<byte*>(upstream->allocate(bytes + header, alignment));
+                    auto* record = ::new (static_cast<void*>(memory + header - sizeof(oversized))) oversized{ nullptr, nullptr, bytes, alignment };
+                    const lock_guard guard{ large_lock };
+                    record->next = large;
+                    if (large != nullptr)
+                    {
+                        large->previous = record;
+                    }
+                    large = record;
+                    return memory + header;
+                };
+                auto do_deallocate(void* pointer, size_t bytes, size_t alignment) -> void override
+                {
+                    if (const size_t index = pool_index(bytes, alignment); index < pool_count)
+                    {
+                        const lock_guard guard{ classes[index].lock };
+                        classes[index].blocks.deallocate(pointer);
+                        return;
+                    }
+                    auto* record = reinterpret_cast<oversized*>(static_cast<byte*>(pointer) - sizeof(oversized));
+                    {
+                        const lock_guard guard{ large_lock };
+                        (record->previous != nullptr ? record->previous->next : large) = record->next;
+                        if (record->next != nullptr)
+                        {
+                            record->next->previous = record->previous;
+                        }
+                    }
+                    const size_t header = header_size(record->alignment);
+                    upstream->deallocate(static_cast<byte*>(pointer) - header, record->bytes + header, record->alignment);
+                };
+                auto do_is_equal(const jpl::memory_resource& other) const noexcept -> bool override
+                {
+                    return this == &other;
+                };
+
+                struct lock_guard
+                {
+                    Lock& lock;
+
+                    explicit lock_guard(Lock& lock) noexcept :
+                        lock{ lock }
+                    {
+                        lock.lock();
+                    };
+                    ~lock_guard()
+                    {
+                        lock.unlock();
+                    };
+                };
+
+                jpl::memory_resource* upstream;
+                pool_options options;
+                size_t pool_count;
+                // a size class beside its lock. with a real lock each class gets
+                // cache lines of its own, so threads allocating different sizes
+                // do not contend; without one, padding would only waste space.
+                struct alignas(is_empty_v<Lock> ? alignof(pool) : hardware_destructive_interference_size) size_class
+                {
+                    pool blocks;
+                    [[no_unique_address]] Lock lock;
+                };
+                size_class classes[maximum_pools];
+                [[no_unique_address]] Lock large_lock;
+                oversized* large = nullptr;
+            };
+        };
+    };
+
+    // power-of-two size classes, each a free list over chunks taken from
+    // upstream. not thread safe.
+    struct unsynchronized_pool_resource : impl::memory_resource::pool_resource<impl::memory_resource::no_lock>
+    {
+        unsynchronized_pool_resource() noexcept :
+            unsynchronized_pool_resource{ pool_options{}, get_default_resource() }
+        {};
+        explicit unsynchronized_pool_resource(memory_resource* upstream) noexcept :
+            unsynchronized_pool_resource{ pool_options{}, upstream }
+        {};
+        explicit unsynchronized_pool_resource(const pool_options& options, memory_resource* upstream = get_default_resource()) noexcept :
+            pool_resource{ options, upstream }
+        {};
+    };
+    // the same pools with a spinlock per size class. upstream must be thread
+    // safe itself.
+    struct synchronized_pool_resource : impl::memory_resource::pool_resource<spinlock>
+    {
+        synchronized_pool_resource() noexcept :
+            synchronized_pool_resource{ pool_options{}, get_default_resource() }
+        {};
+        explicit synchronized_pool_resource(memory_resource* upstream) noexcept :
+            synchronized_pool_resource{ pool_options{}, upstream }
+        {};
+        explicit synchronized_pool_resource(const pool_options& options, memory_resource* upstream = get_default_resource()) noexcept :
+            pool_resource{ options, upstream }
+        {};
+    };
+
+    // a std-style allocator over a memory_resource, so one container type can
+    // draw from whatever resource it is handed. containers copied from it use
+    // the default resource, as with std::pmr.
+    template <typename T = byte>
+    struct polymorphic_allocator
+    {
+        using value_type = T;
+
+        polymorphic_allocator() noexcept :
+            memory{ get_default_resource() }
+        {};
+        polymorphic_allocator(memory_resource* resource) noexcept :
+            memory{ resource }
+        {};
+        template <typename U>
+        polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept :
+            memory{ other.resource() }
+        {};
+        polymorphic_allocator(const polymorphic_allocator&) noexcept = default;
+        auto operator =(const polymorphic_allocator&) -> polymorphic_allocator& = delete;
+
+        [[nodiscard]] auto allocate(size_t count) -> T*
+        {
+            if (count > static_cast<size_t>(-1) / sizeof(T))
+            {
+                throw std::bad_array_new_length{};
+            }
+            return static_cast<T*>(memory->allocate(count * sizeof(T), alignof(T)));
+        };
+        auto deallocate(T* pointer, size_t count) -> void
+        {
+            memory->deallocate(pointer, count * sizeof(T), alignof(T));
+        };
+
+        [[nodiscard]] auto allocate_bytes(size_t bytes, size_t alignment = alignof(max_align_t)) -> void*
+        {
+            return memory->allocate(bytes, alignment);
+        };
+        auto deallocate_bytes(void* pointer, size_t bytes, size_t alignment = alignof(max_align_t)) -> void
+        {
+            memory->deallocate(pointer, bytes, alignment);
+        };
+        template <typename U, typename... As>
+        [[nodiscard]] auto new_object(As&&... arguments) -> U*
+        {
+            void* storage = memory->allocate(sizeof(U), alignof(U));
+            try
+            {
+                return ::new (storage) U(jpl::forward<As>(arguments)...);
+            }
+            catch (...)
+            {
+                memory->deallocate(storage, sizeof(U), alignof(U));
+                throw;
+            }
+        };
+        template <typename U>
+        auto delete_object(U* object) -> void
+        {
+            object->~U();
+            memory->deallocate(object, sizeof(U), alignof(U));
+        };
+
+        [[nodiscard]] auto select_on_container_copy_construction() const noexcept -> polymorphic_allocator
+        {
+            return polymorphic_allocator{};
+        };
+        [[nodiscard]] auto resource() const noexcept -> memory_resource*
+        {
+            return memory;
+        };
+
+        template <typename U>
+        friend auto operator ==(const polymorphic_allocator& left, const polymorphic_allocator<U>& right) noexcept -> bool
+        {
+            return *left.resource() == *right.resource();
+        };
+
+    private:
+        memory_resource* memory;
+    };
+
+    // destroys and returns an object to the resource it came from; the deleter
+    // of allocate_unique.
+    template <typename T>
+    struct resource_delete
+    {
+        resource_delete() noexcept :
+            memory{ get_default_resource() }
+        {};
+        explicit resource_delete(memory_resource* resource) noexcept :
+            memory{ resource }
+        {};
+
+        auto operator ()(T* object) const -> void
+        {
+            static_assert(sizeof(T) > 0, "T is an incomplete type.");
+            polymorphic_allocator<T>{ memory }.delete_object(object);
+        };
+        [[nodiscard]] auto resource() const noexcept -> memory_resource*
+        {
+            return memory;
+        };
+
+    private:
+        memory_resource* memory;
+    };
+
+    template <typename T, typename... As>
+    [[nodiscard]] auto allocate_unique(memory_resource* resource, As&&... arguments) -> unique_ptr<T, resource_delete<T>>
+    {
+        T* object = polymorphic_allocator<T>{ resource }.template new_object<T>(jpl::forward<As>(arguments)...);
+        return unique_ptr<T, resource_delete<T>>{ object, resource_delete<T>{ resource } };
+    };
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "cstddef.hpp"
+
+// hardware_destructive_interference_size
+// hardware_constructive_interference_size
+namespace jpl
+{
+    // the distance two independently written objects need between them to
+    // never share a line. x86-64 prefetches lines in adjacent pairs and
+    // aarch64 and power parts have 128-byte lines, so those get two 64-byte
+    // lines' worth.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || defined(_M_ARM64) || defined(__powerpc64__)
+    inline constexpr size_t hardware_destructive_interference_size = 128;
+#else
+    inline constexpr size_t hardware_destructive_interference_size = 64;
+#endif
+    // the most that data read together should span to share a line.
+    inline constexpr size_t hardware_constructive_interference_size = 64;
+};
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <vector>
+
+// fixed_pool
+// object_pool
+namespace jpl
+{
+    // hands out blocks of one size carved from geometrically growing slabs, and
+    // recycles freed blocks through an intrusive free list. not thread safe.
+    // memory goes back to the system only on release() or destruction.
+    struct fixed_pool
+    {
+        static constexpr size_t first_slab_blocks = 16;
+        static constexpr size_t maximum_slab_bytes = size_t{ 1 } << 20;
+
+        explicit fixed_pool(size_t block_size, size_t alignment = alignof(max_align_t)) noexcept :
+            block_size{ round_up(std::max(block_size, sizeof(free_block)), std::max(alignment, alignof(free_block))) },
+            alignment{ std::max(alignment, alignof(free_block)) }
+        {};
+        fixed_pool(const fixed_pool&) = delete;
+        auto operator =(const fixed_pool&) -> fixed_pool& = delete;
+        fixed_pool(fixed_pool&& other) noexcept :
+            block_size{ other.block_size },
+            alignment{ other.alignment },
+            next_slab_blocks{ jpl::exchange(other.next_slab_blocks, first_slab_blocks) },
+            free{ jpl::exchange(other.free, nullptr) },
+            cursor{ jpl::exchange(other.cursor, nullptr) },
+            limit{ jpl::exchange(other.limit, nullptr) },
+            slabs{ jpl::move(other.slabs) }
+        {
+            other.slabs.clear();
+        };
+        auto operator =(fixed_pool&& other) noexcept -> fixed_pool&
+        {
+            if (this != &other)
+            {
+                release();
+                block_size = other.block_size;
+                alignment = other.alignment;
+                next_slab_blocks = jpl::exchange(other.next_slab_blocks, first_slab_blocks);
+                free = jpl::exchange(other.free, nullptr);
+                cursor = jpl::exchange(other.cursor, nullptr);
+                limit = jpl::exchange(other.limit, nullptr);
+                slabs = jpl::move(other.slabs);
+                other.slabs.clear();
+            }
+            return *this;
+        };
+        ~fixed_pool()
+        {
+            release();
+        };
+
+        [[nodiscard]] auto allocate() -> void*
+        {
+            if (free != nullptr)
+            {
+                return jpl::exchange(free, free->next);
+            }
+            if (cursor == limit)
+            {
+                grow();
+            }
+            return jpl::exchange(cursor, cursor + block_size);
+        };
+        auto deallocate(void* block) noexcept -> void
+        {
+            free = ::new (block) free_block{ free };
+        };
+
+        // frees every slab at once; outstanding blocks become dangling.
+        auto release() noexcept -> void
+        {
+            for (const auto& slab : slabs)
+            {
+                ::operator delete(slab.memory, slab.bytes, std::align_val_t{ alignment });
+            }
+            slabs.clear();
+            free = nullptr;
+            cursor = nullptr;
+            limit = nullptr;
+            next_slab_blocks = first_slab_blocks;
+        };
+
+        [[nodiscard]] auto size() const noexcept -> size_t
+        {
+            return block_size;
+        };
+
+    private:
+        struct free_block
+        {
+            free_block* next;
+        };
+        struct slab
+        {
+            void* memory;
+            size_t bytes;
+        };
+
+        static constexpr auto round_up(size_t value, size_t alignment) noexcept -> size_t
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        };
+
+        auto grow() -> void
+        {
+            const size_t bytes = next_slab_blocks * block_size;
+            slabs.reserve(slabs.size() + 1);
+            auto* memory = static_cast<unsigned char*>(::operator new(bytes, std::align_val_t{ alignment }));
+            slabs.push_back(slab{ memory, bytes });
+            cursor = memory;
+            limit = memory + bytes;
+            if (bytes * 2 <= maximum_slab_bytes)
+            {
+                next_slab_blocks *= 2;
+            }
+        };
+
+        size_t block_size;
+        size_t alignment;
+        size_t next_slab_blocks = first_slab_blocks;
+        free_block* free = nullptr;
+        unsigned char* cursor = nullptr;
+        unsigned char* limit = nullptr;
+        std::vector<slab> slabs;
+    };
+
+    // a fixed_pool sized and aligned for T.
+    template <typename T>
+    struct object_pool
+    {
+        object_pool() noexcept :
+            pool{ sizeof(T), alignof(T) }
+        {};
+
+        template <typename... Args>
+        [[nodiscard]] auto create(Args&&... args) -> T*
+        {
+            void* block = pool.allocate();
+            try
+            {
+                return ::new (block) T(jpl::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                pool.deallocate(block);
+                throw;
+            }
+        };
+        auto destroy(T* object) noexcept -> void
+        {
+            object->~T();
+            pool.deallocate(object);
+        };
+
+        auto release() noexcept -> void
+        {
+            pool.release();
+        };
+
+    private:
+        fixed_pool pool;
+    };
+};
@@ -0,0 +1,521 @@
+#pragma once
+
+#include "memory.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <concepts>
+#include <exception>
+#include <functional>
+#include <memory>
+
+// niche
+// has_niche
+// sentinel_niche
+// nullopt_t
+// nullopt
+// bad_optional_access
+// optional
+namespace jpl
+{
+    // names a value of T that never carries meaning, so that optional<T> can
+    // use it to mean "empty" instead of adding a flag. a specialization
+    // provides
+    //     static constexpr auto empty() -> T;
+    //     static constexpr auto is_empty(const T&) noexcept -> bool;
+    // and empty() should not throw.
+    template <typename T>
+    struct niche
+    {};
+
+    template <typename T>
+    concept has_niche = requires (const T& value)
+    {
+        requires is_same_v<decltype(niche<T>::empty()), T>;
+        { niche<T>::is_empty(value) } -> std::convertible_to<bool>;
+    };
+
+    // a niche that is one particular value; an enum declares its sentinel with
+    //     template <> struct jpl::niche<colour> : jpl::sentinel_niche<colour, colour::none> {};
+    // raw pointers have none by default, as null is often a value worth
+    // keeping; a pointer that is never null opts in the same way with
+    //     template <> struct jpl::niche<node*> : jpl::sentinel_niche<node*, nullptr> {};
+    template <typename T, T Sentinel>
+    struct sentinel_niche
+    {
+        static constexpr auto empty() noexcept -> T
+        {
+            return Sentinel;
+        };
+        static constexpr auto is_empty(const T& value) noexcept -> bool
+        {
+            return value == Sentinel;
+        };
+    };
+
+    template <typename T, typename D>
+    requires is_default_constructible_v<D>
+    struct niche<unique_ptr<T, D>>
+    {
+        static constexpr auto empty() noexcept -> unique_ptr<T, D>
+        {
+            return unique_ptr<T, D>{};
+        };
+        static constexpr auto is_empty(const unique_ptr<T, D>& value) noexcept -> bool
+        {
+            return not value;
+        };
+    };
+
+    struct nullopt_t
+    {
+        struct tag
+        {
+            explicit tag() = default;
+        };
+        constexpr explicit nullopt_t(tag) noexcept
+        {};
+    };
+    inline constexpr nullopt_t nullopt{ nullopt_t::tag{} };
+
+    struct bad_optional_access : std::exception
+    {
+        auto what() const noexcept -> const char* override
+        {
+            return "jpl::optional::value";
+        };
+    };
+
+    template <typename T>
+    struct optional;
+
+    namespace impl
+    {
+        namespace optional
+        {
+            template <typename T>
+            inline constexpr bool is_optional = false;
+            template <typename T>
+            inline constexpr bool is_optional<jpl::optional<T>> = true;
+
+            struct empty_byte
+            {};
+
+            // a separate flag, for types without a niche.
+            template <typename T>
+            struct storage
+            {
+                union
+                {
+                    empty_byte nothing;
+                    T value;
+                };
+                bool engaged = false;
+
+                constexpr storage() noexcept :
+                    nothing{}
+                {};
+                template <typename... As>
+                constexpr explicit storage(in_place_t, As&&... arguments) :
+                    value(jpl::forward<As>(arguments)...),
+                    engaged{ true }
+                {};
+                constexpr ~storage() requires is_trivially_destructible_v<T> = default;
+                // the owning optional destroys the value.
+                constexpr ~storage()
+                {};
+
+                [[nodiscard]] constexpr auto has_value() const noexcept -> bool
+                {
+                    return engaged;
+                };
+                // requires an empty storage.
+                template <typename... As>
+                constexpr auto construct(As&&... arguments) -> void
+                {
+                    std::construct_at(&value, jpl::forward<As>(arguments)...);
+                    engaged = true;
+                };
+                // requires an engaged storage.
+                constexpr auto destroy() noexcept -> void
+                {
+                    std::destroy_at(&value);
+                    engaged = false;
+                };
+            };
+
+            // the flag folded into the value: empty is the niche value.
+            template <has_niche T>
+            struct storage<T>
+            {
+                T value;
+
+                constexpr storage() noexcept :
+                    value(niche<T>::empty())
+                {};
+                template <typename... As>
+                constexpr explicit storage(in_place_t, As&&... arguments) :
+                    value(jpl::forward<As>(arguments)...)
+                {};
+
+                [[nodiscard]] constexpr auto has_value() const noexcept -> bool
+                {
+                    return not niche<T>::is_empty(value);
+                };
+                template <typename... As>
+                constexpr auto construct(As&&... arguments) -> void
+                {
+                    std::destroy_at(&value);
+                    try
+                    {
+                        std::construct_at(&value, jpl::forward<As>(arguments)...);
+                    }
+                    catch (...)
+                    {
+                        std::construct_at(&value, niche<T>::empty());
+                        throw;
+                    }
+                };
+                constexpr auto destroy() noexcept -> void
+                {
+                    std::destroy_at(&value);
+                    std::construct_at(&value, niche<T>::empty());
+                };
+            };
+
+            // with a niche every special member is T's own, so the defaulted
+            // ones are used whatever T's triviality.
+            template <typename T>
+            concept trivial_copy = has_niche<T> or is_trivially_copy_constructible_v<T>;
+            template <typename T>
+            concept trivial_move = has_niche<T> or is_trivially_move_constructible_v<T>;
+            template <typename T>
+            concept trivial_copy_assign = has_niche<T> or (is_trivially_copy_constructible_v<T> and is_trivially_copy_assignable_v<T> and is_trivially_destructible_v<T>);
+            template <typename T>
+            concept trivial_move_assign = has_niche<T> or (is_trivially_move_constructible_v<T> and is_trivially_move_assignable_v<T> and is_trivially_destructible_v<T>);
+            template <typename T>
+            concept trivial_destroy = has_niche<T> or is_trivially_destructible_v<T>;
+        };
+    };
+
+    // a T or nothing. types with a niche store "nothing" in it, making
+    // sizeof(optional<T>) == sizeof(T); everything else carries a flag. the
+    // special members are trivial whenever T's are, so optional stays usable
+    // in constant expressions and in memcpy'd arrays.
+    template <typename T>
+    struct optional
+    {
+        static_assert(not is_reference_v<T> and not is_array_v<T>, "jpl::optional needs an object type.");
+        static_assert(not is_same_v<remove_cv_t<T>, nullopt_t> and not is_same_v<remove_cv_t<T>, in_place_t>, "jpl::optional cannot hold its own tags.");
+
+        using value_type = T;
+
+        constexpr optional() noexcept = default;
+        constexpr optional(nullopt_t) noexcept
+        {};
+        template <typename... As>
+        requires is_constructible_v<T, As...>
+        constexpr explicit optional(in_place_t, As&&... arguments) :
+            data{ in_place, jpl::forward<As>(arguments)... }
+        {};
+        template <typename U = T>
+        requires is_constructible_v<T, U> and (not is_same_v<remove_cvref_t<U>, in_place_t>) and (not is_same_v<remove_cvref_t<U>, nullopt_t>) and (not impl::optional::is_optional<remove_cvref_t<U>>)
+        constexpr explicit(not is_convertible_v<U, T>) optional(U&& value) :
+            data{ in_place, jpl::forward<U>(value) }
+        {};
+
+        constexpr optional(const optional&) requires impl::optional::trivial_copy<T> = default;
+        constexpr optional(const optional& other)
+        requires (not impl::optional::trivial_copy<T>) and is_copy_constructible_v<T>
+        {
+            if (other.has_value())
+            {
+                data.construct(*other);
+            }
+        };
+        constexpr optional(optional&&) requires impl::optional::trivial_move<T> = default;
+        constexpr optional(optional&& other) noexcept(is_nothrow_move_constructible_v<T>)
+        requires (not impl::optional::trivial_move<T>) and is_move_constructible_v<T>
+        {
+            if (other.has_value())
+            {
+                data.construct(jpl::move(*other));
+            }
+        };
+
+        constexpr auto operator =(const optional&) -> optional& requires impl::optional::trivial_copy_assign<T> = default;
+        constexpr auto operator =(const optional& other) -> optional&
+        requires (not impl::optional::trivial_copy_assign<T>) and is_copy_constructible_v<T> and is_copy_assignable_v<T>
+        {
+            assign(other);
+            return *this;
+        };
+        constexpr auto operator =(optional&&) -> optional& requires impl::optional::trivial_move_assign<T> = default;
+        constexpr auto operator =(optional&& other) noexcept(is_nothrow_move_constructible_v<T> and is_nothrow_move_assignable_v<T>) -> optional&
+        requires (not impl::optional::trivial_move_assign<T>) and is_move_constructible_v<T> and is_move_assignable_v<T>
+        {
+            assign(jpl::move(other));
+            return *this;
+        };
+        constexpr auto operator =(nullopt_t) noexcept -> optional&
+        {
+            reset();
+            return *this;
+        };
+        template <typename U = T>
+        requires is_constructible_v<T, U> and is_assignable_v<T&, U> and (not is_same_v<remove_cvref_t<U>, nullopt_t>) and (not impl::optional::is_optional<remove_cvref_t<U>>)
+        constexpr auto operator =(U&& value) -> optional&
+        {
+            if (has_value())
+            {
+                data.value = jpl::forward<U>(value);
+            }
+            else
+            {
+                data.construct(jpl::forward<U>(value));
+            }
+            return *this;
+        };
+
+        constexpr ~optional() requires impl::optional::trivial_destroy<T> = default;
+        constexpr ~optional()
+        {
+            reset();
+        };
+
+        template <typename... As>
+        constexpr auto emplace(As&&... arguments) -> T&
+        {
+            reset();
+            data.construct(jpl::forward<As>(arguments)...);
+            return data.value;
+        };
+        constexpr auto reset() noexcept -> void
+        {
+            if (has_value())
+            {
+                data.destroy();
+            }
+        };
+        constexpr auto swap(optional& other) noexcept(is_nothrow_move_constructible_v<T> and is_nothrow_swappable_v<T>) -> void
+        {
+            if (has_value() and other.has_value())
+            {
+                using std::swap;
+                swap(data.value, other.data.value);
+            }
+            else if (has_value())
+            {
+                other.data.construct(jpl::move(data.value));
+                data.destroy();
+            }
+            else if (other.has_value())
+            {
+                data.construct(jpl::move(other.data.value));
+                other.data.destroy();
+            }
+        };
+
+        [[nodiscard]] constexpr auto has_value() const noexcept -> bool
+        {
+            return data.has_value();
+        };
+        constexpr explicit operator bool() const noexcept
+        {
+            return has_value();
+        };
+
+        // unchecked; the optional must hold a value.
+        [[nodiscard]] constexpr auto operator *() & noexcept -> T&
+        {
+            return data.value;
+        };
+        [[nodiscard]] constexpr auto operator *() const& noexcept -> const T&
+        {
+            return data.value;
+        };
+        [[nodiscard]] constexpr auto operator *() && noexcept -> T&&
+        {
+            return jpl::move(data.value);
+        };
+        [[nodiscard]] constexpr auto operator *() const&& noexcept -> const T&&
+        {
+            return jpl::move(data.value);
+        };
+        [[nodiscard]] constexpr auto operator ->() noexcept -> T*
+        {
+            return &data.value;
+        };
+        [[nodiscard]] constexpr auto operator ->() const noexcept -> const T*
+        {
+            return &data.value;
+        };
+
+        // checked; throws bad_optional_access when empty.
+        [[nodiscard]] constexpr auto value() & -> T&
+        {
+            check();
+            return data.value;
+        };
+        [[nodiscard]] constexpr auto value() const& -> const T&
+        {
+            check();
+            return data.value;
+        };
+        [[nodiscard]] constexpr auto value() && -> T&&
+        {
+            check();
+            return jpl::move(data.value);
+        };
+        [[nodiscard]] constexpr auto value() const&& -> const T&&
+        {
+            check();
+            return jpl::move(data.value);
+        };
+
+        template <typename U>
+        [[nodiscard]] constexpr auto value_or(U&& fallback) const& -> T
+        {
+            return has_value() ? data.value : static_cast<T>(jpl::forward<U>(fallback));
+        };
+        template <typename U>
+        [[nodiscard]] constexpr auto value_or(U&& fallback) && -> T
+        {
+            return has_value() ? jpl::move(data.value) : static_cast<T>(jpl::forward<U>(fallback));
+        };
+
+        // f(value), which returns an optional, or an empty one of that type.
+        template <typename F>
+        constexpr auto and_then(F&& f) &
+        {
+            return and_then_of(*this, jpl::forward<F>(f));
+        };
+        template <typename F>
+        constexpr auto and_then(F&& f) const&
+        {
+            return and_then_of(*this, jpl::forward<F>(f));
+        };
+        template <typename F>
+        constexpr auto and_then(F&& f) &&
+        {
+            return and_then_of(jpl::move(*this), jpl::forward<F>(f));
+        };
+        template <typename F>
+        constexpr auto and_then(F&& f) const&&
+        {
+            return and_then_of(jpl::move(*this), jpl::forward<F>(f));
+        };
+
+        // optional{ f(value) }, or an empty one.
+        template <typename F>
+        constexpr auto transform(F&& f) &
+        {
+            return transform_of(*this, jpl::forward<F>(f));
+        };
+        template <typename F>
+        constexpr auto transform(F&& f) const&
+        {
+            return transform_of(*this, jpl::forward<F>(f));
+        };
+        template <typename F>
+        constexpr auto transform(F&& f) &&
+        {
+            return transform_of(jpl::move(*this), jpl::forward<F>(f));
+        };
+        template <typename F>
+        constexpr auto transform(F&& f) const&&
+        {
+            return transform_of(jpl::move(*this), jpl::forward<F>(f));
+        };
+
+        // this if it holds a value, and f() otherwise.
+        template <typename F>
+        constexpr auto or_else(F&& f) const& -> optional
+        {
+            return has_value() ? *this : static_cast<optional>(jpl::forward<F>(f)());
+        };
+        template <typename F>
+        constexpr auto or_else(F&& f) && -> optional
+        {
+            return has_value() ? jpl::move(*this) : static_cast<optional>(jpl::forward<F>(f)());
+        };
+
+        template <typename U>
+        friend constexpr auto operator ==(const optional& left, const optional<U>& right) -> bool
+        {
+            if (left.has_value() != right.has_value())
+            {
+                return false;
+            }
+            return not left.has_value() or *left == *right;
+        };
+        friend constexpr auto operator ==(const optional& left, nullopt_t) noexcept -> bool
+        {
+            return not left.has_value();
+        };
+        template <typename U>
+        requires (not impl::optional::is_optional<U>) and requires (const T& t, const U& u) { { t == u } -> std::convertible_to<bool>; }
+        friend constexpr auto operator ==(const optional& left, const U& right) -> bool
+        {
+            return left.has_value() and *left == right;
+        };
+
+        friend constexpr auto swap(optional& left, optional& right) noexcept(noexcept(left.swap(right))) -> void
+        {
+            left.swap(right);
+        };
+
+    private:
+        constexpr auto check() const -> void
+        {
+            if (not has_value())
+            {
+                throw bad_optional_access{};
+            }
+        };
+
+        template <typename Other>
+        constexpr auto assign(Other&& other) -> void
+        {
+            if (other.has_value() and has_value())
+            {
+                data.value = *jpl::forward<Other>(other);
+            }
+            else if (other.has_value())
+            {
+                data.construct(*jpl::forward<Other>(other));
+            }
+            else
+            {
+                reset();
+            }
+        };
+
+        template <typename Self, typename F>
+        static constexpr auto and_then_of(Self&& self, F&& f)
+        {
+            using result = remove_cvref_t<std::invoke_result_t<F, decltype(*jpl::forward<Self>(self))>>;
+            static_assert(impl::optional::is_optional<result>, "jpl::optional::and_then needs a function returning an optional.");
+            if (self.has_value())
+            {
+                return std::invoke(jpl::forward<F>(f), *jpl::forward<Self>(self));
+            }
+            return result{};
+        };
+        template <typename Self, typename F>
+        static constexpr auto transform_of(Self&& self, F&& f)
+        {
+            using result = remove_cv_t<std::invoke_result_t<F, decltype(*jpl::forward<Self>(self))>>;
+            if (self.has_value())
+            {
+                return jpl::optional<result>{ in_place, std::invoke(jpl::forward<F>(f), *jpl::forward<Self>(self)) };
+            }
+            return jpl::optional<result>{};
+        };
+
+        impl::optional::storage<T> data;
+    };
+
+    template <typename T>
+    optional(T) -> optional<T>;
+};
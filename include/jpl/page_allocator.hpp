@@ -0,0 +1,317 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "memory_resource.hpp"
+#include "parallel.hpp"
+#include "span.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// page_size
+// huge_page_size
+// numa::current_node
+// numa::node_of
+// numa::prefer
+// numa::prefer_for_thread
+// page_options
+// allocate_pages
+// deallocate_pages
+// first_touch
+// page_resource
+namespace jpl
+{
+    [[nodiscard]] inline auto page_size() noexcept -> size_t
+    {
+        static const auto size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    };
+    // the transparent huge page size on x86-64 and most aarch64 kernels.
+    inline constexpr size_t huge_page_size = size_t{ 2 } << 20;
+
+    namespace impl
+    {
+        namespace numa
+        {
+            // from linux/mempolicy.h, which is not always installed.
+            inline constexpr int preferred = 1;
+            inline constexpr unsigned long flag_node = 1;
+            inline constexpr unsigned long flag_address = 2;
+
+            // enough bits for 1024 nodes.
+            using node_mask = std::array<unsigned long, 16>;
+            inline constexpr size_t mask_bits = sizeof(node_mask) * 8;
+
+            inline auto mask_of(int node) noexcept -> node_mask
+            {
+                node_mask mask{};
+                const auto bit = static_cast<size_t>(node);
+                mask[bit / (sizeof(unsigned long) * 8)] = 1ul << (bit % (sizeof(unsigned long) * 8));
+                return mask;
+            };
+        };
+    };
+
+    // numa placement through raw system calls, so nothing links against
+    // libnuma. every call degrades to a no-op on kernels without numa
+    // support or outside linux: placement is a hint, never a correctness
+    // requirement.
+    namespace numa
+    {
+        // the node of the cpu the calling thread is running on, or -1. the
+        // scheduler may move the thread afterwards unless it is pinned.
+        [[nodiscard]] inline auto current_node() noexcept -> int
+        {
+#if defined(SYS_getcpu)
+            unsigned int cpu = 0;
+            unsigned int node = 0;
+            if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+            {
+                return static_cast<int>(node);
+            }
+#endif
+            return -1;
+        };
+
+        // the node holding the page at address, faulting it in if it was never
+        // touched, or -1.
+        [[nodiscard]] inline auto node_of(const void* address) noexcept -> int
+        {
+#if defined(SYS_get_mempolicy)
+            int node = -1;
+            if (::syscall(SYS_get_mempolicy, &node, nullptr, 0ul, address, impl::numa::flag_node | impl::numa::flag_address) == 0)
+            {
+                return node;
+            }
+#endif
+            return -1;
+        };
+
+        // asks for the pages of [address, address + size) to come from node
+        // when first touched; other nodes are used once it is full. address
+        // must be page aligned. returns whether the kernel accepted.
+        inline auto prefer(void* address, size_t size, int node) noexcept -> bool
+        {
+#if defined(SYS_mbind)
+            if (node < 0 or static_cast<size_t>(node) >= impl::numa::mask_bits)
+            {
+                return false;
+            }
+            const auto mask = impl::numa::mask_of(node);
+            return ::syscall(SYS_mbind, address, static_cast<unsigned long>(size), impl::numa::preferred, mask.data(), static_cast<unsigned long>(impl::numa::mask_bits), 0u) == 0;
+#else
+            (void)address;
+            (void)size;
+            (void)node;
+            return false;
+#endif
+        };
+
+        // the same for every later allocation of the calling thread.
+        inline auto prefer_for_thread(int node) noexcept -> bool
+        {
+#if defined(SYS_set_mempolicy)
+            if (node < 0 or static_cast<size_t>(node) >= impl::numa::mask_bits)
+            {
+                return false;
+            }
+            const auto mask = impl::numa::mask_of(node);
+            return ::syscall(SYS_set_mempolicy, impl::numa::preferred, mask.data(), static_cast<unsigned long>(impl::numa::mask_bits)) == 0;
+#else
+            (void)node;
+            return false;
+#endif
+        };
+    };
+
+    struct page_options
+    {
+        enum struct huge
+        {
+            // base pages only.
+            never,
+            // 2 MiB aligned and advised with MADV_HUGEPAGE, so khugepaged and
+            // the fault path can back it with transparent huge pages.
+            transparent,
+            // MAP_HUGETLB from the reserved hugetlbfs pool, falling back to
+            // transparent when the pool is empty or not configured.
+            reserved,
+        };
+
+        static constexpr int any_node = -1;
+        static constexpr int local_node = -2;
+
+        huge pages = huge::transparent;
+        // a node index, local_node for the calling thread's node at allocation
+        // time, or any_node to leave placement to the first touch.
+        int node = local_node;
+        // touch every page before returning, so the cost of faulting is paid
+        // here rather than on the first pass over the memory.
+        bool populate = false;
+    };
+
+    namespace impl
+    {
+        namespace page_allocator
+        {
+            inline auto granularity(const page_options& options) noexcept -> size_t
+            {
+                return options.pages == page_options::huge::never ? page_size() : huge_page_size;
+            };
+            inline auto rounded(size_t size, const page_options& options) noexcept -> size_t
+            {
+                const size_t unit = granularity(options);
+                return (size + unit - 1) & ~(unit - 1);
+            };
+
+            inline auto map(size_t size, int extra) noexcept -> byte*
+            {
+                void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra, -1, 0);
+                return address == MAP_FAILED ? nullptr : static_cast<byte*>(address);
+            };
+
+            // over-maps by one huge page and trims both ends, leaving a huge
+            // page aligned region the kernel can back with whole huge pages.
+            inline auto map_aligned(size_t size) noexcept -> byte*
+            {
+                const size_t padded = size + huge_page_size - page_size();
+                byte* raw = map(padded, 0);
+                if (raw == nullptr)
+                {
+                    return nullptr;
+                }
+                const auto start = reinterpret_cast<std::uintptr_t>(raw);
+                byte* aligned = reinterpret_cast<byte*>((start + huge_page_size - 1) & ~(huge_page_size - 1));
+                if (aligned != raw)
+                {
+                    ::munmap(raw, static_cast<size_t>(aligned - raw));
+                }
+                const size_t tail = padded - static_cast<size_t>(aligned - raw) - size;
+                if (tail != 0)
+                {
+                    ::munmap(aligned + size, tail);
+                }
+#if defined(MADV_HUGEPAGE)
+                ::madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+                return aligned;
+            };
+        };
+    };
+
+    // writes every page of region back to itself from the calling thread, so
+    // under the default first-touch policy each page is placed on this
+    // thread's node. contents are unchanged, but nothing else may write to
+    // region meanwhile.
+    inline auto first_touch(span<byte> region) noexcept -> void
+    {
+        const size_t page = page_size();
+        auto* bytes = reinterpret_cast<volatile unsigned char*>(region.data());
+        for (size_t offset = 0; offset < region.size(); offset += page)
+        {
+            bytes[offset] = bytes[offset];
+        }
+    };
+    // the same, with pages spread over the pool in page-aligned chunks, so a
+    // region that the pool will process together is spread over the nodes
+    // its workers run on instead of landing on one.
+    inline auto first_touch(thread_pool& pool, span<byte> region) -> void
+    {
+        const size_t page = page_size();
+        const size_t pages = (region.size() + page - 1) / page;
+        const size_t chunks = std::min(pages, (pool.size() + 1) * jpl::parallel::chunks_per_thread);
+        pool.fork_join(chunks, [&](size_t chunk)
+        {
+            const auto [begin, end] = impl::parallel::bounds(pages, chunks, chunk);
+            const size_t last = std::min(end * page, region.size());
+            first_touch(region.subspan(begin * page, last - begin * page));
+        });
+    };
+
+    // maps at least size bytes of zeroed memory straight from the kernel,
+    // aligned to the page size options asks for. throws std::bad_alloc when
+    // no kind of page is available. release it with the same size and options.
+    [[nodiscard]] inline auto allocate_pages(size_t size, const page_options& options = {}) -> byte*
+    {
+        const size_t length = impl::page_allocator::rounded(size == 0 ? 1 : size, options);
+        byte* region = nullptr;
+#if defined(MAP_HUGETLB)
+        if (options.pages == page_options::huge::reserved)
+        {
+            region = impl::page_allocator::map(length, MAP_HUGETLB);
+        }
+#endif
+        if (region == nullptr)
+        {
+            region = options.pages == page_options::huge::never ? impl::page_allocator::map(length, 0) : impl::page_allocator::map_aligned(length);
+        }
+        if (region == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+        // the policy has to be in place before the first fault to matter.
+        const int node = options.node == page_options::local_node ? numa::current_node() : options.node;
+        if (node >= 0)
+        {
+            numa::prefer(region, length, node);
+        }
+        if (options.populate)
+        {
+            first_touch(span<byte>{ region, length });
+        }
+        return region;
+    };
+    inline auto deallocate_pages(byte* region, size_t size, const page_options& options = {}) noexcept -> void
+    {
+        if (region != nullptr)
+        {
+            ::munmap(region, impl::page_allocator::rounded(size == 0 ? 1 : size, options));
+        }
+    };
+
+    // a memory_resource handing out whole pages, meant as the upstream of an
+    // arena or pool rather than for small objects: every allocation is at
+    // least one page, or one huge page unless huge pages are disabled.
+    struct page_resource : memory_resource
+    {
+        page_resource() noexcept = default;
+        explicit page_resource(const page_options& options) noexcept :
+            options{ options }
+        {};
+
+        [[nodiscard]] auto settings() const noexcept -> const page_options&
+        {
+            return options;
+        };
+
+    private:
+        auto do_allocate(size_t bytes, size_t alignment) -> void* override
+        {
+            if (alignment > impl::page_allocator::granularity(options))
+            {
+                throw std::bad_alloc{};
+            }
+            return allocate_pages(bytes, options);
+        };
+        auto do_deallocate(void* pointer, size_t bytes, size_t) -> void override
+        {
+            deallocate_pages(static_cast<byte*>(pointer), bytes, options);
+        };
+        auto do_is_equal(const memory_resource& other) const noexcept -> bool override
+        {
+            // pages go straight back to the kernel, so any page_resource with
+            // the same rounding can release them.
+            const auto* pages = dynamic_cast<const page_resource*>(&other);
+            return pages != nullptr and impl::page_allocator::granularity(pages->options) == impl::page_allocator::granularity(options);
+        };
+
+        page_options options;
+    };
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "algorithm.hpp"
+#include "cstddef.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+// parallel::for_each
+// parallel::transform
+// parallel::reduce
+// parallel::inclusive_scan
+// parallel::sort
+namespace jpl
+{
+    namespace parallel
+    {
+        // below serial_threshold elements the fork/join overhead outweighs the work.
+        // above it, ranges are split into at most chunks_per_thread chunks per
+        // participating thread (for load balance) but never below minimum_grain
+        // elements per chunk.
+        inline constexpr size_t serial_threshold = size_t{ 1 } << 14;
+        inline constexpr size_t minimum_grain = size_t{ 1 } << 12;
+        inline constexpr size_t chunks_per_thread = 4;
+    };
+
+    namespace impl
+    {
+        namespace parallel
+        {
+            inline auto chunk_count(jpl::thread_pool& pool, size_t size) noexcept -> size_t
+            {
+                if (size < jpl::parallel::serial_threshold or pool.size() == 0)
+                {
+                    return 1;
+                }
+                const size_t by_threads = (pool.size() + 1) * jpl::parallel::chunks_per_thread;
+                const size_t by_grain = size / jpl::parallel::minimum_grain;
+                return std::max<size_t>(1, std::min(by_threads, by_grain));
+            };
+
+            // [begin, end) of chunk i out of count over size elements, spreading the
+            // remainder over the leading chunks.
+            struct chunk_bounds
+            {
+                size_t begin;
+                size_t end;
+            };
+            constexpr auto bounds(size_t size, size_t count, size_t i) noexcept -> chunk_bounds
+            {
+                const size_t base = size / count;
+                const size_t extra = size % count;
+                const size_t begin = i * base + std::min(i, extra);
+                return chunk_bounds{ begin, begin + base + (i < extra ? 1 : 0) };
+            };
+        };
+    };
+
+    namespace parallel
+    {
+        template <std::random_access_iterator I, typename F>
+        auto for_each(thread_pool& pool, I first, I last, F function) -> void
+        {
+            const size_t size = static_cast<size_t>(last - first);
+            const size_t chunks = impl::parallel::chunk_count(pool, size);
+            pool.fork_join(chunks, [&](size_t chunk)
+            {
+                const auto [begin, end] = impl::parallel::bounds(size, chunks, chunk);
+                std::for_each(first + begin, first + end, function);
+            });
+        };
+        template <std::random_access_iterator I, typename F>
+        auto for_each(I first, I last, F function) -> void
+        {
+            parallel::for_each(default_thread_pool(), first, last, jpl::move(function));
+        };
+
+        template <std::random_access_iterator I, std::random_access_iterator O, typename F>
+        auto transform(thread_pool& pool, I first, I last, O out, F function) -> O
+        {
+            const size_t size = static_cast<size_t>(last - first);
+            const size_t chunks = impl::parallel::chunk_count(pool, size);
+            pool.fork_join(chunks, [&](size_t chunk)
+            {
+                const auto [begin, end] = impl::parallel::bounds(size, chunks, chunk);
+                std::transform(first + begin, first + end, out + begin, function);
+            });
+            return out + size;
+        };
+        template <std::random_access_iterator I, std::random_access_iterator O, typename F>
+        auto transform(I first, I last, O out, F function) -> O
+        {
+            return parallel::transform(default_thread_pool(), first, last, out, jpl::move(function));
+        };
+
+        // op must be associative; partial results are combined in chunk order.
+        template <std::random_access_iterator I, typename T, typename Op = std::plus<>>
+        auto reduce(thread_pool& pool, I first, I last, T init, Op op = {}) -> T
+        {
+            const size_t size = static_cast<size_t>(last - first);
+            const size_t chunks = impl::parallel::chunk_count(pool, size);
+            if (chunks == 1)
+            {
+                return std::accumulate(first, last, jpl::move(init), op);
+            }
+
+            std::vector<T> partials(chunks, init);
+            pool.fork_join(chunks, [&](size_t chunk)
+            {
+                const auto [begin, end] = impl::parallel::bounds(size, chunks, chunk);
+                T partial = *(first + begin);
+                for (auto it = first + begin + 1; it != first + end; ++it)
+                {
+                    partial = op(jpl::move(partial), *it);
+                }
+                partials[chunk] = jpl::move(partial);
+            });
+            for (auto& partial : partials)
+            {
+                init = op(jpl::move(init), jpl::move(partial));
+            }
+            return init;
+        };
+        template <std::random_access_iterator I, typename T, typename Op = std::plus<>>
+        auto reduce(I first, I last, T init, Op op = {}) -> T
+        {
+            return parallel::reduce(default_thread_pool(), first, last, jpl::move(init), jpl::move(op));
+        };
+
+        // two passes: per-chunk totals in parallel, a serial exclusive scan over
+        // those totals, then each chunk scans again seeded with its offset.
+        template <std::random_access_iterator I, std::random_access_iterator O, typename Op = std::plus<>>
+        auto inclusive_scan(thread_pool& pool, I first, I last, O out, Op op = {}) -> O
+        {
+            using value_type = typename std::iterator_traits<I>::value_type;
+
+            const size_t size = static_cast<size_t>(last - first);
+            const size_t chunks = impl::parallel::chunk_count(pool, size);
+            if (chunks == 1)
+            {
+                return std::inclusive_scan(first, last, out, op);
+            }
+
+            std::vector<value_type> totals(chunks);
+            pool.fork_join(chunks, [&](size_t chunk)
+            {
+                const auto [begin, end] = impl::parallel::bounds(size, chunks, chunk);
+                value_type total = *(first + begin);
+                for (auto it = first + begin + 1; it != first + end; ++it)
+                {
+                    total = op(jpl::move(total), *it);
+                }
+                totals[chunk] = jpl::move(total);
+            });
+            for (size_t chunk = 1; chunk < chunks; ++chunk)
+            {
+                totals[chunk] = op(totals[chunk - 1], totals[chunk]);
+            }
+            pool.fork_join(chunks, [&](size_t chunk)
+            {
+                const auto [begin, end] = impl::parallel::bounds(size, chunks, chunk);
+                if (chunk == 0)
+                {
+                    std::inclusive_scan(first + begin, first + end, out + begin, op);
+                }
+                else
+                {
+                    std::inclusive_scan(first + begin, first + end, out + begin, op, totals[chunk - 1]);
+                }
+            });
+            return out + size;
+        };
+        template <std::random_access_iterator I, std::random_access_iterator O, typename Op = std::plus<>>
+        auto inclusive_scan(I first, I last, O out, Op op = {}) -> O
+        {
+            return parallel::inclusive_scan(default_thread_pool(), first, last, out, jpl::move(op));
+        };
+
+        // sorts power-of-two many chunks independently, then merges neighbouring
+        // runs pairwise, each round in parallel.
+        template <std::random_access_iterator I, typename Compare = std::less<>>
+        auto sort(thread_pool& pool, I first, I last, Compare compare = {}) -> void
+        {
+            const size_t size = static_cast<size_t>(last - first);
+            size_t chunks = impl::parallel::chunk_count(pool, size);
+            if (chunks == 1)
+            {
+                jpl::sort(first, last, compare);
+                return;
+            }
+            chunks = std::bit_floor(chunks);
+
+            pool.fork_join(chunks, [&](size_t chunk)
+            {
+                const auto [begin, end] = impl::parallel::bounds(size, chunks, chunk);
+                jpl::sort(first + begin, first + end, compare);
+            });
+            for (size_t width = 1; width < chunks; width *= 2)
+            {
+                pool.fork_join(chunks / (2 * width), [&](size_t pair)
+                {
+                    const size_t left = pair * 2 * width;
+                    const size_t begin = impl::parallel::bounds(size, chunks, left).begin;
+                    const size_t middle = impl::parallel::bounds(size, chunks, left + width).begin;
+                    const size_t end = impl::parallel::bounds(size, chunks, left + 2 * width - 1).end;
+                    std::inplace_merge(first + begin, first + middle, first + end, compare);
+                });
+            }
+        };
+        template <std::random_access_iterator I, typename Compare = std::less<>>
+        auto sort(I first, I last, Compare compare = {}) -> void
+        {
+            parallel::sort(default_thread_pool(), first, last, jpl::move(compare));
+        };
+    };
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "new.hpp"
+#include "thread.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#include <atomic>
+#include <cstring>
+
+// seqlock
+namespace jpl
+{
+    namespace impl
+    {
+        namespace seqlock
+        {
+            using word = unsigned long long;
+
+            template <typename T>
+            inline constexpr size_t word_count = (sizeof(T) + sizeof(word) - 1) / sizeof(word);
+
+            template <typename T>
+            concept snapshot_value = is_trivially_copy_constructible_v<T> and is_trivially_destructible_v<T>;
+
+            // lets a reader copy into a T that need not be default constructible.
+            template <typename T>
+            union uninitialized
+            {
+                uninitialized() noexcept
+                {};
+                T value;
+            };
+        };
+    };
+
+    // readers never write to shared memory: they copy optimistically and retry
+    // if the sequence moved underneath them. writers serialize on the sequence
+    // itself, an odd value meaning a write is in progress.
+    template <typename T>
+    requires impl::seqlock::snapshot_value<T>
+    struct alignas(hardware_destructive_interference_size) seqlock
+    {
+        using value_type = T;
+        using version_type = unsigned long long;
+
+        seqlock() noexcept
+        requires is_default_constructible_v<T> :
+            seqlock{ T{} }
+        {};
+        explicit seqlock(const T& value) noexcept
+        {
+            write_words(value);
+        };
+        seqlock(const seqlock&) = delete;
+        auto operator =(const seqlock&) -> seqlock& = delete;
+
+        // returns false instead of retrying when a write overlaps the copy.
+        [[nodiscard]] auto try_load(T& out, version_type& version) const noexcept -> bool
+        {
+            const version_type before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+            {
+                return false;
+            }
+            read_words(out);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            version = before;
+            return sequence.load(std::memory_order_relaxed) == before;
+        };
+        [[nodiscard]] auto load(version_type& version) const noexcept -> T
+        {
+            impl::seqlock::uninitialized<T> out;
+            while (not try_load(out.value, version))
+            {
+                this_thread::pause();
+            }
+            return out.value;
+        };
+        [[nodiscard]] auto load() const noexcept -> T
+        {
+            version_type version;
+            return load(version);
+        };
+
+        // even and monotonically increasing; two loads that report the same
+        // version saw the same value.
+        [[nodiscard]] auto version() const noexcept -> version_type
+        {
+            return sequence.load(std::memory_order_acquire) & ~version_type{ 1 };
+        };
+
+        auto store(const T& desired) noexcept -> void
+        {
+            const version_type current = lock();
+            write_words(desired);
+            sequence.store(current + 2, std::memory_order_release);
+        };
+        template <typename F>
+        auto update(F&& modify) noexcept(noexcept(modify(declval<T&>()))) -> void
+        {
+            const version_type current = lock();
+            impl::seqlock::uninitialized<T> value;
+            read_words(value.value);
+            try
+            {
+                modify(value.value);
+            }
+            catch (...)
+            {
+                // modify only saw a copy, so the stored words are untouched;
+                // the sequence just has to be even again for anyone to go on.
+                sequence.store(current + 2, std::memory_order_release);
+                throw;
+            }
+            write_words(value.value);
+            sequence.store(current + 2, std::memory_order_release);
+        };
+
+    private:
+        auto lock() noexcept -> version_type
+        {
+            version_type current = sequence.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                if ((current & 1) == 0 and
+                    sequence.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    break;
+                }
+                this_thread::pause();
+                current = sequence.load(std::memory_order_relaxed);
+            }
+            // keeps the data stores from being reordered ahead of the odd sequence.
+            std::atomic_thread_fence(std::memory_order_release);
+            return current;
+        };
+
+        // the payload lives in relaxed atomics so the racing copy is well defined.
+        auto read_words(T& out) const noexcept -> void
+        {
+            impl::seqlock::word buffer[impl::seqlock::word_count<T>];
+            for (size_t i = 0; i < impl::seqlock::word_count<T>; ++i)
+            {
+                buffer[i] = storage[i].load(std::memory_order_relaxed);
+            }
+            std::memcpy(static_cast<void*>(&out), buffer, sizeof(T));
+        };
+        auto write_words(const T& value) noexcept -> void
+        {
+            impl::seqlock::word buffer[impl::seqlock::word_count<T>]{};
+            std::memcpy(buffer, static_cast<const void*>(&value), sizeof(T));
+            for (size_t i = 0; i < impl::seqlock::word_count<T>; ++i)
+            {
+                storage[i].store(buffer[i], std::memory_order_relaxed);
+            }
+        };
+
+        std::atomic<version_type> sequence{ 0 };
+        std::atomic<impl::seqlock::word> storage[impl::seqlock::word_count<T>];
+    };
+};
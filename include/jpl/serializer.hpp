@@ -0,0 +1,331 @@
+#pragma once
+
+#include "bit.hpp"
+#include "cstddef.hpp"
+#include "span.hpp"
+#include "string_view.hpp"
+#include "type_list.hpp"
+#include "type_traits.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// field
+// serializer
+namespace jpl
+{
+    namespace impl
+    {
+        namespace serializer
+        {
+            template <typename M>
+            struct member;
+            template <typename C, typename M>
+            struct member<M C::*>
+            {
+                using class_type = C;
+                using type = M;
+            };
+
+            // variable-length fields: a length prefix on the wire, and a view
+            // into the input buffer when decoded.
+            template <typename M>
+            inline constexpr bool is_payload = is_any_of_v<M, jpl::span<const byte>, jpl::string_view>;
+
+            using length_type = std::uint32_t;
+
+            template <size_t Size>
+            struct unsigned_of;
+            template <>
+            struct unsigned_of<2>
+            {
+                using type = std::uint16_t;
+            };
+            template <>
+            struct unsigned_of<4>
+            {
+                using type = std::uint32_t;
+            };
+            template <>
+            struct unsigned_of<8>
+            {
+                using type = std::uint64_t;
+            };
+
+            template <typename M>
+            auto reverse_bytes(M value) noexcept -> M
+            {
+                if constexpr (sizeof(M) == 1)
+                {
+                    return value;
+                }
+                else
+                {
+                    using U = typename unsigned_of<sizeof(M)>::type;
+                    return bit_cast<M>(byteswap(bit_cast<U>(value)));
+                }
+            };
+
+            template <endian Order, typename M>
+            auto store(byte* out, M value) noexcept -> void
+            {
+                if constexpr (Order != endian::native)
+                {
+                    value = reverse_bytes(value);
+                }
+                std::memcpy(out, &value, sizeof(M));
+            };
+            template <endian Order, typename M>
+            auto load(const byte* in) noexcept -> M
+            {
+                M value;
+                std::memcpy(&value, in, sizeof(M));
+                if constexpr (Order != endian::native)
+                {
+                    value = reverse_bytes(value);
+                }
+                return value;
+            };
+
+            // copies of adjacent fields that are also adjacent in memory are
+            // merged, so a run of native fields costs one memcpy. the adjacency
+            // test compares addresses within one object and folds to a constant.
+            struct writer
+            {
+                byte* out;
+                const byte* run = nullptr;
+                size_t run_size = 0;
+
+                auto append(const void* source, size_t size) noexcept -> void
+                {
+                    const auto* bytes = static_cast<const byte*>(source);
+                    if (bytes != run + run_size)
+                    {
+                        flush();
+                        run = bytes;
+                    }
+                    run_size += size;
+                };
+                auto flush() noexcept -> void
+                {
+                    if (run_size != 0)
+                    {
+                        std::memcpy(out, run, run_size);
+                        out += run_size;
+                        run_size = 0;
+                    }
+                };
+            };
+            struct reader
+            {
+                const byte* in;
+                const byte* end;
+                byte* run = nullptr;
+                size_t run_size = 0;
+
+                auto append(void* destination, size_t size) noexcept -> void
+                {
+                    auto* bytes = static_cast<byte*>(destination);
+                    if (bytes != run + run_size)
+                    {
+                        flush();
+                        run = bytes;
+                    }
+                    run_size += size;
+                };
+                auto flush() noexcept -> void
+                {
+                    if (run_size != 0)
+                    {
+                        std::memcpy(run, in, run_size);
+                        in += run_size;
+                        run_size = 0;
+                    }
+                };
+            };
+        };
+    };
+
+    // one member of a serialized struct, in the byte order it has on the wire.
+    // scalars in a foreign order are byteswapped; other trivially copyable
+    // members are copied as they are, so they must not contain wider scalars
+    // unless the order is native. span<const byte> and string_view members
+    // are written as a 32-bit length followed by the bytes.
+    template <auto Member, endian Order = endian::little>
+    struct field
+    {
+        static_assert(is_member_object_pointer_v<decltype(Member)>, "jpl::field needs a pointer to a data member.");
+
+        using class_type = typename impl::serializer::member<decltype(Member)>::class_type;
+        using member_type = typename impl::serializer::member<decltype(Member)>::type;
+
+        static constexpr auto member = Member;
+        static constexpr endian order = Order;
+        static constexpr bool payload = impl::serializer::is_payload<member_type>;
+        static constexpr bool scalar = is_arithmetic_v<member_type> or is_enum_v<member_type>;
+        // copied byte for byte, and so eligible to be merged with its neighbours.
+        static constexpr bool verbatim = not payload and (Order == endian::native or sizeof(member_type) == 1 or not scalar);
+        // bytes on the wire, not counting a payload's contents.
+        static constexpr size_t wire_size = payload ? sizeof(impl::serializer::length_type) : sizeof(member_type);
+
+        static_assert(payload or is_trivially_copyable_v<member_type>, "jpl::field members must be trivially copyable or a byte view.");
+        static_assert(payload or scalar or Order == endian::native or alignof(member_type) == 1, "describe the scalars inside this member as fields of their own.");
+    };
+
+    template <typename T, typename Fields>
+    struct serializer;
+
+    // a fixed-layout codec for T, generated from a type_list of fields. the
+    // wire format is the fields in list order with no padding. decoded byte
+    // views point into the input buffer, which must outlive them.
+    template <typename T, typename... Fields>
+    struct serializer<T, type_list<Fields...>>
+    {
+        static_assert((is_same_v<typename Fields::class_type, T> and ...), "every field must be a member of T.");
+
+        // the encoded size when every payload is empty.
+        static constexpr size_t fixed_size = (Fields::wire_size + ... + 0);
+        static constexpr bool fixed = (not Fields::payload and ...);
+
+        [[nodiscard]] static auto size(const T& value) noexcept -> size_t
+        {
+            return fixed_size + (payload_size<Fields>(value) + ... + 0);
+        };
+
+        // writes value into out and returns the number of bytes written.
+        static auto encode(const T& value, span<byte> out) -> size_t
+        {
+            const size_t required = size(value);
+            if (out.size() < required)
+            {
+                throw std::out_of_range{ "jpl::serializer::encode" };
+            }
+            impl::serializer::writer writer{ out.data() };
+            (put<Fields>(writer, value), ...);
+            writer.flush();
+            return required;
+        };
+        // appends value to out and returns the number of bytes appended.
+        static auto encode(const T& value, std::vector<byte>& out) -> size_t
+        {
+            const size_t offset = out.size();
+            out.resize(offset + size(value));
+            return encode(value, span<byte>{ out.data() + offset, out.size() - offset });
+        };
+
+        // reads one value from the front of in and returns the number of bytes
+        // consumed, so consecutive records decode from the same buffer.
+        static auto decode(span<const byte> in, T& value) -> size_t
+        {
+            if (in.size() < fixed_size)
+            {
+                throw std::out_of_range{ "jpl::serializer::decode" };
+            }
+            impl::serializer::reader reader{ in.data(), in.data() + in.size() };
+            [&]<size_t... I>(std::index_sequence<I...>)
+            {
+                (get<Fields, I>(reader, value), ...);
+            }(std::index_sequence_for<Fields...>{});
+            reader.flush();
+            return static_cast<size_t>(reader.in - in.data());
+        };
+        [[nodiscard]] static auto decode(span<const byte> in) -> T
+        requires is_default_constructible_v<T>
+        {
+            T value{};
+            decode(in, value);
+            return value;
+        };
+
+    private:
+        // wire bytes of the fields after the i-th, which a payload's length
+        // must leave room for.
+        static constexpr auto wire_after(size_t i) noexcept -> size_t
+        {
+            constexpr size_t sizes[] = { Fields::wire_size..., 0 };
+            size_t total = 0;
+            for (size_t j = i + 1; j < sizeof...(Fields); ++j)
+            {
+                total += sizes[j];
+            }
+            return total;
+        };
+
+        template <typename F>
+        static auto payload_size(const T& value) noexcept -> size_t
+        {
+            if constexpr (F::payload)
+            {
+                return (value.*F::member).size();
+            }
+            else
+            {
+                return 0;
+            }
+        };
+
+        template <typename F>
+        static auto put(impl::serializer::writer& writer, const T& value) -> void
+        {
+            const auto& member = value.*F::member;
+            if constexpr (F::verbatim)
+            {
+                writer.append(&member, sizeof(member));
+            }
+            else if constexpr (F::payload)
+            {
+                if (member.size() > static_cast<size_t>(static_cast<impl::serializer::length_type>(-1)))
+                {
+                    throw std::length_error{ "jpl::serializer::encode" };
+                }
+                writer.flush();
+                impl::serializer::store<F::order>(writer.out, static_cast<impl::serializer::length_type>(member.size()));
+                writer.out += sizeof(impl::serializer::length_type);
+                if (not member.empty())
+                {
+                    std::memcpy(writer.out, member.data(), member.size());
+                }
+                writer.out += member.size();
+            }
+            else
+            {
+                writer.flush();
+                impl::serializer::store<F::order>(writer.out, member);
+                writer.out += sizeof(member);
+            }
+        };
+
+        template <typename F, size_t I>
+        static auto get(impl::serializer::reader& reader, T& value) -> void
+        {
+            auto& member = value.*F::member;
+            if constexpr (F::verbatim)
+            {
+                reader.append(&member, sizeof(member));
+            }
+            else if constexpr (F::payload)
+            {
+                reader.flush();
+                const auto length = impl::serializer::load<F::order, impl::serializer::length_type>(reader.in);
+                reader.in += sizeof(impl::serializer::length_type);
+                if (length > static_cast<size_t>(reader.end - reader.in) - wire_after(I))
+                {
+                    throw std::out_of_range{ "jpl::serializer::decode" };
+                }
+                using view = typename F::member_type;
+                using element = remove_cvref_t<decltype(*member.data())>;
+                member = view{ reinterpret_cast<const element*>(reader.in), length };
+                reader.in += length;
+            }
+            else
+            {
+                reader.flush();
+                member = impl::serializer::load<F::order, typename F::member_type>(reader.in);
+                reader.in += sizeof(member);
+            }
+        };
+    };
+};
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "utility.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// slot_handle
+// slot_map
+namespace jpl
+{
+    // names one insertion into a slot_map. the generation makes handles to
+    // erased elements fail lookups instead of aliasing whatever reuses the slot.
+    struct slot_handle
+    {
+        unsigned int index = std::numeric_limits<unsigned int>::max();
+        unsigned int generation = 0;
+
+        [[nodiscard]] constexpr auto to_bits() const noexcept -> unsigned long long
+        {
+            return (static_cast<unsigned long long>(generation) << 32) | index;
+        };
+        [[nodiscard]] static constexpr auto from_bits(unsigned long long bits) noexcept -> slot_handle
+        {
+            return slot_handle{ static_cast<unsigned int>(bits), static_cast<unsigned int>(bits >> 32) };
+        };
+
+        friend constexpr auto operator ==(const slot_handle&, const slot_handle&) noexcept -> bool = default;
+    };
+
+    // values are kept densely packed, so iteration is a walk over a contiguous
+    // array; handles go through a slot table that tracks where each value
+    // currently lives. insert and erase are O(1): erase moves the last value
+    // into the hole. pointers and iterators are invalidated by insert and
+    // erase, handles only by erasing their own element.
+    template <typename T>
+    struct slot_map
+    {
+        using value_type = T;
+        using size_type = size_t;
+        using handle = slot_handle;
+        using iterator = typename std::vector<T>::iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        template <typename... Args>
+        auto emplace(Args&&... args) -> handle
+        {
+            unsigned int slot_index;
+            if (free_head != no_slot)
+            {
+                slot_index = free_head;
+                free_head = slots[slot_index].position;
+                reuse(slot_index);
+            }
+            else
+            {
+                slot_index = static_cast<unsigned int>(slots.size());
+                slots.push_back(slot{});
+            }
+            try
+            {
+                owners.push_back(slot_index);
+                try
+                {
+                    values.emplace_back(jpl::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    owners.pop_back();
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                release(slot_index);
+                throw;
+            }
+            slots[slot_index].position = static_cast<unsigned int>(values.size() - 1);
+            return handle{ slot_index, slots[slot_index].generation };
+        };
+        auto insert(const T& value) -> handle
+        {
+            return emplace(value);
+        };
+        auto insert(T&& value) -> handle
+        {
+            return emplace(jpl::move(value));
+        };
+
+        // returns false for stale handles.
+        auto erase(handle h) -> bool
+        {
+            if (not contains(h))
+            {
+                return false;
+            }
+            const unsigned int position = slots[h.index].position;
+            if (position + 1 != values.size())
+            {
+                values[position] = jpl::move(values.back());
+                owners[position] = owners.back();
+                slots[owners[position]].position = position;
+            }
+            values.pop_back();
+            owners.pop_back();
+            release(h.index);
+            return true;
+        };
+        // invalidates every outstanding handle.
+        auto clear() noexcept -> void
+        {
+            while (not owners.empty())
+            {
+                release(owners.back());
+                owners.pop_back();
+            }
+            values.clear();
+        };
+        auto reserve(size_type capacity) -> void
+        {
+            values.reserve(capacity);
+            owners.reserve(capacity);
+            slots.reserve(capacity);
+        };
+
+        [[nodiscard]] auto contains(handle h) const noexcept -> bool
+        {
+            return h.index < slots.size() and slots[h.index].generation == h.generation and
+                (slots[h.index].generation & 1) == 0;
+        };
+        // nullptr for stale handles.
+        [[nodiscard]] auto get(handle h) noexcept -> T*
+        {
+            return contains(h) ? &values[slots[h.index].position] : nullptr;
+        };
+        [[nodiscard]] auto get(handle h) const noexcept -> const T*
+        {
+            return contains(h) ? &values[slots[h.index].position] : nullptr;
+        };
+        [[nodiscard]] auto at(handle h) -> T&
+        {
+            if (not contains(h))
+            {
+                throw std::out_of_range{ "jpl::slot_map::at" };
+            }
+            return values[slots[h.index].position];
+        };
+        [[nodiscard]] auto at(handle h) const -> const T&
+        {
+            return const_cast<slot_map*>(this)->at(h);
+        };
+        // unchecked.
+        [[nodiscard]] auto operator [](handle h) noexcept -> T&
+        {
+            return values[slots[h.index].position];
+        };
+        [[nodiscard]] auto operator [](handle h) const noexcept -> const T&
+        {
+            return values[slots[h.index].position];
+        };
+        // the handle of the value at a position in the dense array, e.g. while
+        // iterating.
+        [[nodiscard]] auto handle_at(size_type position) const noexcept -> handle
+        {
+            return handle{ owners[position], slots[owners[position]].generation };
+        };
+
+        [[nodiscard]] auto size() const noexcept -> size_type
+        {
+            return values.size();
+        };
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return values.empty();
+        };
+        [[nodiscard]] auto data() noexcept -> T*
+        {
+            return values.data();
+        };
+        [[nodiscard]] auto data() const noexcept -> const T*
+        {
+            return values.data();
+        };
+        [[nodiscard]] auto begin() noexcept -> iterator
+        {
+            return values.begin();
+        };
+        [[nodiscard]] auto end() noexcept -> iterator
+        {
+            return values.end();
+        };
+        [[nodiscard]] auto begin() const noexcept -> const_iterator
+        {
+            return values.begin();
+        };
+        [[nodiscard]] auto end() const noexcept -> const_iterator
+        {
+            return values.end();
+        };
+
+    private:
+        static constexpr unsigned int no_slot = std::numeric_limits<unsigned int>::max();
+
+        // generations are even while the slot is live and odd while it is free,
+        // so a handle can never match a free slot. position is the index into
+        // values while live and the next free slot while free.
+        struct slot
+        {
+            unsigned int position = no_slot;
+            unsigned int generation = 0;
+        };
+
+        auto release(unsigned int slot_index) noexcept -> void
+        {
+            slot& freed = slots[slot_index];
+            ++freed.generation;
+            // a slot whose generation would wrap is retired rather than risk a
+            // stale handle matching again.
+            if (freed.generation == std::numeric_limits<unsigned int>::max())
+            {
+                return;
+            }
+            freed.position = free_head;
+            free_head = slot_index;
+        };
+        auto reuse(unsigned int slot_index) noexcept -> void
+        {
+            ++slots[slot_index].generation;
+        };
+
+        std::vector<T> values;
+        std::vector<unsigned int> owners;
+        std::vector<slot> slots;
+        unsigned int free_head = no_slot;
+    };
+};
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "type_traits.hpp"
+
+#include <array>
+#include <iterator>
+#include <ranges>
+
+// dynamic_extent
+// span
+// as_bytes
+// as_writable_bytes
+namespace jpl
+{
+    inline constexpr size_t dynamic_extent = static_cast<size_t>(-1);
+
+    template <typename T, size_t Extent = dynamic_extent>
+    struct span;
+
+    namespace impl
+    {
+        namespace span
+        {
+            // a static extent is part of the type, so only the pointer is stored.
+            template <typename T, size_t Extent>
+            struct storage
+            {
+                constexpr storage() noexcept = default;
+                constexpr storage(T* pointer, size_t) noexcept :
+                    pointer{ pointer }
+                {};
+
+                static constexpr auto size() noexcept -> size_t
+                {
+                    return Extent;
+                };
+
+                T* pointer = nullptr;
+            };
+            template <typename T>
+            struct storage<T, dynamic_extent>
+            {
+                constexpr storage() noexcept = default;
+                constexpr storage(T* pointer, size_t count) noexcept :
+                    pointer{ pointer },
+                    count{ count }
+                {};
+
+                constexpr auto size() const noexcept -> size_t
+                {
+                    return count;
+                };
+
+                T* pointer = nullptr;
+                size_t count = 0;
+            };
+
+            template <typename T>
+            inline constexpr bool is_span = false;
+            template <typename T, size_t Extent>
+            inline constexpr bool is_span<jpl::span<T, Extent>> = true;
+            template <typename T>
+            inline constexpr bool is_std_array = false;
+            template <typename T, size_t N>
+            inline constexpr bool is_std_array<std::array<T, N>> = true;
+
+            // qualification conversions only: span<const T> from span<T>, never
+            // span<Base> from span<Derived>.
+            template <typename From, typename To>
+            concept compatible_element = is_convertible_v<From(*)[], To(*)[]>;
+
+            template <typename R, typename T>
+            concept compatible_range =
+                std::ranges::contiguous_range<R> and
+                std::ranges::sized_range<R> and
+                (std::ranges::borrowed_range<R> or is_const_v<T>) and
+                not is_span<remove_cvref_t<R>> and
+                not is_std_array<remove_cvref_t<R>> and
+                not is_array_v<remove_cvref_t<R>> and
+                compatible_element<remove_reference_t<std::ranges::range_reference_t<R>>, T>;
+
+            constexpr auto subspan_extent(size_t extent, size_t offset, size_t count) noexcept -> size_t
+            {
+                if (count != dynamic_extent)
+                {
+                    return count;
+                }
+                return extent != dynamic_extent ? extent - offset : dynamic_extent;
+            };
+        };
+    };
+
+    // a non-owning view of a contiguous sequence: one pointer for a static
+    // extent, a pointer and a count for a dynamic one.
+    template <typename T, size_t Extent>
+    struct span
+    {
+        using element_type = T;
+        using value_type = remove_cv_t<T>;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = T*;
+
+        static constexpr size_t extent = Extent;
+
+        constexpr span() noexcept requires (Extent == 0 or Extent == dynamic_extent) = default;
+        template <std::contiguous_iterator I>
+        requires impl::span::compatible_element<remove_reference_t<std::iter_reference_t<I>>, T>
+        constexpr explicit(Extent != dynamic_extent) span(I first, size_type count) noexcept :
+            elements{ std::to_address(first), count }
+        {};
+        template <std::contiguous_iterator I, std::sized_sentinel_for<I> S>
+        requires impl::span::compatible_element<remove_reference_t<std::iter_reference_t<I>>, T>
+        constexpr explicit(Extent != dynamic_extent) span(I first, S last) noexcept :
+            elements{ std::to_address(first), static_cast<size_type>(last - first) }
+        {};
+        template <size_t N>
+        requires (Extent == dynamic_extent or Extent == N)
+        constexpr span(element_type (&array)[N]) noexcept :
+            elements{ array, N }
+        {};
+        template <typename U, size_t N>
+        requires (Extent == dynamic_extent or Extent == N) and impl::span::compatible_element<U, T>
+        constexpr span(std::array<U, N>& array) noexcept :
+            elements{ array.data(), N }
+        {};
+        template <typename U, size_t N>
+        requires (Extent == dynamic_extent or Extent == N) and impl::span::compatible_element<const U, T>
+        constexpr span(const std::array<U, N>& array) noexcept :
+            elements{ array.data(), N }
+        {};
+        template <impl::span::compatible_range<T> R>
+        constexpr explicit(Extent != dynamic_extent) span(R&& range) noexcept(noexcept(std::ranges::data(range))) :
+            elements{ std::ranges::data(range), static_cast<size_type>(std::ranges::size(range)) }
+        {};
+        template <typename U, size_t N>
+        requires (Extent == dynamic_extent or N == dynamic_extent or Extent == N) and impl::span::compatible_element<U, T>
+        constexpr explicit(Extent != dynamic_extent and N == dynamic_extent) span(const span<U, N>& other) noexcept :
+            elements{ other.data(), other.size() }
+        {};
+        constexpr span(const span&) noexcept = default;
+        constexpr auto operator =(const span&) noexcept -> span& = default;
+
+        [[nodiscard]] constexpr auto begin() const noexcept -> iterator
+        {
+            return elements.pointer;
+        };
+        [[nodiscard]] constexpr auto end() const noexcept -> iterator
+        {
+            return elements.pointer + size();
+        };
+        [[nodiscard]] constexpr auto data() const noexcept -> pointer
+        {
+            return elements.pointer;
+        };
+        [[nodiscard]] constexpr auto size() const noexcept -> size_type
+        {
+            return elements.size();
+        };
+        [[nodiscard]] constexpr auto size_bytes() const noexcept -> size_type
+        {
+            return size() * sizeof(T);
+        };
+        [[nodiscard]] constexpr auto empty() const noexcept -> bool
+        {
+            return size() == 0;
+        };
+
+        // unchecked.
+        [[nodiscard]] constexpr auto operator [](size_type i) const noexcept -> reference
+        {
+            return elements.pointer[i];
+        };
+        [[nodiscard]] constexpr auto front() const noexcept -> reference
+        {
+            return elements.pointer[0];
+        };
+        [[nodiscard]] constexpr auto back() const noexcept -> reference
+        {
+            return elements.pointer[size() - 1];
+        };
+
+        template <size_t Count>
+        [[nodiscard]] constexpr auto first() const noexcept -> span<T, Count>
+        {
+            static_assert(Extent == dynamic_extent or Count <= Extent);
+            return span<T, Count>{ elements.pointer, Count };
+        };
+        [[nodiscard]] constexpr auto first(size_type count) const noexcept -> span<T>
+        {
+            return span<T>{ elements.pointer, count };
+        };
+        template <size_t Count>
+        [[nodiscard]] constexpr auto last() const noexcept -> span<T, Count>
+        {
+            static_assert(Extent == dynamic_extent or Count <= Extent);
+            return span<T, Count>{ elements.pointer + size() - Count, Count };
+        };
+        [[nodiscard]] constexpr auto last(size_type count) const noexcept -> span<T>
+        {
+            return span<T>{ elements.pointer + size() - count, count };
+        };
+        template <size_t Offset, size_t Count = dynamic_extent>
+        [[nodiscard]] constexpr auto subspan() const noexcept -> span<T, impl::span::subspan_extent(Extent, Offset, Count)>
+        {
+            static_assert(Extent == dynamic_extent or Offset <= Extent);
+            return span<T, impl::span::subspan_extent(Extent, Offset, Count)>{
+                elements.pointer + Offset,
+                Count == dynamic_extent ? size() - Offset : Count
+            };
+        };
+        [[nodiscard]] constexpr auto subspan(size_type offset, size_type count = dynamic_extent) const noexcept -> span<T>
+        {
+            return span<T>{ elements.pointer + offset, count == dynamic_extent ? size() - offset : count };
+        };
+
+    private:
+        impl::span::storage<T, Extent> elements;
+    };
+
+    template <std::contiguous_iterator I, typename End>
+    span(I, End) -> span<remove_reference_t<std::iter_reference_t<I>>>;
+    template <typename T, size_t N>
+    span(T (&)[N]) -> span<T, N>;
+    template <typename T, size_t N>
+    span(std::array<T, N>&) -> span<T, N>;
+    template <typename T, size_t N>
+    span(const std::array<T, N>&) -> span<const T, N>;
+    template <std::ranges::contiguous_range R>
+    span(R&&) -> span<remove_reference_t<std::ranges::range_reference_t<R>>>;
+
+    template <typename T, size_t Extent>
+    [[nodiscard]] auto as_bytes(span<T, Extent> view) noexcept -> span<const byte, Extent == dynamic_extent ? dynamic_extent : sizeof(T) * Extent>
+    {
+        return span<const byte, Extent == dynamic_extent ? dynamic_extent : sizeof(T) * Extent>{ reinterpret_cast<const byte*>(view.data()), view.size_bytes() };
+    };
+    template <typename T, size_t Extent>
+    requires (not is_const_v<T>)
+    [[nodiscard]] auto as_writable_bytes(span<T, Extent> view) noexcept -> span<byte, Extent == dynamic_extent ? dynamic_extent : sizeof(T) * Extent>
+    {
+        return span<byte, Extent == dynamic_extent ? dynamic_extent : sizeof(T) * Extent>{ reinterpret_cast<byte*>(view.data()), view.size_bytes() };
+    };
+};
+
+template <typename T, jpl::size_t Extent>
+inline constexpr bool std::ranges::enable_borrowed_range<jpl::span<T, Extent>> = true;
+template <typename T, jpl::size_t Extent>
+inline constexpr bool std::ranges::enable_view<jpl::span<T, Extent>> = true;
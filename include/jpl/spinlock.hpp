@@ -0,0 +1,250 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "new.hpp"
+#include "thread.hpp"
+#include "utility.hpp"
+
+#include <atomic>
+#include <thread>
+
+// basic_lockable
+// lockable
+// exponential_backoff
+namespace jpl
+{
+    template <typename L>
+    concept basic_lockable = requires (L& lock)
+    {
+        lock.lock();
+        lock.unlock();
+    };
+    template <typename L>
+    concept lockable = basic_lockable<L> and requires (L& lock)
+    {
+        lock.try_lock();
+    } and is_convertible_v<decltype(declval<L&>().try_lock()), bool>;
+
+    // doubles the number of pause instructions per round up to a ceiling, after
+    // which the waiter starts handing its timeslice back instead.
+    struct exponential_backoff
+    {
+        static constexpr unsigned initial_spins = 1;
+        static constexpr unsigned maximum_spins = 1024;
+
+        unsigned spins = initial_spins;
+
+        auto pause() noexcept -> void
+        {
+            if (spins <= maximum_spins)
+            {
+                for (unsigned i = 0; i < spins; ++i)
+                {
+                    this_thread::pause();
+                }
+                spins <<= 1;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        };
+        auto reset() noexcept -> void
+        {
+            spins = initial_spins;
+        };
+    };
+};
+
+// spinlock
+// ticket_lock
+// mcs_lock
+namespace jpl
+{
+    // test-and-test-and-set: waiters spin on a shared read of the flag and only
+    // attempt the exchange once it looks free, so the line is not bounced
+    // between waiters on every iteration.
+    struct spinlock
+    {
+        constexpr spinlock() noexcept = default;
+        spinlock(const spinlock&) = delete;
+        auto operator =(const spinlock&) -> spinlock& = delete;
+
+        auto lock() noexcept -> void
+        {
+            exponential_backoff backoff;
+            while (locked.exchange(true, std::memory_order_acquire))
+            {
+                do
+                {
+                    backoff.pause();
+                }
+                while (locked.load(std::memory_order_relaxed));
+            }
+        };
+        [[nodiscard]] auto try_lock() noexcept -> bool
+        {
+            return not locked.load(std::memory_order_relaxed) and not locked.exchange(true, std::memory_order_acquire);
+        };
+        auto unlock() noexcept -> void
+        {
+            locked.store(false, std::memory_order_release);
+        };
+
+    private:
+        std::atomic<bool> locked{ false };
+    };
+
+    // fifo: each waiter takes a ticket and spins until it is served, backing off
+    // in proportion to how many waiters are ahead of it.
+    struct ticket_lock
+    {
+        constexpr ticket_lock() noexcept = default;
+        ticket_lock(const ticket_lock&) = delete;
+        auto operator =(const ticket_lock&) -> ticket_lock& = delete;
+
+        auto lock() noexcept -> void
+        {
+            const unsigned ticket = next.fetch_add(1, std::memory_order_relaxed);
+            for (;;)
+            {
+                const unsigned current = serving.load(std::memory_order_acquire);
+                if (current == ticket)
+                {
+                    return;
+                }
+                const unsigned ahead = ticket - current;
+                for (unsigned i = 0; i < ahead * spins_per_waiter; ++i)
+                {
+                    this_thread::pause();
+                }
+            }
+        };
+        [[nodiscard]] auto try_lock() noexcept -> bool
+        {
+            unsigned current = serving.load(std::memory_order_relaxed);
+            return next.compare_exchange_strong(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed);
+        };
+        auto unlock() noexcept -> void
+        {
+            serving.store(serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        };
+
+    private:
+        static constexpr unsigned spins_per_waiter = 32;
+
+        std::atomic<unsigned> next{ 0 };
+        std::atomic<unsigned> serving{ 0 };
+    };
+
+    namespace impl
+    {
+        namespace mcs_lock
+        {
+            struct alignas(hardware_destructive_interference_size) node
+            {
+                std::atomic<node*> next{ nullptr };
+                std::atomic<bool> locked{ false };
+                node* free_next = nullptr;
+            };
+
+            // queue nodes are per thread and per held lock; recycling them through
+            // a thread-local free list keeps lock() allocation free after warmup.
+            struct node_cache
+            {
+                node* free = nullptr;
+
+                node_cache() noexcept = default;
+                node_cache(const node_cache&) = delete;
+                ~node_cache()
+                {
+                    while (free != nullptr)
+                    {
+                        delete jpl::exchange(free, free->free_next);
+                    }
+                };
+
+                auto acquire() -> node*
+                {
+                    if (free == nullptr)
+                    {
+                        return new node;
+                    }
+                    return jpl::exchange(free, free->free_next);
+                };
+                auto release(node* recycled) noexcept -> void
+                {
+                    recycled->free_next = free;
+                    free = recycled;
+                };
+            };
+
+            inline thread_local node_cache cache;
+        };
+    };
+
+    // each waiter spins on a flag in its own queue node, so a handoff touches
+    // exactly one remote cache line regardless of how many threads are waiting.
+    struct mcs_lock
+    {
+        constexpr mcs_lock() noexcept = default;
+        mcs_lock(const mcs_lock&) = delete;
+        auto operator =(const mcs_lock&) -> mcs_lock& = delete;
+
+        auto lock() -> void
+        {
+            auto* self = impl::mcs_lock::cache.acquire();
+            self->next.store(nullptr, std::memory_order_relaxed);
+            self->locked.store(true, std::memory_order_relaxed);
+
+            if (auto* predecessor = tail.exchange(self, std::memory_order_acq_rel))
+            {
+                predecessor->next.store(self, std::memory_order_release);
+                exponential_backoff backoff;
+                while (self->locked.load(std::memory_order_acquire))
+                {
+                    backoff.pause();
+                }
+            }
+            owner = self;
+        };
+        [[nodiscard]] auto try_lock() -> bool
+        {
+            auto* self = impl::mcs_lock::cache.acquire();
+            self->next.store(nullptr, std::memory_order_relaxed);
+            impl::mcs_lock::node* expected = nullptr;
+            if (tail.compare_exchange_strong(expected, self, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                owner = self;
+                return true;
+            }
+            impl::mcs_lock::cache.release(self);
+            return false;
+        };
+        auto unlock() noexcept -> void
+        {
+            auto* self = owner;
+            auto* successor = self->next.load(std::memory_order_acquire);
+            if (successor == nullptr)
+            {
+                auto* expected = self;
+                if (tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed))
+                {
+                    impl::mcs_lock::cache.release(self);
+                    return;
+                }
+                // a waiter swapped itself in but has not linked behind us yet.
+                while ((successor = self->next.load(std::memory_order_acquire)) == nullptr)
+                {
+                    this_thread::pause();
+                }
+            }
+            successor->locked.store(false, std::memory_order_release);
+            impl::mcs_lock::cache.release(self);
+        };
+
+    private:
+        std::atomic<impl::mcs_lock::node*> tail{ nullptr };
+        impl::mcs_lock::node* owner = nullptr;
+    };
+};
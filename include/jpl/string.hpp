@@ -0,0 +1,495 @@
+#pragma once
+
+#include "bit.hpp"
+#include "byte_kernels.hpp"
+#include "cstddef.hpp"
+#include "string_view.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+// basic_string
+// string
+namespace jpl
+{
+    // a 24-byte string that stores up to 23 characters inline. the last inline
+    // byte holds 23 minus the length, so a full small string's terminator
+    // doubles as its size; heap strings set that byte's high bit through the
+    // capacity word. memory comes from Allocator, so arena-backed strings only
+    // need an arena allocator.
+    template <typename Allocator = std::allocator<char>>
+    struct basic_string
+    {
+        using value_type = char;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using reference = char&;
+        using const_reference = const char&;
+        using pointer = char*;
+        using const_pointer = const char*;
+        using iterator = char*;
+        using const_iterator = const char*;
+
+        static constexpr size_type npos = string_view::npos;
+        static constexpr size_type small_capacity = 23;
+
+        basic_string() noexcept(noexcept(Allocator{})) :
+            basic_string(Allocator{})
+        {};
+        explicit basic_string(const Allocator& allocator) noexcept :
+            allocator{ allocator }
+        {
+            set_small_size(0);
+        };
+        basic_string(const char* data, size_type size, const Allocator& allocator = Allocator{}) :
+            basic_string(allocator)
+        {
+            append(data, size);
+        };
+        basic_string(const char* data, const Allocator& allocator = Allocator{}) :
+            basic_string(string_view{ data }, allocator)
+        {};
+        basic_string(nullptr_t) = delete;
+        explicit basic_string(string_view view, const Allocator& allocator = Allocator{}) :
+            basic_string(view.data(), view.size(), allocator)
+        {};
+        basic_string(size_type count, char c, const Allocator& allocator = Allocator{}) :
+            basic_string(allocator)
+        {
+            resize(count, c);
+        };
+        basic_string(const basic_string& other) :
+            basic_string(other.data(), other.size(), traits::select_on_container_copy_construction(other.allocator))
+        {};
+        basic_string(const basic_string& other, const Allocator& allocator) :
+            basic_string(other.data(), other.size(), allocator)
+        {};
+        basic_string(basic_string&& other) noexcept :
+            allocator{ jpl::move(other.allocator) },
+            storage{ other.storage }
+        {
+            other.set_small_size(0);
+        };
+        auto operator =(const basic_string& other) -> basic_string&
+        {
+            if (this != &other)
+            {
+                if constexpr (traits::propagate_on_container_copy_assignment::value)
+                {
+                    if (allocator != other.allocator)
+                    {
+                        release();
+                        set_small_size(0);
+                    }
+                    allocator = other.allocator;
+                }
+                assign(other.data(), other.size());
+            }
+            return *this;
+        };
+        auto operator =(basic_string&& other) noexcept(traits::propagate_on_container_move_assignment::value or traits::is_always_equal::value) -> basic_string&
+        {
+            if (this == &other)
+            {
+                return *this;
+            }
+            if constexpr (not traits::propagate_on_container_move_assignment::value and not traits::is_always_equal::value)
+            {
+                if (allocator != other.allocator)
+                {
+                    assign(other.data(), other.size());
+                    return *this;
+                }
+            }
+            release();
+            if constexpr (traits::propagate_on_container_move_assignment::value)
+            {
+                allocator = jpl::move(other.allocator);
+            }
+            storage = other.storage;
+            other.set_small_size(0);
+            return *this;
+        };
+        auto operator =(string_view view) -> basic_string&
+        {
+            return assign(view.data(), view.size());
+        };
+        ~basic_string()
+        {
+            release();
+        };
+
+        [[nodiscard]] auto get_allocator() const noexcept -> allocator_type
+        {
+            return allocator;
+        };
+
+        [[nodiscard]] auto data() noexcept -> char*
+        {
+            return is_small() ? storage.local : storage.heap.pointer;
+        };
+        [[nodiscard]] auto data() const noexcept -> const char*
+        {
+            return is_small() ? storage.local : storage.heap.pointer;
+        };
+        [[nodiscard]] auto c_str() const noexcept -> const char*
+        {
+            return data();
+        };
+        [[nodiscard]] auto size() const noexcept -> size_type
+        {
+            return is_small() ? small_capacity - static_cast<unsigned char>(storage.local[small_capacity]) : storage.heap.size;
+        };
+        [[nodiscard]] auto length() const noexcept -> size_type
+        {
+            return size();
+        };
+        [[nodiscard]] auto capacity() const noexcept -> size_type
+        {
+            return is_small() ? small_capacity : decode_capacity(storage.heap.capacity);
+        };
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return size() == 0;
+        };
+
+        [[nodiscard]] auto begin() noexcept -> iterator
+        {
+            return data();
+        };
+        [[nodiscard]] auto end() noexcept -> iterator
+        {
+            return data() + size();
+        };
+        [[nodiscard]] auto begin() const noexcept -> const_iterator
+        {
+            return data();
+        };
+        [[nodiscard]] auto end() const noexcept -> const_iterator
+        {
+            return data() + size();
+        };
+
+        // unchecked.
+        [[nodiscard]] auto operator [](size_type i) noexcept -> reference
+        {
+            return data()[i];
+        };
+        [[nodiscard]] auto operator [](size_type i) const noexcept -> const_reference
+        {
+            return data()[i];
+        };
+        [[nodiscard]] auto at(size_type i) -> reference
+        {
+            if (i >= size())
+            {
+                throw std::out_of_range{ "jpl::basic_string::at" };
+            }
+            return data()[i];
+        };
+        [[nodiscard]] auto at(size_type i) const -> const_reference
+        {
+            return const_cast<basic_string*>(this)->at(i);
+        };
+        [[nodiscard]] auto front() noexcept -> reference
+        {
+            return data()[0];
+        };
+        [[nodiscard]] auto front() const noexcept -> const_reference
+        {
+            return data()[0];
+        };
+        [[nodiscard]] auto back() noexcept -> reference
+        {
+            return data()[size() - 1];
+        };
+        [[nodiscard]] auto back() const noexcept -> const_reference
+        {
+            return data()[size() - 1];
+        };
+
+        operator string_view() const noexcept
+        {
+            return string_view{ data(), size() };
+        };
+        [[nodiscard]] auto view() const noexcept -> string_view
+        {
+            return string_view{ data(), size() };
+        };
+
+        auto reserve(size_type new_capacity) -> void
+        {
+            if (new_capacity > capacity())
+            {
+                reallocate(new_capacity, nullptr, 0);
+            }
+        };
+        auto clear() noexcept -> void
+        {
+            set_size(0);
+        };
+        auto resize(size_type new_size, char c = '\0') -> void
+        {
+            const size_type old_size = size();
+            if (new_size > old_size)
+            {
+                reserve(std::max(new_size, growth(old_size)));
+                std::memset(data() + old_size, c, new_size - old_size);
+            }
+            set_size(new_size);
+        };
+
+        auto assign(const char* characters, size_type count) -> basic_string&
+        {
+            if (count > capacity())
+            {
+                reallocate_fresh(count, characters);
+                return *this;
+            }
+            std::memmove(data(), characters, count);
+            set_size(count);
+            return *this;
+        };
+        auto append(const char* characters, size_type count) -> basic_string&
+        {
+            const size_type old_size = size();
+            if (old_size + count > capacity())
+            {
+                // the source may live in the current buffer, so it is copied
+                // before that buffer is released.
+                reallocate(std::max(old_size + count, growth(old_size)), characters, count);
+                return *this;
+            }
+            std::memmove(data() + old_size, characters, count);
+            set_size(old_size + count);
+            return *this;
+        };
+        auto append(string_view view) -> basic_string&
+        {
+            return append(view.data(), view.size());
+        };
+        auto operator +=(string_view view) -> basic_string&
+        {
+            return append(view.data(), view.size());
+        };
+        auto operator +=(char c) -> basic_string&
+        {
+            push_back(c);
+            return *this;
+        };
+        auto push_back(char c) -> void
+        {
+            append(&c, 1);
+        };
+        auto pop_back() noexcept -> void
+        {
+            set_size(size() - 1);
+        };
+        auto erase(size_type position = 0, size_type count = npos) -> basic_string&
+        {
+            const size_type old_size = size();
+            if (position > old_size)
+            {
+                throw std::out_of_range{ "jpl::basic_string::erase" };
+            }
+            count = std::min(count, old_size - position);
+            std::memmove(data() + position, data() + position + count, old_size - position - count);
+            set_size(old_size - count);
+            return *this;
+        };
+        [[nodiscard]] auto substr(size_type position = 0, size_type count = npos) const -> basic_string
+        {
+            return basic_string{ view().substr(position, count), allocator };
+        };
+
+        [[nodiscard]] auto find(char c, size_type position = 0) const noexcept -> size_type
+        {
+            return view().find(c, position);
+        };
+        [[nodiscard]] auto find(string_view needle, size_type position = 0) const noexcept -> size_type
+        {
+            return view().find(needle, position);
+        };
+        [[nodiscard]] auto find_first_of(string_view set, size_type position = 0) const noexcept -> size_type
+        {
+            return view().find_first_of(set, position);
+        };
+        [[nodiscard]] auto contains(string_view needle) const noexcept -> bool
+        {
+            return view().contains(needle);
+        };
+        [[nodiscard]] auto starts_with(string_view prefix) const noexcept -> bool
+        {
+            return view().starts_with(prefix);
+        };
+        [[nodiscard]] auto ends_with(string_view suffix) const noexcept -> bool
+        {
+            return view().ends_with(suffix);
+        };
+        [[nodiscard]] auto compare(string_view other) const noexcept -> int
+        {
+            return view().compare(other);
+        };
+
+        [[nodiscard]] friend auto operator ==(const basic_string& left, const basic_string& right) noexcept -> bool
+        {
+            return left.view() == right.view();
+        };
+        [[nodiscard]] friend auto operator ==(const basic_string& left, string_view right) noexcept -> bool
+        {
+            return left.view() == right;
+        };
+        [[nodiscard]] friend auto operator <=>(const basic_string& left, const basic_string& right) noexcept -> std::strong_ordering
+        {
+            return left.view() <=> right.view();
+        };
+        [[nodiscard]] friend auto operator <=>(const basic_string& left, string_view right) noexcept -> std::strong_ordering
+        {
+            return left.view() <=> right;
+        };
+        // a literal converts to both basic_string and string_view, so without
+        // these the two overloads above would be ambiguous for it.
+        [[nodiscard]] friend auto operator ==(const basic_string& left, const char* right) noexcept -> bool
+        {
+            return left.view() == string_view{ right };
+        };
+        [[nodiscard]] friend auto operator <=>(const basic_string& left, const char* right) noexcept -> std::strong_ordering
+        {
+            return left.view() <=> string_view{ right };
+        };
+        [[nodiscard]] friend auto operator +(basic_string left, string_view right) -> basic_string
+        {
+            return jpl::move(left.append(right));
+        };
+
+    private:
+        using traits = std::allocator_traits<Allocator>;
+
+        struct heap_representation
+        {
+            char* pointer;
+            size_type size;
+            size_type capacity;
+        };
+        union representation
+        {
+            heap_representation heap;
+            char local[small_capacity + 1];
+        };
+        static_assert(sizeof(representation) == small_capacity + 1);
+
+        // the flag must land in the byte that overlaps local[small_capacity].
+        static constexpr unsigned char heap_flag = 0x80;
+        static constexpr auto encode_capacity(size_type capacity) noexcept -> size_type
+        {
+            if constexpr (endian::native == endian::little)
+            {
+                return capacity | (size_type{ heap_flag } << (8 * (sizeof(size_type) - 1)));
+            }
+            else
+            {
+                return (capacity << 8) | heap_flag;
+            }
+        };
+        static constexpr auto decode_capacity(size_type encoded) noexcept -> size_type
+        {
+            if constexpr (endian::native == endian::little)
+            {
+                return encoded & ~(size_type{ heap_flag } << (8 * (sizeof(size_type) - 1)));
+            }
+            else
+            {
+                return encoded >> 8;
+            }
+        };
+
+        static constexpr auto growth(size_type size) noexcept -> size_type
+        {
+            return size + size / 2;
+        };
+
+        auto is_small() const noexcept -> bool
+        {
+            // read through unsigned char, which may inspect either union member.
+            return (reinterpret_cast<const unsigned char*>(&storage)[small_capacity] & heap_flag) == 0;
+        };
+        auto set_small_size(size_type size) noexcept -> void
+        {
+            storage.local[size] = '\0';
+            storage.local[small_capacity] = static_cast<char>(small_capacity - size);
+        };
+        auto set_size(size_type size) noexcept -> void
+        {
+            if (is_small())
+            {
+                set_small_size(size);
+            }
+            else
+            {
+                storage.heap.size = size;
+                storage.heap.pointer[size] = '\0';
+            }
+        };
+
+        auto release() noexcept -> void
+        {
+            if (not is_small())
+            {
+                traits::deallocate(allocator, storage.heap.pointer, decode_capacity(storage.heap.capacity) + 1);
+            }
+        };
+
+        // moves to a heap buffer of new_capacity, keeping the current contents
+        // and appending [extra, extra + extra_count).
+        auto reallocate(size_type new_capacity, const char* extra, size_type extra_count) -> void
+        {
+            const size_type old_size = size();
+            char* buffer = traits::allocate(allocator, new_capacity + 1);
+            std::memcpy(buffer, data(), old_size);
+            if (extra_count != 0)
+            {
+                std::memcpy(buffer + old_size, extra, extra_count);
+            }
+            release();
+            storage.heap = heap_representation{ buffer, old_size + extra_count, encode_capacity(new_capacity) };
+            buffer[old_size + extra_count] = '\0';
+        };
+        // replaces the contents outright.
+        auto reallocate_fresh(size_type count, const char* characters) -> void
+        {
+            char* buffer = traits::allocate(allocator, count + 1);
+            std::memcpy(buffer, characters, count);
+            release();
+            storage.heap = heap_representation{ buffer, count, encode_capacity(count) };
+            buffer[count] = '\0';
+        };
+
+        [[no_unique_address]] Allocator allocator;
+        representation storage;
+    };
+
+    using string = basic_string<>;
+
+    namespace literals
+    {
+        inline auto operator ""_s(const char* data, size_t size) -> string
+        {
+            return string{ data, size };
+        };
+    };
+};
+
+template <typename Allocator>
+struct std::hash<jpl::basic_string<Allocator>>
+{
+    auto operator ()(const jpl::basic_string<Allocator>& string) const noexcept -> std::size_t
+    {
+        return std::hash<jpl::string_view>{}(string.view());
+    };
+};
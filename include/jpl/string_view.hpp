@@ -0,0 +1,218 @@
+#pragma once
+
+#include "byte_kernels.hpp"
+#include "cstddef.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+
+// string_view
+namespace jpl
+{
+    // a non-owning view of a character range. searches and comparisons run on
+    // the byte kernels, and everything is usable in constant expressions.
+    struct string_view
+    {
+        using value_type = char;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using pointer = const char*;
+        using const_pointer = const char*;
+        using reference = const char&;
+        using const_reference = const char&;
+        using iterator = const char*;
+        using const_iterator = const char*;
+
+        static constexpr size_type npos = byte_kernels::npos;
+
+        constexpr string_view() noexcept = default;
+        constexpr string_view(const char* data, size_type size) noexcept :
+            characters{ data },
+            character_count{ size }
+        {};
+        constexpr string_view(const char* data) noexcept :
+            characters{ data },
+            character_count{ std::char_traits<char>::length(data) }
+        {};
+        constexpr string_view(nullptr_t) = delete;
+        constexpr string_view(std::string_view view) noexcept :
+            characters{ view.data() },
+            character_count{ view.size() }
+        {};
+        constexpr operator std::string_view() const noexcept
+        {
+            return std::string_view{ characters, character_count };
+        };
+
+        [[nodiscard]] constexpr auto begin() const noexcept -> const_iterator
+        {
+            return characters;
+        };
+        [[nodiscard]] constexpr auto end() const noexcept -> const_iterator
+        {
+            return characters + character_count;
+        };
+        [[nodiscard]] constexpr auto data() const noexcept -> const_pointer
+        {
+            return characters;
+        };
+        [[nodiscard]] constexpr auto size() const noexcept -> size_type
+        {
+            return character_count;
+        };
+        [[nodiscard]] constexpr auto length() const noexcept -> size_type
+        {
+            return character_count;
+        };
+        [[nodiscard]] constexpr auto empty() const noexcept -> bool
+        {
+            return character_count == 0;
+        };
+
+        // unchecked.
+        [[nodiscard]] constexpr auto operator [](size_type i) const noexcept -> const_reference
+        {
+            return characters[i];
+        };
+        [[nodiscard]] constexpr auto at(size_type i) const -> const_reference
+        {
+            if (i >= character_count)
+            {
+                throw std::out_of_range{ "jpl::string_view::at" };
+            }
+            return characters[i];
+        };
+        [[nodiscard]] constexpr auto front() const noexcept -> const_reference
+        {
+            return characters[0];
+        };
+        [[nodiscard]] constexpr auto back() const noexcept -> const_reference
+        {
+            return characters[character_count - 1];
+        };
+
+        constexpr auto remove_prefix(size_type count) noexcept -> void
+        {
+            characters += count;
+            character_count -= count;
+        };
+        constexpr auto remove_suffix(size_type count) noexcept -> void
+        {
+            character_count -= count;
+        };
+        [[nodiscard]] constexpr auto substr(size_type position = 0, size_type count = npos) const -> string_view
+        {
+            if (position > character_count)
+            {
+                throw std::out_of_range{ "jpl::string_view::substr" };
+            }
+            return string_view{ characters + position, std::min(count, character_count - position) };
+        };
+
+        [[nodiscard]] constexpr auto compare(string_view other) const noexcept -> int
+        {
+            const int result = byte_kernels::compare(characters, other.characters, std::min(character_count, other.character_count));
+            if (result != 0)
+            {
+                return result;
+            }
+            return character_count == other.character_count ? 0 : (character_count < other.character_count ? -1 : 1);
+        };
+        [[nodiscard]] constexpr auto starts_with(string_view prefix) const noexcept -> bool
+        {
+            return character_count >= prefix.character_count and byte_kernels::mismatch(characters, prefix.characters, prefix.character_count) == prefix.character_count;
+        };
+        [[nodiscard]] constexpr auto starts_with(char c) const noexcept -> bool
+        {
+            return not empty() and front() == c;
+        };
+        [[nodiscard]] constexpr auto ends_with(string_view suffix) const noexcept -> bool
+        {
+            return character_count >= suffix.character_count and byte_kernels::mismatch(characters + character_count - suffix.character_count, suffix.characters, suffix.character_count) == suffix.character_count;
+        };
+        [[nodiscard]] constexpr auto ends_with(char c) const noexcept -> bool
+        {
+            return not empty() and back() == c;
+        };
+
+        [[nodiscard]] constexpr auto find(char c, size_type position = 0) const noexcept -> size_type
+        {
+            if (position >= character_count)
+            {
+                return npos;
+            }
+            const size_type found = byte_kernels::find(characters + position, character_count - position, c);
+            return found == npos ? npos : found + position;
+        };
+        [[nodiscard]] constexpr auto find(string_view needle, size_type position = 0) const noexcept -> size_type
+        {
+            if (position > character_count)
+            {
+                return npos;
+            }
+            const size_type found = byte_kernels::find(characters + position, character_count - position, needle.characters, needle.character_count);
+            return found == npos ? npos : found + position;
+        };
+        [[nodiscard]] constexpr auto rfind(char c) const noexcept -> size_type
+        {
+            for (size_type i = character_count; i-- > 0;)
+            {
+                if (characters[i] == c)
+                {
+                    return i;
+                }
+            }
+            return npos;
+        };
+        [[nodiscard]] constexpr auto find_first_of(string_view set, size_type position = 0) const noexcept -> size_type
+        {
+            if (position >= character_count)
+            {
+                return npos;
+            }
+            const size_type found = byte_kernels::find_first_of(characters + position, character_count - position, set.characters, set.character_count);
+            return found == npos ? npos : found + position;
+        };
+        [[nodiscard]] constexpr auto contains(string_view needle) const noexcept -> bool
+        {
+            return find(needle) != npos;
+        };
+        [[nodiscard]] constexpr auto contains(char c) const noexcept -> bool
+        {
+            return find(c) != npos;
+        };
+
+        [[nodiscard]] friend constexpr auto operator ==(string_view left, string_view right) noexcept -> bool
+        {
+            return left.character_count == right.character_count and byte_kernels::mismatch(left.characters, right.characters, left.character_count) == left.character_count;
+        };
+        [[nodiscard]] friend constexpr auto operator <=>(string_view left, string_view right) noexcept -> std::strong_ordering
+        {
+            return left.compare(right) <=> 0;
+        };
+
+    private:
+        const char* characters = nullptr;
+        size_type character_count = 0;
+    };
+
+    namespace literals
+    {
+        constexpr auto operator ""_sv(const char* data, size_t size) noexcept -> string_view
+        {
+            return string_view{ data, size };
+        };
+    };
+};
+
+template <>
+struct std::hash<jpl::string_view>
+{
+    auto operator ()(jpl::string_view view) const noexcept -> std::size_t
+    {
+        return std::hash<std::string_view>{}(view);
+    };
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// this_thread::pause
+namespace jpl
+{
+    namespace this_thread
+    {
+        // a spin-wait hint; cheaper than yielding and keeps the sibling hyperthread fed.
+        inline auto pause() noexcept -> void
+        {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+            asm volatile("yield");
+#endif
+        };
+    };
+};
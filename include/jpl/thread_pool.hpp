@@ -0,0 +1,197 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// thread_pool
+// default_thread_pool
+namespace jpl
+{
+    namespace impl
+    {
+        namespace thread_pool
+        {
+            // shared between the caller and every helper it posts. helpers that only
+            // start once all chunks are claimed leave without touching the body, so
+            // the caller may return as soon as the last claimed chunk finishes.
+            struct fork_join_state
+            {
+                std::atomic<size_t> next{ 0 };
+                std::atomic<size_t> remaining;
+                size_t chunks;
+                void* body;
+                auto (*invoke)(void* body, size_t chunk) -> void;
+
+                std::atomic<bool> failed{ false };
+                std::exception_ptr exception;
+
+                fork_join_state(size_t chunks, void* body, auto (*invoke)(void*, size_t) -> void) noexcept :
+                    remaining{ chunks },
+                    chunks{ chunks },
+                    body{ body },
+                    invoke{ invoke }
+                {};
+
+                auto run() noexcept -> void
+                {
+                    for (size_t chunk = next.fetch_add(1, std::memory_order_relaxed); chunk < chunks; chunk = next.fetch_add(1, std::memory_order_relaxed))
+                    {
+                        if (not failed.load(std::memory_order_relaxed))
+                        {
+                            try
+                            {
+                                invoke(body, chunk);
+                            }
+                            catch (...)
+                            {
+                                if (not failed.exchange(true, std::memory_order_relaxed))
+                                {
+                                    exception = std::current_exception();
+                                }
+                            }
+                        }
+                        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        {
+                            remaining.notify_all();
+                        }
+                    }
+                };
+            };
+        };
+    };
+
+    struct thread_pool
+    {
+        explicit thread_pool(size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            workers.reserve(threads);
+            for (size_t i = 0; i < threads; ++i)
+            {
+                workers.emplace_back([this] { work(); });
+            }
+        };
+        thread_pool(const thread_pool&) = delete;
+        auto operator =(const thread_pool&) -> thread_pool& = delete;
+
+        // finishes everything already posted before joining.
+        ~thread_pool()
+        {
+            {
+                std::lock_guard lock{ mutex };
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+        };
+
+        [[nodiscard]] auto size() const noexcept -> size_t
+        {
+            return workers.size();
+        };
+
+        // also accepts std::coroutine_handle<>, which makes the pool a jpl::scheduler.
+        template <typename F>
+        auto post(F&& work) -> void
+        {
+            {
+                std::lock_guard lock{ mutex };
+                queue.emplace_back(jpl::forward<F>(work));
+            }
+            wake.notify_one();
+        };
+
+        // calls body(chunk) once for every chunk in [0, chunks) across the pool and
+        // the calling thread, returning when all have finished. the caller claims
+        // chunks too, so this makes progress even when every worker is busy, and
+        // nested calls from inside a worker cannot deadlock.
+        template <typename F>
+        auto fork_join(size_t chunks, F&& body) -> void
+        {
+            if (chunks == 0)
+            {
+                return;
+            }
+            if (chunks == 1 or workers.empty())
+            {
+                for (size_t chunk = 0; chunk < chunks; ++chunk)
+                {
+                    body(chunk);
+                }
+                return;
+            }
+
+            using body_type = remove_reference_t<F>;
+            auto state = std::make_shared<impl::thread_pool::fork_join_state>(
+                chunks,
+                const_cast<void*>(static_cast<const void*>(&body)),
+                [](void* erased, size_t chunk) -> void
+                {
+                    (*static_cast<body_type*>(erased))(chunk);
+                }
+            );
+
+            const size_t helpers = std::min(chunks - 1, workers.size());
+            for (size_t i = 0; i < helpers; ++i)
+            {
+                post([state] { state->run(); });
+            }
+            state->run();
+
+            for (size_t left = state->remaining.load(std::memory_order_acquire); left != 0; left = state->remaining.load(std::memory_order_acquire))
+            {
+                state->remaining.wait(left, std::memory_order_acquire);
+            }
+            if (state->exception)
+            {
+                std::rethrow_exception(state->exception);
+            }
+        };
+
+    private:
+        auto work() -> void
+        {
+            for (;;)
+            {
+                std::function<void()> next;
+                {
+                    std::unique_lock lock{ mutex };
+                    wake.wait(lock, [this] { return stopping or not queue.empty(); });
+                    if (queue.empty())
+                    {
+                        return;
+                    }
+                    next = jpl::move(queue.front());
+                    queue.pop_front();
+                }
+                next();
+            }
+        };
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<std::function<void()>> queue;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+    };
+
+    // the calling thread takes part in fork_join, so one core is left for it.
+    inline auto default_thread_pool() -> thread_pool&
+    {
+        static thread_pool pool{ std::max(2u, std::thread::hardware_concurrency()) - 1 };
+        return pool;
+    };
+};
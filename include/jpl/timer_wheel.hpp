@@ -0,0 +1,342 @@
+#pragma once
+
+#include "cstddef.hpp"
+#include "functional.hpp"
+#include "object_pool.hpp"
+#include "utility.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// timer_id
+// timer_wheel
+namespace jpl
+{
+    namespace impl
+    {
+        namespace timer_wheel
+        {
+            // six levels of 64 slots: each level's slot spans a whole turn of
+            // the level below, so 2^36 ticks (two years of milliseconds) are
+            // reachable; later deadlines wait in the top level's first slot and
+            // are placed again each time it comes round.
+            inline constexpr unsigned slot_bits = 6;
+            inline constexpr size_t slot_count = size_t{ 1 } << slot_bits;
+            inline constexpr size_t level_count = 6;
+
+            struct link
+            {
+                link* previous = this;
+                link* next = this;
+
+                auto empty() const noexcept -> bool
+                {
+                    return next == this;
+                };
+                auto push_back(link* node) noexcept -> void
+                {
+                    node->previous = previous;
+                    node->next = this;
+                    previous->next = node;
+                    previous = node;
+                };
+                auto unlink() noexcept -> void
+                {
+                    previous->next = next;
+                    next->previous = previous;
+                    previous = this;
+                    next = this;
+                };
+                // moves every node of other to the back of this, leaving other
+                // empty.
+                auto splice(link& other) noexcept -> void
+                {
+                    if (other.empty())
+                    {
+                        return;
+                    }
+                    other.next->previous = previous;
+                    other.previous->next = this;
+                    previous->next = other.next;
+                    previous = other.previous;
+                    other.next = &other;
+                    other.previous = &other;
+                };
+            };
+        };
+    };
+
+    struct timer_id
+    {
+        void* node = nullptr;
+        uint32_t generation = 0;
+
+        [[nodiscard]] explicit operator bool() const noexcept
+        {
+            return node != nullptr;
+        };
+        [[nodiscard]] friend auto operator ==(const timer_id&, const timer_id&) noexcept -> bool = default;
+    };
+
+    // a hierarchical timing wheel. scheduling and cancelling are constant
+    // time: a timer is linked into the slot of the level whose span contains
+    // its deadline, and only moves down a level when that slot comes round,
+    // so a timer cancelled before then is never touched again. timers live in
+    // pooled intrusive nodes; a node is recycled once its timer fires or is
+    // cancelled, and ids carry a generation so stale ones are recognized.
+    // time is whole ticks of the caller's choosing. not thread safe.
+    template <typename Callback = inplace_function<void()>>
+    struct timer_wheel
+    {
+        using callback_type = Callback;
+
+        explicit timer_wheel(uint64_t now = 0) noexcept :
+            current{ now }
+        {};
+        timer_wheel(const timer_wheel&) = delete;
+        auto operator =(const timer_wheel&) -> timer_wheel& = delete;
+        ~timer_wheel()
+        {
+            const auto destroy = [this](link& list)
+            {
+                while (not list.empty())
+                {
+                    auto* timer = static_cast<node*>(list.next);
+                    timer->unlink();
+                    nodes.destroy(timer);
+                }
+            };
+            for (auto& level : slots)
+            {
+                for (auto& slot : level)
+                {
+                    destroy(slot);
+                }
+            }
+            destroy(due);
+            while (free != nullptr)
+            {
+                nodes.destroy(jpl::exchange(free, static_cast<node*>(free->next)));
+            }
+        };
+
+        // calls callback once delay ticks have passed; a delay of zero fires on
+        // the next tick.
+        auto schedule(uint64_t delay, Callback callback) -> timer_id
+        {
+            node* timer = acquire();
+            timer->callback = jpl::move(callback);
+            timer->deadline = current + (delay == 0 ? 1 : delay);
+            place(timer);
+            ++live;
+            return timer_id{ timer, timer->generation };
+        };
+        // returns whether the timer was pending; it will not fire.
+        auto cancel(timer_id id) noexcept -> bool
+        {
+            node* timer = pending(id);
+            if (timer == nullptr)
+            {
+                return false;
+            }
+            detach(timer);
+            release(timer);
+            --live;
+            return true;
+        };
+        // moves a pending timer's deadline to delay ticks from now, keeping its
+        // callback and id; returns whether it was pending.
+        auto reschedule(timer_id id, uint64_t delay) noexcept -> bool
+        {
+            node* timer = pending(id);
+            if (timer == nullptr)
+            {
+                return false;
+            }
+            detach(timer);
+            timer->deadline = current + (delay == 0 ? 1 : delay);
+            place(timer);
+            return true;
+        };
+
+        // moves the clock forward to now, firing every timer due on the way in
+        // deadline order. a tick's timers are taken off the wheel together and
+        // fired from a separate list, so callbacks may schedule or cancel
+        // freely; if one throws, the rest of its batch fires on the next call.
+        // returns how many fired.
+        auto advance_to(uint64_t now) -> size_t
+        {
+            size_t fired = fire();
+            while (current < now)
+            {
+                if (live == 0)
+                {
+                    current = now;
+                    break;
+                }
+                // with the levels below l empty, nothing fires or cascades
+                // before level l next turns, so the ticks up to then are
+                // skipped whole.
+                size_t level = 0;
+                while (occupied[level] == 0 and level + 1 < impl::timer_wheel::level_count)
+                {
+                    ++level;
+                }
+                const uint64_t turn = (current | ((uint64_t{ 1 } << (level * impl::timer_wheel::slot_bits)) - 1)) + 1;
+                if (turn > now)
+                {
+                    current = now;
+                    break;
+                }
+                current = turn - 1;
+                fired += tick();
+            }
+            return fired;
+        };
+        auto advance(uint64_t ticks) -> size_t
+        {
+            return advance_to(current + ticks);
+        };
+
+        [[nodiscard]] auto now() const noexcept -> uint64_t
+        {
+            return current;
+        };
+        [[nodiscard]] auto size() const noexcept -> size_t
+        {
+            return live;
+        };
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return live == 0;
+        };
+
+    private:
+        using link = impl::timer_wheel::link;
+
+        struct node : link
+        {
+            Callback callback;
+            uint64_t deadline = 0;
+            uint32_t generation = 0;
+            uint8_t level = 0;
+            uint8_t slot = 0;
+        };
+
+        auto acquire() -> node*
+        {
+            if (free != nullptr)
+            {
+                node* timer = jpl::exchange(free, static_cast<node*>(free->next));
+                timer->previous = timer;
+                timer->next = timer;
+                return timer;
+            }
+            return nodes.create();
+        };
+        auto release(node* timer) noexcept -> void
+        {
+            timer->callback = nullptr;
+            ++timer->generation;
+            timer->next = free;
+            free = timer;
+        };
+        auto pending(timer_id id) const noexcept -> node*
+        {
+            auto* timer = static_cast<node*>(id.node);
+            return timer != nullptr and timer->generation == id.generation ? timer : nullptr;
+        };
+
+        // the level is picked by the highest bits in which the deadline and
+        // the clock differ, so a level's slot index never needs adjusting as
+        // the levels below turn.
+        auto place(node* timer) noexcept -> void
+        {
+            const uint64_t differing = timer->deadline ^ current;
+            size_t level = differing == 0 ? 0 : (static_cast<size_t>(std::bit_width(differing)) - 1) / impl::timer_wheel::slot_bits;
+            size_t slot;
+            if (level < impl::timer_wheel::level_count)
+            {
+                slot = (timer->deadline >> (level * impl::timer_wheel::slot_bits)) & (impl::timer_wheel::slot_count - 1);
+            }
+            else
+            {
+                // the deadline is past the next turn of the top level, and slot 0
+                // is the one that comes due on it.
+                level = impl::timer_wheel::level_count - 1;
+                slot = 0;
+            }
+            timer->level = static_cast<uint8_t>(level);
+            timer->slot = static_cast<uint8_t>(slot);
+            slots[level][slot].push_back(timer);
+            occupied[level] |= uint64_t{ 1 } << slot;
+        };
+        auto detach(node* timer) noexcept -> void
+        {
+            timer->unlink();
+            // a timer in a batch being fired belongs to no slot any more, but
+            // its old slot is then empty and clearing its bit again is harmless.
+            if (slots[timer->level][timer->slot].empty())
+            {
+                occupied[timer->level] &= ~(uint64_t{ 1 } << timer->slot);
+            }
+        };
+
+        auto take(size_t level, size_t slot, link& into) noexcept -> void
+        {
+            into.splice(slots[level][slot]);
+            occupied[level] &= ~(uint64_t{ 1 } << slot);
+        };
+
+        auto tick() -> size_t
+        {
+            ++current;
+            // when lower levels wrap, the next slot of each level above comes
+            // due; higher levels go first, as their timers can land in the
+            // slots of lower ones being cascaded on this same tick.
+            size_t wrapped = 0;
+            while (wrapped + 1 < impl::timer_wheel::level_count and (current & ((uint64_t{ 1 } << ((wrapped + 1) * impl::timer_wheel::slot_bits)) - 1)) == 0)
+            {
+                ++wrapped;
+            }
+            for (size_t level = wrapped; level > 0; --level)
+            {
+                link cascading;
+                take(level, (current >> (level * impl::timer_wheel::slot_bits)) & (impl::timer_wheel::slot_count - 1), cascading);
+                while (not cascading.empty())
+                {
+                    auto* timer = static_cast<node*>(cascading.next);
+                    timer->unlink();
+                    place(timer);
+                }
+            }
+
+            take(0, current & (impl::timer_wheel::slot_count - 1), due);
+            return fire();
+        };
+        auto fire() -> size_t
+        {
+            size_t fired = 0;
+            while (not due.empty())
+            {
+                auto* timer = static_cast<node*>(due.next);
+                timer->unlink();
+                Callback callback = jpl::move(timer->callback);
+                release(timer);
+                --live;
+                ++fired;
+                callback();
+            }
+            return fired;
+        };
+
+        uint64_t current;
+        size_t live = 0;
+        std::array<std::array<link, impl::timer_wheel::slot_count>, impl::timer_wheel::level_count> slots{};
+        std::array<uint64_t, impl::timer_wheel::level_count> occupied{};
+        link due;
+        node* free = nullptr;
+        object_pool<node> nodes;
+    };
+};
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "utility.hpp"
 
 namespace jpl
@@ -344,7 +344,7 @@ namespace jpl
     using remove_reference_t = typename remove_reference<T>::type;
 
     template <typename T>
-    struct remove_cvref : remove_cv<remove_reference<T>>
+    struct remove_cvref : remove_cv<remove_reference_t<T>>
     {};
     template <typename T>
     using remove_cvref_t = typename remove_cvref<T>::type;
@@ -827,7 +827,7 @@ namespace jpl
 namespace jpl
 {
     template <typename T, typename... As>
-    inline constexpr bool is_constructible_v = (is_object_v<T> or is_reference_v<T>) and requires { T{ declval<As>()... }; };
+    inline constexpr bool is_constructible_v = __is_constructible(T, As...);
     template <typename T, typename... As>
     struct is_constructible : bool_constant<is_constructible_v<T, As...>>
     {};
@@ -1144,4 +1144,157 @@ namespace jpl
     template <typename T, typename U>
     struct is_nothrow_convertible : bool_constant<is_nothrow_convertible_v<T, U>>
     {};
-};
\ No newline at end of file
+};
+
+// is_trivially_copyable
+// is_trivially_copyable_v
+// underlying_type
+// underlying_type_t
+namespace jpl
+{
+    template <typename T>
+    inline constexpr bool is_trivially_copyable_v = __is_trivially_copyable(T);
+    template <typename T>
+    struct is_trivially_copyable : bool_constant<is_trivially_copyable_v<T>>
+    {};
+
+    template <typename T>
+    struct underlying_type
+    {};
+    template <typename T>
+    requires is_enum_v<T>
+    struct underlying_type<T>
+    {
+        using type = __underlying_type(T);
+    };
+    template <typename T>
+    using underlying_type_t = typename underlying_type<T>::type;
+};
+
+// is_signed
+// is_signed_v
+// is_unsigned
+// is_unsigned_v
+// make_signed
+// make_signed_t
+// make_unsigned
+// make_unsigned_t
+namespace jpl
+{
+    template <typename T>
+    inline constexpr bool is_signed_v = requires { requires is_arithmetic_v<T> and T(-1) < T(0); };
+    template <typename T>
+    struct is_signed : bool_constant<is_signed_v<T>>
+    {};
+
+    template <typename T>
+    inline constexpr bool is_unsigned_v = requires { requires is_arithmetic_v<T> and T(0) < T(-1); };
+    template <typename T>
+    struct is_unsigned : bool_constant<is_unsigned_v<T>>
+    {};
+
+    namespace impl
+    {
+        template <typename T>
+        struct integer_pair;
+        template <typename T>
+        requires is_any_of_v<T, signed char, unsigned char>
+        struct integer_pair<T>
+        {
+            using signed_type = signed char;
+            using unsigned_type = unsigned char;
+        };
+        template <typename T>
+        requires is_any_of_v<T, short, unsigned short>
+        struct integer_pair<T>
+        {
+            using signed_type = short;
+            using unsigned_type = unsigned short;
+        };
+        template <typename T>
+        requires is_any_of_v<T, int, unsigned int>
+        struct integer_pair<T>
+        {
+            using signed_type = int;
+            using unsigned_type = unsigned int;
+        };
+        template <typename T>
+        requires is_any_of_v<T, long, unsigned long>
+        struct integer_pair<T>
+        {
+            using signed_type = long;
+            using unsigned_type = unsigned long;
+        };
+        template <typename T>
+        requires is_any_of_v<T, long long, unsigned long long>
+        struct integer_pair<T>
+        {
+            using signed_type = long long;
+            using unsigned_type = unsigned long long;
+        };
+        // char, wchar_t, the charN_t types and enums map to the smallest
+        // standard integer of the same size.
+        template <typename T>
+        using sized_integer_pair = integer_pair<conditional_t<sizeof(T) == 1, unsigned char,
+                                                conditional_t<sizeof(T) == 2, unsigned short,
+                                                conditional_t<sizeof(T) == 4, unsigned int, unsigned long long>>>>;
+
+        template <typename T>
+        struct make_integer : sized_integer_pair<T>
+        {};
+        template <typename T>
+        requires requires { typename integer_pair<T>::signed_type; }
+        struct make_integer<T> : integer_pair<T>
+        {};
+
+        template <typename From, typename To>
+        using copy_cv = conditional_t<is_const_v<From> and is_volatile_v<From>, add_cv_t<To>,
+                        conditional_t<is_const_v<From>, add_const_t<To>,
+                        conditional_t<is_volatile_v<From>, add_volatile_t<To>, To>>>;
+    };
+
+    template <typename T>
+    struct make_signed
+    {};
+    template <typename T>
+    requires (is_integral_v<T> and not is_same_v<remove_cv_t<T>, bool>) or is_enum_v<T>
+    struct make_signed<T>
+    {
+        using type = impl::copy_cv<T, typename impl::make_integer<remove_cv_t<T>>::signed_type>;
+    };
+    template <typename T>
+    using make_signed_t = typename make_signed<T>::type;
+
+    template <typename T>
+    struct make_unsigned
+    {};
+    template <typename T>
+    requires (is_integral_v<T> and not is_same_v<remove_cv_t<T>, bool>) or is_enum_v<T>
+    struct make_unsigned<T>
+    {
+        using type = impl::copy_cv<T, typename impl::make_integer<remove_cv_t<T>>::unsigned_type>;
+    };
+    template <typename T>
+    using make_unsigned_t = typename make_unsigned<T>::type;
+};
+// has_virtual_destructor
+// has_virtual_destructor_v
+namespace jpl
+{
+    template <typename T>
+    inline constexpr bool has_virtual_destructor_v = __has_virtual_destructor(T);
+    template <typename T>
+    struct has_virtual_destructor : bool_constant<has_virtual_destructor_v<T>>
+    {};
+};
+
+// is_empty
+// is_empty_v
+namespace jpl
+{
+    template <typename T>
+    inline constexpr bool is_empty_v = __is_empty(T);
+    template <typename T>
+    struct is_empty : bool_constant<is_empty_v<T>>
+    {};
+};
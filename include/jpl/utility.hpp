@@ -67,10 +67,33 @@ namespace jpl
         }
     };
 
+    template <typename T, typename U = T>
+    constexpr auto exchange(T& object, U&& replacement) noexcept(is_nothrow_move_constructible_v<T> and is_nothrow_assignable_v<T&, U>) -> T
+    {
+        T old = jpl::move(object);
+        object = jpl::forward<U>(replacement);
+        return old;
+    };
+
     template <typename T, typename U>
     struct compressed_pair
     {
         [[no_unique_address]] T first;
         [[no_unique_address]] U second;
     };
+
+    // tags an input as already sorted and free of duplicates, skipping the sort.
+    struct sorted_unique_t
+    {
+        explicit sorted_unique_t() = default;
+    };
+    inline constexpr sorted_unique_t sorted_unique{};
+
+    // selects the constructor that builds the contained value from the rest of
+    // the arguments.
+    struct in_place_t
+    {
+        explicit in_place_t() = default;
+    };
+    inline constexpr in_place_t in_place{};
 };
\ No newline at end of file
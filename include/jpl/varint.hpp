@@ -0,0 +1,238 @@
+#pragma once
+
+#include "byte_kernels.hpp"
+#include "cstddef.hpp"
+#include "type_traits.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#if defined(__SSSE3__)
+#define JPL_HAS_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+// zigzag_encode
+// zigzag_decode
+// varint::max_bytes
+// varint::size
+// varint::encode
+// varint::decode
+// varint::decode_batch
+namespace jpl
+{
+    // interleaves signed values so that small magnitudes of either sign encode
+    // as small unsigned ones: 0, -1, 1, -2, ... becomes 0, 1, 2, 3, ...
+    template <typename T>
+    requires is_integral_v<T> and is_signed_v<T>
+    [[nodiscard]] constexpr auto zigzag_encode(T value) noexcept -> make_unsigned_t<T>
+    {
+        using U = make_unsigned_t<T>;
+        return static_cast<U>(static_cast<U>(static_cast<U>(value) << 1) ^ static_cast<U>(value >> (sizeof(T) * 8 - 1)));
+    };
+    template <typename U>
+    requires is_integral_v<U> and is_unsigned_v<U>
+    [[nodiscard]] constexpr auto zigzag_decode(U value) noexcept -> make_signed_t<U>
+    {
+        return static_cast<make_signed_t<U>>(static_cast<U>(value >> 1) ^ static_cast<U>(U{ 0 } - (value & 1)));
+    };
+
+    // unsigned LEB128: seven bits per byte, least significant group first, the
+    // high bit set on every byte but the last.
+    namespace varint
+    {
+        template <typename T>
+        inline constexpr size_t max_bytes = (sizeof(T) * 8 + 6) / 7;
+
+        template <typename T>
+        requires is_integral_v<T> and is_unsigned_v<T>
+        [[nodiscard]] constexpr auto size(T value) noexcept -> size_t
+        {
+            size_t bytes = 1;
+            for (; value >= 0x80; value >>= 7)
+            {
+                ++bytes;
+            }
+            return bytes;
+        };
+
+        // writes at most max_bytes<T> bytes and returns how many were written.
+        template <typename T>
+        requires is_integral_v<T> and is_unsigned_v<T>
+        constexpr auto encode(T value, byte* out) noexcept -> size_t
+        {
+            size_t i = 0;
+            for (; value >= 0x80; value >>= 7)
+            {
+                out[i++] = static_cast<byte>((value & 0x7f) | 0x80);
+            }
+            out[i++] = static_cast<byte>(value);
+            return i;
+        };
+
+        // reads one value from [in, end) and returns the bytes consumed, or 0
+        // when the input ends mid-value or the value does not fit in T.
+        template <typename T>
+        requires is_integral_v<T> and is_unsigned_v<T>
+        constexpr auto decode(const byte* in, const byte* end, T& value) noexcept -> size_t
+        {
+            constexpr size_t bits = sizeof(T) * 8;
+            T result = 0;
+            for (size_t i = 0; i < max_bytes<T> and in + i != end; ++i)
+            {
+                const auto group = static_cast<T>(to_integer<unsigned char>(in[i]) & 0x7f);
+                const size_t shift = i * 7;
+                if (shift + 7 > bits and (group >> (bits - shift)) != 0)
+                {
+                    return 0;
+                }
+                result |= static_cast<T>(group << shift);
+                if ((to_integer<unsigned char>(in[i]) & 0x80) == 0)
+                {
+                    value = result;
+                    return i + 1;
+                }
+            }
+            return 0;
+        };
+    };
+
+    namespace impl
+    {
+        namespace varint
+        {
+#if defined(JPL_HAS_SSSE3)
+            // one row per pattern of continuation bits in the first 12 bytes of a
+            // block: the shuffle that moves each of up to four leading values of
+            // at most three bytes into its own 32-bit lane, how many values that
+            // is, and how many bytes they span.
+            struct pattern
+            {
+                unsigned char shuffle[16];
+                unsigned char count;
+                unsigned char consumed;
+            };
+            inline constexpr auto patterns = []
+            {
+                std::array<pattern, 4096> table{};
+                for (unsigned int mask = 0; mask < 4096; ++mask)
+                {
+                    pattern& row = table[mask];
+                    for (auto& lane : row.shuffle)
+                    {
+                        lane = 0x80;
+                    }
+                    unsigned int position = 0;
+                    unsigned int count = 0;
+                    while (count < 4)
+                    {
+                        unsigned int length = 1;
+                        while (position + length - 1 < 12 and ((mask >> (position + length - 1)) & 1) != 0)
+                        {
+                            ++length;
+                        }
+                        if (position + length - 1 >= 12 or length > 3)
+                        {
+                            break;
+                        }
+                        for (unsigned int k = 0; k < length; ++k)
+                        {
+                            row.shuffle[count * 4 + k] = static_cast<unsigned char>(position + k);
+                        }
+                        position += length;
+                        ++count;
+                    }
+                    row.count = static_cast<unsigned char>(count);
+                    row.consumed = static_cast<unsigned char>(position);
+                }
+                return table;
+            }();
+
+            // drops the continuation bits of up to three gathered bytes per lane
+            // and packs their seven-bit groups together.
+            inline auto compact(__m128i lanes) noexcept -> __m128i
+            {
+                const __m128i groups = _mm_and_si128(lanes, _mm_set1_epi32(0x007f7f7f));
+                __m128i values = _mm_and_si128(groups, _mm_set1_epi32(0x7f));
+                values = _mm_or_si128(values, _mm_and_si128(_mm_srli_epi32(groups, 1), _mm_set1_epi32(0x7f << 7)));
+                return _mm_or_si128(values, _mm_and_si128(_mm_srli_epi32(groups, 2), _mm_set1_epi32(0x7f << 14)));
+            };
+#endif
+        };
+    };
+
+    namespace varint
+    {
+        // decodes count 32-bit values from [in, end) into out and returns the
+        // bytes consumed, or 0 if any value is truncated or overflows. blocks
+        // of sixteen one-byte values are widened directly; with ssse3, other
+        // blocks decode up to four values per shuffle, masked-vbyte style.
+        inline auto decode_batch(const byte* in, const byte* end, std::uint32_t* out, size_t count) noexcept -> size_t
+        {
+            const byte* position = in;
+            size_t i = 0;
+#if defined(JPL_HAS_SSE2)
+            while (count - i >= 16 and end - position >= 16)
+            {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+                const auto continuations = static_cast<unsigned int>(_mm_movemask_epi8(block));
+                if (continuations == 0)
+                {
+                    const __m128i zero = _mm_setzero_si128();
+                    const __m128i low = _mm_unpacklo_epi8(block, zero);
+                    const __m128i high = _mm_unpackhi_epi8(block, zero);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi16(low, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4), _mm_unpackhi_epi16(low, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpacklo_epi16(high, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 12), _mm_unpackhi_epi16(high, zero));
+                    position += 16;
+                    i += 16;
+                    continue;
+                }
+#if defined(JPL_HAS_SSSE3)
+                const impl::varint::pattern& row = impl::varint::patterns[continuations & 0xfff];
+                if (row.count != 0)
+                {
+                    // all four lanes are stored; the ones past row.count are
+                    // overwritten by the next step, and count - i >= 16 keeps
+                    // them inside out.
+                    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.shuffle));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), impl::varint::compact(_mm_shuffle_epi8(block, shuffle)));
+                    position += row.consumed;
+                    i += row.count;
+                    continue;
+                }
+#endif
+                // every value that ends inside the block can be read without
+                // checking for the end of the input.
+                const byte* block_end = position + 16;
+                for (int complete = std::popcount(~continuations & 0xffff); complete > 0; --complete)
+                {
+                    const size_t consumed = varint::decode(position, block_end, out[i]);
+                    if (consumed == 0)
+                    {
+                        return 0;
+                    }
+                    position += consumed;
+                    ++i;
+                }
+                if ((continuations & 0xffff) == 0xffff)
+                {
+                    return 0;
+                }
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                const size_t consumed = varint::decode(position, end, out[i]);
+                if (consumed == 0)
+                {
+                    return 0;
+                }
+                position += consumed;
+            }
+            return static_cast<size_t>(position - in);
+        };
+    };
+};
@@ -3,7 +3,62 @@
 #include "jpl/type_list.hpp"
 #include "jpl/memory.hpp"
 #include "jpl/cstddef.hpp"
+#include "jpl/hazard_pointer.hpp"
+#include "jpl/seqlock.hpp"
+#include "jpl/spinlock.hpp"
+#include "jpl/coroutine.hpp"
+#include "jpl/thread_pool.hpp"
+#include "jpl/parallel.hpp"
+#include "jpl/algorithm.hpp"
+#include "jpl/flat_set.hpp"
+#include "jpl/flat_map.hpp"
+#include "jpl/object_pool.hpp"
+#include "jpl/btree_map.hpp"
+#include "jpl/slot_map.hpp"
+#include "jpl/bitset.hpp"
+#include "jpl/byte_kernels.hpp"
+#include "jpl/string_view.hpp"
+#include "jpl/string.hpp"
+#include "jpl/span.hpp"
+#include "jpl/mdspan.hpp"
+#if __has_include(<sys/mman.h>)
+#include "jpl/mapped_file.hpp"
+#endif
+#include "jpl/serializer.hpp"
+#include "jpl/bit.hpp"
+#include "jpl/varint.hpp"
+#include "jpl/allocation_tracking.hpp"
+#include "jpl/memory_resource.hpp"
+#if __has_include(<sys/mman.h>)
+#include "jpl/page_allocator.hpp"
+#endif
+#include "jpl/heap.hpp"
+#include "jpl/optional.hpp"
+#include "jpl/expected.hpp"
+#include "jpl/new.hpp"
+#include "jpl/cache_aligned.hpp"
+#include "jpl/concurrent_hash_map.hpp"
+#include "jpl/functional.hpp"
+#include "jpl/timer_wheel.hpp"
+#include "jpl/intrusive.hpp"
+#include "jpl/clock_cache.hpp"
 #include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 #define EXPECT_SAME(T, U) EXPECT_TRUE((jpl::is_same_v<T, U>))
 #define EXPECT_DIFFERENT(T, U) EXPECT_FALSE((jpl::is_same_v<T, U>))
@@ -315,4 +370,1972 @@ TEST(type_traits, remove_rvalue_reference)
     EXPECT_SAME(jpl::remove_rvalue_reference_t<const int&>, const int&);
     EXPECT_SAME(jpl::remove_rvalue_reference_t<int&&>, int);
     EXPECT_SAME(jpl::remove_rvalue_reference_t<const int&&>, const int);
-};
\ No newline at end of file
+};
+
+struct Counted
+{
+    static inline std::atomic<int> alive = 0;
+    int value;
+
+    explicit Counted(int value) noexcept :
+        value{ value }
+    {
+        ++alive;
+    };
+    ~Counted() noexcept
+    {
+        --alive;
+    };
+};
+
+TEST(hazard_pointer, atomic_unique_ptr)
+{
+    {
+        jpl::atomic_unique_ptr<Counted> cell{ jpl::unique_ptr<Counted>{ new Counted{ 0 } } };
+        {
+            auto reader = cell.load();
+            ASSERT_TRUE(reader);
+            cell.store(jpl::unique_ptr<Counted>{ new Counted{ 1 } });
+            jpl::hazard_pointer_default_domain().reclaim();
+            // still protected, so the replaced object must survive.
+            EXPECT_EQ(reader->value, 0);
+            EXPECT_EQ(Counted::alive, 2);
+        }
+        jpl::hazard_pointer_default_domain().reclaim();
+        EXPECT_EQ(Counted::alive, 1);
+        EXPECT_EQ(cell.load()->value, 1);
+
+        auto* expected = cell.unsafe_get();
+        jpl::unique_ptr<Counted> desired{ new Counted{ 2 } };
+        EXPECT_TRUE(cell.compare_exchange(expected, desired));
+        EXPECT_FALSE(desired);
+    }
+    jpl::hazard_pointer_default_domain().reclaim();
+    EXPECT_EQ(Counted::alive, 0);
+
+    {
+        jpl::atomic_unique_ptr<Counted> cell{ jpl::unique_ptr<Counted>{ new Counted{ 0 } } };
+        std::atomic<bool> done = false;
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&]
+            {
+                int last = 0;
+                while (not done.load(std::memory_order_relaxed))
+                {
+                    auto current = cell.load();
+                    EXPECT_GE(current->value, last);
+                    last = current->value;
+                }
+            });
+        }
+        for (int i = 1; i <= 2000; ++i)
+        {
+            cell.store(jpl::unique_ptr<Counted>{ new Counted{ i } });
+        }
+        done = true;
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+    }
+    jpl::hazard_pointer_default_domain().reclaim();
+    EXPECT_EQ(Counted::alive, 0);
+};
+
+TEST(seqlock, snapshot)
+{
+    struct Snapshot
+    {
+        long long a;
+        long long b;
+        long long c;
+    };
+    static_assert(not jpl::impl::seqlock::snapshot_value<std::vector<int>>);
+
+    jpl::seqlock<Snapshot> cell{ Snapshot{ 0, 0, 0 } };
+    const auto initial = cell.version();
+    cell.store(Snapshot{ 1, 1, 1 });
+    jpl::seqlock<Snapshot>::version_type version;
+    EXPECT_EQ(cell.load(version).b, 1);
+    EXPECT_EQ(version, initial + 2);
+    cell.update([](Snapshot& s) { s.c = 7; });
+    EXPECT_EQ(cell.load().c, 7);
+    EXPECT_EQ(cell.version(), initial + 4);
+    // a throwing update leaves the value alone and the lock free.
+    EXPECT_THROW(cell.update([](Snapshot& s) { s.c = 9; throw std::runtime_error{ "update" }; }), std::runtime_error);
+    EXPECT_EQ(cell.load().c, 7);
+    EXPECT_EQ(cell.version(), initial + 6);
+    cell.update([](Snapshot& s) { s.a = 2; });
+    EXPECT_EQ(cell.load().a, 2);
+
+    cell.store(Snapshot{ 0, 0, 0 });
+    std::atomic<bool> done = false;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&]
+        {
+            while (not done.load(std::memory_order_relaxed))
+            {
+                const Snapshot s = cell.load();
+                // a torn read would mix fields from different stores.
+                EXPECT_EQ(s.a, s.b);
+                EXPECT_EQ(s.b, s.c);
+            }
+        });
+    }
+    for (long long i = 0; i < 20000; ++i)
+    {
+        cell.store(Snapshot{ i, i, i });
+    }
+    done = true;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+};
+
+template <typename Lock>
+auto hammer_lock() -> long long
+{
+    static_assert(jpl::lockable<Lock>);
+    Lock lock;
+    long long counter = 0;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&]
+        {
+            for (int n = 0; n < 20000; ++n)
+            {
+                std::lock_guard guard{ lock };
+                ++counter;
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+    return counter;
+};
+
+TEST(spinlock, mutual_exclusion)
+{
+    EXPECT_EQ(hammer_lock<jpl::spinlock>(), 80000);
+    EXPECT_EQ(hammer_lock<jpl::ticket_lock>(), 80000);
+    EXPECT_EQ(hammer_lock<jpl::mcs_lock>(), 80000);
+
+    // mcs nodes are per acquisition, so nesting distinct locks must work.
+    jpl::mcs_lock outer;
+    jpl::mcs_lock inner;
+    outer.lock();
+    inner.lock();
+    inner.unlock();
+    outer.unlock();
+};
+
+struct CountingFrameAllocator : jpl::frame_allocator
+{
+    int allocations = 0;
+    int deallocations = 0;
+
+    auto allocate(jpl::size_t size) -> void* override
+    {
+        ++allocations;
+        return ::operator new(size);
+    };
+    auto deallocate(void* frame, jpl::size_t) noexcept -> void override
+    {
+        ++deallocations;
+        ::operator delete(frame);
+    };
+};
+
+auto add_one(int value) -> jpl::task<int>
+{
+    co_return value + 1;
+};
+auto add_two(int value) -> jpl::task<int>
+{
+    const int once = co_await add_one(value);
+    co_return co_await add_one(once);
+};
+auto deep_chain(int depth) -> jpl::task<int>
+{
+    int total = 0;
+    for (int i = 0; i < depth; ++i)
+    {
+        total += co_await add_one(0);
+    }
+    co_return total;
+};
+auto throws() -> jpl::task<void>
+{
+    throw std::runtime_error{ "task failed" };
+    co_return;
+};
+auto allocated(std::allocator_arg_t, jpl::frame_allocator&, int value) -> jpl::task<int>
+{
+    co_return value;
+};
+auto hop(jpl::thread_pool& pool, std::thread::id& resumed_on) -> jpl::task<int>
+{
+    co_await jpl::schedule_on(pool);
+    resumed_on = std::this_thread::get_id();
+    co_return 42;
+};
+auto iota(int count) -> jpl::generator<int>
+{
+    for (int i = 0; i < count; ++i)
+    {
+        co_yield i;
+    }
+};
+
+TEST(coroutine, task)
+{
+    EXPECT_EQ(jpl::sync_wait(add_two(1)), 3);
+    // deep enough to matter, shallow enough for sanitizer builds, which do
+    // not always turn symmetric transfer into a tail call.
+    EXPECT_EQ(jpl::sync_wait(deep_chain(1000)), 1000);
+    EXPECT_THROW(jpl::sync_wait(throws()), std::runtime_error);
+
+    static_assert(jpl::scheduler<jpl::thread_pool>);
+    jpl::thread_pool pool{ 1 };
+    std::thread::id resumed_on;
+    EXPECT_EQ(jpl::sync_wait(hop(pool, resumed_on)), 42);
+    EXPECT_NE(resumed_on, std::this_thread::get_id());
+};
+
+TEST(coroutine, frame_allocator)
+{
+    CountingFrameAllocator allocator;
+    EXPECT_EQ(jpl::sync_wait(allocated(std::allocator_arg, allocator, 5)), 5);
+    EXPECT_EQ(allocator.allocations, 1);
+    EXPECT_EQ(allocator.deallocations, 1);
+
+    {
+        jpl::scoped_frame_allocator scope{ allocator };
+        EXPECT_EQ(jpl::sync_wait(add_two(0)), 2);
+    }
+    // add_two, both add_ones and the sync_wait driver.
+    EXPECT_EQ(allocator.allocations, 5);
+    EXPECT_EQ(allocator.deallocations, 5);
+};
+
+TEST(coroutine, generator)
+{
+    int expected = 0;
+    for (int value : iota(5))
+    {
+        EXPECT_EQ(value, expected++);
+    }
+    EXPECT_EQ(expected, 5);
+};
+
+TEST(parallel, algorithms)
+{
+    jpl::thread_pool pool{ 3 };
+
+    std::vector<long long> values(1 << 18);
+    std::iota(values.begin(), values.end(), 0);
+
+    std::vector<long long> doubled(values.size());
+    jpl::parallel::transform(pool, values.begin(), values.end(), doubled.begin(), [](long long v) { return v * 2; });
+    EXPECT_EQ(doubled[12345], 24690);
+
+    jpl::parallel::for_each(pool, doubled.begin(), doubled.end(), [](long long& v) { v /= 2; });
+    EXPECT_EQ(doubled, values);
+
+    const long long sum = jpl::parallel::reduce(pool, values.begin(), values.end(), 0LL);
+    EXPECT_EQ(sum, std::accumulate(values.begin(), values.end(), 0LL));
+
+    std::vector<long long> scanned(values.size());
+    std::vector<long long> expected(values.size());
+    jpl::parallel::inclusive_scan(pool, values.begin(), values.end(), scanned.begin());
+    std::inclusive_scan(values.begin(), values.end(), expected.begin());
+    EXPECT_EQ(scanned, expected);
+
+    std::vector<int> shuffled(300000);
+    std::mt19937 random{ 7 };
+    for (auto& v : shuffled)
+    {
+        v = static_cast<int>(random());
+    }
+    auto sorted = shuffled;
+    std::sort(sorted.begin(), sorted.end());
+    jpl::parallel::sort(pool, shuffled.begin(), shuffled.end());
+    EXPECT_EQ(shuffled, sorted);
+
+    // small inputs take the serial path.
+    std::vector<int> small{ 3, 1, 2 };
+    jpl::parallel::sort(small.begin(), small.end());
+    EXPECT_EQ(small, (std::vector<int>{ 1, 2, 3 }));
+
+    EXPECT_THROW(pool.fork_join(16, [](jpl::size_t chunk)
+    {
+        if (chunk == 5)
+        {
+            throw std::runtime_error{ "chunk failed" };
+        }
+    }), std::runtime_error);
+};
+
+TEST(algorithm, sort)
+{
+    std::mt19937 random{ 11 };
+    for (int size : { 0, 1, 2, 23, 24, 129, 1000, 100000 })
+    {
+        std::vector<int> values(size);
+        for (auto& v : values)
+        {
+            v = static_cast<int>(random() % 1000);
+        }
+        auto expected = values;
+        std::sort(expected.begin(), expected.end());
+        jpl::sort(values.begin(), values.end());
+        EXPECT_EQ(values, expected);
+
+        // sorted, reversed and all-equal inputs hit the pattern-breaking paths.
+        jpl::sort(values.begin(), values.end(), std::greater<>{});
+        EXPECT_TRUE(std::is_sorted(values.begin(), values.end(), std::greater<>{}));
+        jpl::sort(values.begin(), values.end());
+        EXPECT_EQ(values, expected);
+    }
+
+    std::vector<std::string> words{ "pear", "apple", "fig", "kiwi", "banana" };
+    for (int i = 0; i < 200; ++i)
+    {
+        words.push_back(std::to_string(random() % 50));
+    }
+    auto expected_words = words;
+    std::sort(expected_words.begin(), expected_words.end());
+    jpl::sort(words.begin(), words.end());
+    EXPECT_EQ(words, expected_words);
+};
+
+template <typename K>
+concept RadixSortable = requires(std::vector<K>& values) { jpl::radix_sort(values.begin(), values.end()); };
+
+TEST(algorithm, radix_sort)
+{
+    // keys without a same-width unsigned type fail the constraint, not the body.
+    static_assert(not RadixSortable<long double>);
+    static_assert(RadixSortable<double>);
+    std::mt19937_64 random{ 13 };
+
+    std::vector<long long> integers(50000);
+    for (auto& v : integers)
+    {
+        v = static_cast<long long>(random());
+    }
+    auto expected_integers = integers;
+    std::sort(expected_integers.begin(), expected_integers.end());
+    jpl::radix_sort(integers.begin(), integers.end());
+    EXPECT_EQ(integers, expected_integers);
+
+    std::vector<float> floats(10000);
+    std::uniform_real_distribution<float> distribution{ -1e6f, 1e6f };
+    for (auto& v : floats)
+    {
+        v = distribution(random);
+    }
+    floats[0] = -0.0f;
+    floats[1] = 0.0f;
+    auto expected_floats = floats;
+    std::stable_sort(expected_floats.begin(), expected_floats.end());
+    jpl::radix_sort(floats.begin(), floats.end());
+    EXPECT_EQ(floats, expected_floats);
+
+    // stable on the projected key.
+    struct Record
+    {
+        unsigned short key;
+        int order;
+    };
+    std::vector<Record> records(5000);
+    for (int i = 0; i < 5000; ++i)
+    {
+        records[i] = { static_cast<unsigned short>(random() % 64), i };
+    }
+    jpl::radix_sort(records.begin(), records.end(), &Record::key);
+    EXPECT_TRUE(std::is_sorted(records.begin(), records.end(), [](const Record& l, const Record& r)
+    {
+        return l.key < r.key or (l.key == r.key and l.order < r.order);
+    }));
+};
+
+TEST(algorithm, branchless_lower_bound)
+{
+    std::vector<int> values{ 1, 3, 3, 5, 8, 13 };
+    for (int probe = 0; probe < 15; ++probe)
+    {
+        EXPECT_EQ(jpl::branchless_lower_bound(values.begin(), values.end(), probe), std::lower_bound(values.begin(), values.end(), probe));
+        EXPECT_EQ(jpl::branchless_upper_bound(values.begin(), values.end(), probe), std::upper_bound(values.begin(), values.end(), probe));
+    }
+    EXPECT_EQ(jpl::branchless_lower_bound(values.begin(), values.begin(), 4), values.begin());
+};
+
+TEST(flat_set, bulk)
+{
+    jpl::flat_set<int> set{ 5, 1, 4, 1, 5, 9, 2, 6 };
+    EXPECT_EQ(set.keys(), (std::vector<int>{ 1, 2, 4, 5, 6, 9 }));
+    EXPECT_TRUE(set.contains(4));
+    EXPECT_FALSE(set.contains(3));
+    EXPECT_EQ(*set.lower_bound(3), 4);
+
+    EXPECT_FALSE(set.insert(5).second);
+    EXPECT_TRUE(set.insert(3).second);
+    set.insert({ 0, 9, 7, 7 });
+    EXPECT_EQ(set.keys(), (std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 9 }));
+
+    EXPECT_EQ(set.erase(6), 1u);
+    EXPECT_EQ(set.erase(6), 0u);
+    EXPECT_EQ(set.size(), 8u);
+
+    jpl::flat_set<std::string, std::less<>> words{ "kiwi", "apple" };
+    EXPECT_TRUE(words.contains(std::string_view{ "kiwi" }));
+};
+
+struct FragileValue
+{
+    int value;
+
+    FragileValue(int value) :
+        value{ value }
+    {};
+    // negative values stand for ones that fail to copy.
+    FragileValue(const FragileValue& other) :
+        value{ other.value }
+    {
+        if (value < 0)
+        {
+            throw std::runtime_error{ "FragileValue" };
+        }
+    };
+    auto operator =(const FragileValue&) -> FragileValue& = default;
+};
+
+TEST(flat_map, bulk)
+{
+    // the first of duplicate keys wins, and keys stay in their own array.
+    jpl::flat_map<int, std::string> map{ std::vector<int>{ 3, 1, 2, 1 }, std::vector<std::string>{ "c", "a", "b", "x" } };
+    EXPECT_EQ(map.keys(), (std::vector<int>{ 1, 2, 3 }));
+    EXPECT_EQ(map.values(), (std::vector<std::string>{ "a", "b", "c" }));
+    EXPECT_EQ(map.at(2), "b");
+    EXPECT_THROW((void)map.at(7), std::out_of_range);
+
+    map[7] = "g";
+    EXPECT_EQ(map.find(7)->second, "g");
+    EXPECT_FALSE(map.try_emplace(7, "z").second);
+    map.insert_or_assign(7, "h");
+    EXPECT_EQ(map[7], "h");
+
+    map.insert({ { 5, "e" }, { 1, "no" }, { 4, "d" } });
+    std::vector<int> keys;
+    for (auto [key, value] : map)
+    {
+        keys.push_back(key);
+        value += "!";
+    }
+    EXPECT_EQ(keys, (std::vector<int>{ 1, 2, 3, 4, 5, 7 }));
+    EXPECT_EQ(map[1], "a!");
+
+    EXPECT_EQ(map.erase(3), 1u);
+    EXPECT_FALSE(map.contains(3));
+    EXPECT_EQ(map.lower_bound(3)->first, 4);
+
+    const auto& view = map;
+    EXPECT_EQ(std::distance(view.begin(), view.end()), 5);
+
+    // a value that fails to construct leaves no key behind.
+    EXPECT_THROW(map.try_emplace(9, std::string::npos, 'x'), std::length_error);
+    EXPECT_FALSE(map.contains(9));
+    EXPECT_EQ(map.keys().size(), map.values().size());
+
+    // a range insert merges only its own sorted tail; existing keys win, then
+    // the first incoming one.
+    const std::vector<std::pair<int, std::string>> incoming{ { 8, "h" }, { 0, "z" }, { 4, "no" }, { 8, "no" }, { 6, "f" } };
+    map.insert(incoming.begin(), incoming.end());
+    EXPECT_EQ(map.keys(), (std::vector<int>{ 0, 1, 2, 4, 5, 6, 7, 8 }));
+    EXPECT_EQ(map.values(), (std::vector<std::string>{ "z", "a!", "b!", "d!", "e!", "f", "h!", "h" }));
+
+    // a value that fails to copy partway through a range insert drops the
+    // whole tail, so the arrays stay in step and sorted.
+    jpl::flat_map<int, FragileValue> fragile{ { 2, 2 }, { 1, 1 } };
+    const std::pair<int, FragileValue> broken[]{ { 0, 0 }, { 9, 9 }, { 3, -1 }, { 4, 4 } };
+    EXPECT_THROW(fragile.insert(std::begin(broken), std::end(broken)), std::runtime_error);
+    EXPECT_EQ(fragile.keys(), (std::vector<int>{ 1, 2 }));
+    EXPECT_EQ(fragile.values().size(), 2u);
+    EXPECT_EQ(fragile.at(2).value, 2);
+};
+
+TEST(object_pool, reuse)
+{
+    jpl::object_pool<std::string> pool;
+    std::string* first = pool.create("first");
+    std::string* second = pool.create(40, 'x');
+    EXPECT_EQ(*first, "first");
+    EXPECT_EQ(second->size(), 40u);
+    pool.destroy(first);
+    // freed blocks are handed out again before the slab grows.
+    EXPECT_EQ(pool.create("again"), first);
+    pool.destroy(first);
+    pool.destroy(second);
+};
+
+TEST(btree_map, matches_std_map)
+{
+    // a small node size forces deep trees and every split and merge path.
+    jpl::btree_map<int, int, std::less<int>, 64> tree;
+    std::map<int, int> reference;
+    std::mt19937 random{ 17 };
+    for (int step = 0; step < 40000; ++step)
+    {
+        const int key = static_cast<int>(random() % 2000);
+        if (random() % 3 != 0)
+        {
+            EXPECT_EQ(tree.try_emplace(key, step).second, reference.try_emplace(key, step).second);
+        }
+        else
+        {
+            EXPECT_EQ(tree.erase(key), reference.erase(key));
+        }
+    }
+    ASSERT_EQ(tree.size(), reference.size());
+    EXPECT_TRUE(std::equal(tree.begin(), tree.end(), reference.begin(), reference.end(), [](auto l, const auto& r)
+    {
+        return l.first == r.first and l.second == r.second;
+    }));
+    for (int key = -1; key < 2001; key += 7)
+    {
+        const auto position = tree.lower_bound(key);
+        const auto expected = reference.lower_bound(key);
+        EXPECT_EQ(position == tree.end(), expected == reference.end());
+        if (expected != reference.end())
+        {
+            EXPECT_EQ(position->first, expected->first);
+            EXPECT_EQ(tree.upper_bound(key) == tree.end(), reference.upper_bound(key) == reference.end());
+        }
+    }
+
+    // erasing through iterators walks forward; the tree drains to empty.
+    for (auto it = tree.begin(); it != tree.end();)
+    {
+        it = tree.erase(it);
+    }
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.begin(), tree.end());
+
+    jpl::btree_map<std::string, std::string> words{ { "pear", "green" }, { "apple", "red" } };
+    words["kiwi"] = "brown";
+    auto copy = words;
+    EXPECT_EQ(copy.at("kiwi"), "brown");
+    EXPECT_EQ(std::prev(copy.end())->first, "pear");
+    EXPECT_THROW((void)copy.at("fig"), std::out_of_range);
+};
+
+TEST(slot_map, handles)
+{
+    jpl::slot_map<std::string> map;
+    const auto a = map.insert("a");
+    const auto b = map.insert("b");
+    const auto c = map.insert("c");
+    EXPECT_EQ(sizeof(a), 8u);
+    EXPECT_EQ(jpl::slot_handle::from_bits(b.to_bits()), b);
+
+    // erase fills the hole with the last value; handles follow it.
+    EXPECT_TRUE(map.erase(a));
+    EXPECT_FALSE(map.erase(a));
+    EXPECT_EQ(map.get(a), nullptr);
+    EXPECT_EQ(map[c], "c");
+    EXPECT_EQ(map.at(b), "b");
+    EXPECT_EQ(std::vector<std::string>(map.begin(), map.end()), (std::vector<std::string>{ "c", "b" }));
+    EXPECT_EQ(map.handle_at(0), c);
+
+    // the freed slot is reused under a new generation.
+    const auto d = map.insert("d");
+    EXPECT_EQ(d.index, a.index);
+    EXPECT_FALSE(map.contains(a));
+    EXPECT_EQ(*map.get(d), "d");
+    EXPECT_THROW((void)map.at(a), std::out_of_range);
+
+    // handles survive the dense array reallocating.
+    std::vector<jpl::slot_handle> handles;
+    for (int i = 0; i < 1000; ++i)
+    {
+        handles.push_back(map.insert(std::to_string(i)));
+    }
+    EXPECT_EQ(map[handles[123]], "123");
+    EXPECT_EQ(map.size(), 1003u);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(b));
+    EXPECT_FALSE(map.contains(handles[5]));
+};
+
+TEST(bitset, operations)
+{
+    jpl::bitset<130> bits;
+    bits.set(0).set(64).set(129);
+    EXPECT_EQ(bits.count(), 3u);
+    EXPECT_EQ(bits.find_first(), 0u);
+    EXPECT_EQ(bits.find_next(0), 64u);
+    EXPECT_EQ(bits.find_next(64), 129u);
+    EXPECT_EQ(bits.find_next(129), 130u);
+    EXPECT_EQ(std::vector<jpl::size_t>(bits.ones().begin(), bits.ones().end()), (std::vector<jpl::size_t>{ 0, 64, 129 }));
+
+    // the bits past N never leak into counts.
+    EXPECT_EQ((~bits).count(), 127u);
+    EXPECT_TRUE(jpl::bitset<130>{}.set().all());
+    EXPECT_EQ((bits << 1).count(), 2u);
+    EXPECT_TRUE((bits >> 64)[0]);
+    EXPECT_TRUE((bits >> 64)[65]);
+
+    jpl::bitset<130> other{ 0b101 };
+    EXPECT_EQ((bits & other).count(), 1u);
+    EXPECT_EQ((bits | other).count(), 4u);
+    EXPECT_EQ((bits ^ other).count(), 3u);
+    EXPECT_EQ(jpl::bitset<130>{ bits }.and_not(other).find_first(), 64u);
+    EXPECT_THROW((void)bits.test(130), std::out_of_range);
+
+    EXPECT_EQ(jpl::to_integer<int>(bits.get_byte(8)), 1);
+    bits.set_byte(16, jpl::byte{ 0xff });
+    EXPECT_EQ(bits.count(), 4u);
+};
+
+TEST(bitset, dynamic)
+{
+    jpl::dynamic_bitset bits(1000);
+    std::vector<jpl::size_t> expected;
+    for (jpl::size_t i = 3; i < 1000; i += 97)
+    {
+        bits.set(i);
+        expected.push_back(i);
+    }
+    EXPECT_EQ(std::vector<jpl::size_t>(bits.ones().begin(), bits.ones().end()), expected);
+    std::vector<jpl::size_t> walked;
+    for (auto i = bits.find_first(); i != bits.size(); i = bits.find_next(i))
+    {
+        walked.push_back(i);
+    }
+    EXPECT_EQ(walked, expected);
+
+    jpl::dynamic_bitset mask(1000, true);
+    mask.and_not(bits);
+    EXPECT_EQ(mask.count(), 1000 - expected.size());
+    EXPECT_EQ((mask | bits).count(), 1000u);
+    EXPECT_TRUE((mask & bits).none());
+
+    bits.resize(1030, true);
+    EXPECT_EQ(bits.count(), expected.size() + 30);
+    bits.push_back(false);
+    EXPECT_EQ(bits.size(), 1031u);
+    EXPECT_FALSE(bits[1030]);
+};
+
+TEST(byte_kernels, search)
+{
+    // long enough to cover the vector loop and the scalar tail.
+    std::string text(100, 'a');
+    text[37] = 'x';
+    text[70] = 'y';
+    text[98] = 'z';
+    EXPECT_EQ(jpl::byte_kernels::find(text.data(), text.size(), 'x'), 37u);
+    EXPECT_EQ(jpl::byte_kernels::find(text.data(), text.size(), 'z'), 98u);
+    EXPECT_EQ(jpl::byte_kernels::find(text.data(), text.size(), 'q'), jpl::byte_kernels::npos);
+    EXPECT_EQ(jpl::byte_kernels::find_first_of(text.data(), text.size(), "zy", 2), 70u);
+    EXPECT_EQ(jpl::byte_kernels::find_first_of(text.data(), text.size(), "0123456789z", 11), 98u);
+    EXPECT_EQ(jpl::byte_kernels::find(text.data(), text.size(), "ay", 2), 69u);
+    EXPECT_EQ(jpl::byte_kernels::find(text.data(), text.size(), "aaz", 3), 96u);
+    EXPECT_EQ(jpl::byte_kernels::find(text.data(), text.size(), "xy", 2), jpl::byte_kernels::npos);
+
+    std::string other = text;
+    EXPECT_EQ(jpl::byte_kernels::compare(text.data(), other.data(), text.size()), 0);
+    other[50] = '\xff';
+    EXPECT_EQ(jpl::byte_kernels::mismatch(text.data(), other.data(), text.size()), 50u);
+    EXPECT_LT(jpl::byte_kernels::compare(text.data(), other.data(), text.size()), 0);
+};
+
+TEST(string_view, constexpr_search)
+{
+    using namespace jpl::literals;
+    constexpr jpl::string_view view = "key=value; other=thing"_sv;
+    static_assert(view.find('=') == 3);
+    static_assert(view.find("other") == 11);
+    static_assert(view.find_first_of(";=", 4) == 9);
+    static_assert(view.starts_with("key") and view.ends_with("thing"));
+    static_assert(view.substr(4, 5) == "value");
+    static_assert("abc"_sv < "abd"_sv);
+
+    const jpl::string_view runtime{ std::string_view{ "the quick brown fox jumps over the lazy dog" } };
+    EXPECT_EQ(runtime.find("lazy"), 35u);
+    EXPECT_EQ(runtime.find("the", 1), 31u);
+    EXPECT_EQ(runtime.find_first_of("xyz"), 18u);
+    EXPECT_EQ(runtime.rfind('o'), 41u);
+    EXPECT_FALSE(runtime.contains("cat"));
+};
+
+template <typename T>
+struct CountingAllocator
+{
+    using value_type = T;
+
+    int* allocations;
+
+    CountingAllocator(int* allocations) noexcept :
+        allocations{ allocations }
+    {};
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept :
+        allocations{ other.allocations }
+    {};
+
+    auto allocate(jpl::size_t count) -> T*
+    {
+        ++*allocations;
+        return std::allocator<T>{}.allocate(count);
+    };
+    auto deallocate(T* pointer, jpl::size_t count) -> void
+    {
+        std::allocator<T>{}.deallocate(pointer, count);
+    };
+    friend auto operator ==(const CountingAllocator&, const CountingAllocator&) -> bool = default;
+};
+
+TEST(string, small_buffer)
+{
+    EXPECT_EQ(sizeof(jpl::string), 24u);
+
+    int allocations = 0;
+    using counted_string = jpl::basic_string<CountingAllocator<char>>;
+    counted_string identifier{ "twenty-three characters", CountingAllocator<char>{ &allocations } };
+    EXPECT_EQ(identifier.size(), 23u);
+    EXPECT_EQ(identifier.capacity(), 23u);
+    EXPECT_EQ(allocations, 0);
+    EXPECT_EQ(identifier.c_str()[23], '\0');
+
+    identifier += "!";
+    EXPECT_EQ(allocations, 1);
+    EXPECT_EQ(identifier, "twenty-three characters!");
+    EXPECT_EQ(identifier.find("three"), 7u);
+
+    // appending a piece of itself across the switch to a larger buffer.
+    jpl::string text{ "0123456789" };
+    text.append(text.view());
+    text.append(text.view());
+    EXPECT_EQ(text.size(), 40u);
+    EXPECT_EQ(text.substr(30), jpl::string_view{ "0123456789" });
+
+    jpl::string moved = jpl::move(text);
+    EXPECT_TRUE(text.empty());
+    EXPECT_EQ(moved.size(), 40u);
+    moved.erase(5, 30);
+    EXPECT_EQ(moved, "0123456789");
+    moved.resize(12, '!');
+    EXPECT_EQ(moved.view(), "0123456789!!");
+    EXPECT_LT(moved, "1");
+    EXPECT_GT("1", moved);
+    EXPECT_TRUE("0123456789!!" == moved);
+    EXPECT_TRUE(moved == jpl::string_view{ "0123456789!!" });
+    const jpl::string& constant = moved;
+    EXPECT_EQ(constant.front(), '0');
+    EXPECT_EQ(constant.back(), '!');
+
+    jpl::string copy = moved;
+    copy.pop_back();
+    EXPECT_NE(copy, moved);
+    EXPECT_EQ(std::hash<jpl::string>{}(copy), std::hash<jpl::string_view>{}(copy.view()));
+};
+
+TEST(span, views)
+{
+    static_assert(sizeof(jpl::span<int, 4>) == sizeof(int*));
+    static_assert(sizeof(jpl::span<int>) == sizeof(int*) + sizeof(jpl::size_t));
+
+    int array[]{ 1, 2, 3, 4, 5, 6 };
+    jpl::span fixed{ array };
+    static_assert(decltype(fixed)::extent == 6);
+    EXPECT_EQ(fixed.size(), 6u);
+    EXPECT_EQ(fixed.back(), 6);
+
+    auto middle = fixed.subspan<1, 4>();
+    static_assert(decltype(middle)::extent == 4);
+    EXPECT_EQ(middle.front(), 2);
+    EXPECT_EQ(middle.last<1>()[0], 5);
+    EXPECT_EQ(fixed.first(2).size(), 2u);
+    EXPECT_EQ(fixed.subspan(4).front(), 5);
+
+    std::vector<int> values{ 7, 8, 9 };
+    jpl::span<const int> view = values;
+    EXPECT_EQ(view.data(), values.data());
+    EXPECT_EQ(std::accumulate(view.begin(), view.end(), 0), 24);
+    static_assert(std::ranges::contiguous_range<jpl::span<int>>);
+    static_assert(std::ranges::borrowed_range<jpl::span<int>>);
+
+    std::array<std::uint16_t, 2> words{ 0x0102, 0x0304 };
+    auto bytes = jpl::as_writable_bytes(jpl::span{ words });
+    static_assert(decltype(bytes)::extent == 4);
+    bytes[0] = jpl::byte{ 0 };
+    bytes[1] = jpl::byte{ 0 };
+    EXPECT_EQ(words[0], 0);
+    EXPECT_EQ(jpl::as_bytes(view).size(), 3 * sizeof(int));
+};
+
+TEST(mdspan, layouts)
+{
+    std::vector<int> storage(12);
+    std::iota(storage.begin(), storage.end(), 0);
+
+    jpl::mdspan rows{ storage.data(), 3, 4 };
+    EXPECT_EQ(rows.rank(), 2u);
+    EXPECT_EQ(rows.extent(0), 3u);
+    EXPECT_EQ(rows.size(), 12u);
+    EXPECT_EQ((rows[1, 2]), 6);
+    EXPECT_EQ(rows.stride(0), 4u);
+
+    jpl::mdspan<int, jpl::extents<int, 3, 4>, jpl::layout_left> columns{ storage.data() };
+    static_assert(sizeof(columns) == sizeof(int*));
+    EXPECT_EQ((columns[1, 2]), 7);
+    EXPECT_EQ(columns.stride(1), 3);
+
+    jpl::extents<int, jpl::dynamic_extent, 4> shape{ 3 };
+    EXPECT_EQ(shape.extent(0), 3);
+    EXPECT_EQ(shape.extent(1), 4);
+
+    // the 2x2 tile at row 1, column 1 of the row-major matrix.
+    using tile_extents = jpl::extents<int, 2, 2>;
+    jpl::layout_stride::mapping<tile_extents> tile_mapping{ tile_extents{}, std::array<int, 2>{ 4, 1 } };
+    jpl::mdspan tile{ &rows[1, 1], tile_mapping };
+    EXPECT_EQ((tile[0, 0]), 5);
+    EXPECT_EQ((tile[1, 1]), 10);
+    EXPECT_EQ(tile_mapping.required_span_size(), 6);
+    tile[1, 0] = -1;
+    EXPECT_EQ(storage[9], -1);
+
+    jpl::layout_stride::mapping<jpl::dextents<jpl::size_t, 2>> strided{ rows.mapping() };
+    EXPECT_EQ(strided(2, 3), 11u);
+};
+
+// memory mapping is posix only.
+#if __has_include(<sys/mman.h>)
+TEST(mapped_file, read_and_arena)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "jpl_mapped_file_test").string();
+    {
+        std::ofstream out{ path, std::ios::binary };
+        for (int i = 0; i < 10000; ++i)
+        {
+            out.put(static_cast<char>(i % 251));
+        }
+    }
+
+    jpl::mapped_file file{ path.c_str() };
+    ASSERT_EQ(file.size(), 10000u);
+    EXPECT_FALSE(file.writable());
+    EXPECT_TRUE(file.advise(jpl::mapped_file::hint::sequential));
+    EXPECT_TRUE(file.advise(jpl::mapped_file::hint::willneed, 5000, 100));
+    jpl::span<const jpl::byte> bytes = file.bytes();
+    EXPECT_EQ(jpl::to_integer<int>(bytes[0]), 0);
+    EXPECT_EQ(jpl::to_integer<int>(bytes[9999]), 9999 % 251);
+
+    jpl::mapped_file moved = jpl::move(file);
+    EXPECT_TRUE(file.empty());
+    EXPECT_EQ(moved.size(), 10000u);
+    EXPECT_THROW(jpl::mapped_file{ "/nonexistent/jpl" }, std::system_error);
+
+    {
+        jpl::mapped_arena arena{ jpl::mapped_file{ path.c_str(), 4096 } };
+        EXPECT_EQ(arena.capacity(), 4096u);
+        auto* first = static_cast<char*>(arena.allocate(3, 1));
+        auto* second = static_cast<double*>(arena.allocate(sizeof(double), alignof(double)));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(second) % alignof(double), 0u);
+        std::memcpy(first, "jpl", 3);
+        *second = 1.5;
+        EXPECT_THROW((void)arena.allocate(4096), std::bad_alloc);
+        arena.mapping().flush();
+    }
+    jpl::mapped_file written{ path.c_str() };
+    EXPECT_EQ(written.size(), 4096u);
+    EXPECT_EQ(std::memcmp(written.data(), "jpl", 3), 0);
+
+    jpl::mapped_arena scratch{ 1 << 20 };
+    void* block = scratch.allocate(1000);
+    EXPECT_NE(block, nullptr);
+    EXPECT_EQ(scratch.used(), 1000u);
+    scratch.release();
+    EXPECT_EQ(scratch.allocate(16), block);
+    std::filesystem::remove(path);
+};
+#endif
+
+TEST(serializer, round_trip)
+{
+    enum struct kind : std::uint16_t
+    {
+        order = 7,
+    };
+    struct message
+    {
+        std::uint32_t id;
+        kind type;
+        std::uint16_t flags;
+        double price;
+        std::int64_t sequence;
+        jpl::string_view symbol;
+        jpl::span<const jpl::byte> body;
+    };
+    using codec = jpl::serializer<message, jpl::type_list<
+        jpl::field<&message::id>,
+        jpl::field<&message::type>,
+        jpl::field<&message::flags>,
+        jpl::field<&message::price>,
+        jpl::field<&message::sequence, jpl::endian::big>,
+        jpl::field<&message::symbol>,
+        jpl::field<&message::body>
+    >>;
+    static_assert(codec::fixed_size == 4 + 2 + 2 + 8 + 8 + 4 + 4);
+    static_assert(not codec::fixed);
+
+    const std::array<jpl::byte, 3> body{ jpl::byte{ 1 }, jpl::byte{ 2 }, jpl::byte{ 3 } };
+    const message original{ 42, kind::order, 0x8001, 101.25, 0x0102030405060708, "JPL", body };
+    std::vector<jpl::byte> buffer;
+    EXPECT_EQ(codec::encode(original, buffer), codec::fixed_size + 6);
+    EXPECT_EQ(codec::encode(original, buffer), codec::fixed_size + 6);
+    EXPECT_EQ(jpl::to_integer<int>(buffer[16]), 0x01);
+    EXPECT_EQ(jpl::to_integer<int>(buffer[23]), 0x08);
+
+    message decoded{};
+    const jpl::span<const jpl::byte> input{ buffer };
+    const std::size_t consumed = codec::decode(input, decoded);
+    EXPECT_EQ(consumed, buffer.size() / 2);
+    EXPECT_EQ(decoded.id, 42u);
+    EXPECT_EQ(decoded.type, kind::order);
+    EXPECT_EQ(decoded.flags, 0x8001);
+    EXPECT_EQ(decoded.price, 101.25);
+    EXPECT_EQ(decoded.sequence, 0x0102030405060708);
+    EXPECT_EQ(decoded.symbol, jpl::string_view{ "JPL" });
+    // payloads are views into the buffer, not copies.
+    EXPECT_EQ(static_cast<const void*>(decoded.symbol.data()), static_cast<const void*>(buffer.data() + 28));
+    ASSERT_EQ(decoded.body.size(), 3u);
+    EXPECT_EQ(jpl::to_integer<int>(decoded.body[2]), 3);
+
+    message second = codec::decode(input.subspan(consumed));
+    EXPECT_EQ(second.sequence, original.sequence);
+
+    EXPECT_THROW(codec::decode(input.first(20), decoded), std::out_of_range);
+    EXPECT_THROW(codec::decode(input.first(codec::fixed_size + 2), decoded), std::out_of_range);
+    std::array<jpl::byte, 8> small{};
+    EXPECT_THROW(codec::encode(original, jpl::span<jpl::byte>{ small }), std::out_of_range);
+};
+
+TEST(bit, byteswap_and_cast)
+{
+    static_assert(jpl::byteswap(std::uint32_t{ 0x01020304 }) == 0x04030201);
+    static_assert(jpl::byteswap(std::int16_t{ 0x0102 }) == 0x0201);
+    static_assert(jpl::byteswap(std::uint8_t{ 0xab }) == 0xab);
+    static_assert(jpl::bit_cast<std::uint64_t>(1.0) == 0x3ff0000000000000);
+    static_assert(jpl::endian::native == jpl::endian::little or jpl::endian::native == jpl::endian::big);
+
+    std::uint64_t value = 0x0102030405060708;
+    EXPECT_EQ(jpl::byteswap(value), 0x0807060504030201u);
+    EXPECT_EQ(jpl::bit_cast<float>(jpl::bit_cast<std::uint32_t>(2.5f)), 2.5f);
+};
+
+TEST(varint, round_trip)
+{
+    static_assert(jpl::zigzag_encode(0) == 0u and jpl::zigzag_encode(-1) == 1u and jpl::zigzag_encode(1) == 2u);
+    static_assert(jpl::zigzag_encode(std::numeric_limits<std::int64_t>::min()) == std::numeric_limits<std::uint64_t>::max());
+    static_assert(jpl::zigzag_decode(jpl::zigzag_encode(-123456)) == -123456);
+    static_assert(jpl::varint::size(127u) == 1 and jpl::varint::size(128u) == 2 and jpl::varint::size(~0ull) == 10);
+    static_assert([]
+    {
+        jpl::byte buffer[jpl::varint::max_bytes<std::uint32_t>]{};
+        std::uint32_t decoded = 0;
+        const auto written = jpl::varint::encode(300u, buffer);
+        return written == 2 and jpl::varint::decode(buffer, buffer + written, decoded) == 2 and decoded == 300u;
+    }());
+
+    jpl::byte buffer[10]{};
+    std::uint64_t wide = 0;
+    ASSERT_EQ(jpl::varint::encode(~0ull, buffer), 10u);
+    EXPECT_EQ(jpl::varint::decode(buffer, buffer + 10, wide), 10u);
+    EXPECT_EQ(wide, ~0ull);
+    std::uint32_t narrow = 0;
+    EXPECT_EQ(jpl::varint::decode(buffer, buffer + 10, narrow), 0u);
+    EXPECT_EQ(jpl::varint::decode(buffer, buffer + 3, wide), 0u);
+
+    // mostly one-byte deltas with runs of wider values, as in a posting list.
+    std::mt19937 generator{ 40 };
+    std::vector<std::uint32_t> values(10000);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        const auto bits = (i / 64) % 4 == 0 ? 7u : std::uniform_int_distribution<unsigned>{ 1, 32 }(generator);
+        values[i] = static_cast<std::uint32_t>(generator() >> (32 - bits));
+    }
+    std::vector<jpl::byte> encoded;
+    for (const std::uint32_t value : values)
+    {
+        jpl::byte bytes[5];
+        encoded.insert(encoded.end(), bytes, bytes + jpl::varint::encode(value, bytes));
+    }
+    std::vector<std::uint32_t> decoded(values.size());
+    EXPECT_EQ(jpl::varint::decode_batch(encoded.data(), encoded.data() + encoded.size(), decoded.data(), decoded.size()), encoded.size());
+    EXPECT_EQ(decoded, values);
+
+    EXPECT_EQ(jpl::varint::decode_batch(encoded.data(), encoded.data() + encoded.size() - 1, decoded.data(), decoded.size()), 0u);
+    std::vector<jpl::byte> runaway(32, jpl::byte{ 0xff });
+    EXPECT_EQ(jpl::varint::decode_batch(runaway.data(), runaway.data() + runaway.size(), decoded.data(), 16), 0u);
+};
+
+struct ParserTag
+{
+    static constexpr const char* name = "parser";
+};
+
+TEST(allocation_tracking, tags)
+{
+    using policy = jpl::tracked<ParserTag>;
+    static_assert(sizeof(jpl::unique_ptr<int, jpl::tracked_delete<int>>) == sizeof(int*));
+    static_assert(sizeof(jpl::tracked_allocator<int>) == 1);
+
+    {
+        auto first = jpl::make_tracked<std::uint64_t, policy>(1u);
+        auto second = jpl::make_tracked<std::uint64_t, policy>(2u);
+        EXPECT_EQ(*second, 2u);
+        EXPECT_EQ(policy::snapshot().live_bytes, 16u);
+        first.reset();
+        EXPECT_EQ(policy::snapshot().live_bytes, 8u);
+    }
+    {
+        std::vector<std::uint32_t, jpl::tracked_allocator<std::uint32_t, policy>> values;
+        values.reserve(100);
+        values.assign(100, 7u);
+        EXPECT_EQ(policy::snapshot().live_bytes, 400u);
+    }
+
+    const jpl::allocation_snapshot parser = policy::snapshot();
+    EXPECT_STREQ(parser.tag, "parser");
+    EXPECT_EQ(parser.allocations, 3u);
+    EXPECT_EQ(parser.deallocations, 3u);
+    EXPECT_EQ(parser.live_bytes, 0u);
+    EXPECT_EQ(parser.peak_bytes, 400u);
+    EXPECT_EQ(parser.total_bytes, 416u);
+    EXPECT_EQ(std::accumulate(parser.lifetimes.begin(), parser.lifetimes.end(), std::size_t{ 0 }), 3u);
+
+    const auto all = jpl::allocation_snapshots();
+    EXPECT_TRUE(std::any_of(all.begin(), all.end(), [](const jpl::allocation_snapshot& tag) { return std::strcmp(tag.tag, "parser") == 0; }));
+};
+
+struct CountingResource : jpl::memory_resource
+{
+    int allocations = 0;
+    int live = 0;
+
+private:
+    auto do_allocate(jpl::size_t bytes, jpl::size_t alignment) -> void* override
+    {
+        ++allocations;
+        ++live;
+        return jpl::new_delete_resource()->allocate(bytes, alignment);
+    };
+    auto do_deallocate(void* pointer, jpl::size_t bytes, jpl::size_t alignment) -> void override
+    {
+        --live;
+        jpl::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    };
+    auto do_is_equal(const jpl::memory_resource& other) const noexcept -> bool override
+    {
+        return this == &other;
+    };
+};
+
+TEST(memory_resource, monotonic_and_pools)
+{
+    CountingResource upstream;
+    {
+        alignas(16) unsigned char buffer[256];
+        jpl::monotonic_buffer_resource arena{ buffer, sizeof(buffer), &upstream };
+        std::vector<int, jpl::polymorphic_allocator<int>> values{ &arena };
+        values.reserve(32);
+        EXPECT_EQ(upstream.allocations, 0);
+        EXPECT_GE(reinterpret_cast<unsigned char*>(values.data()), buffer);
+        values.reserve(1000);
+        EXPECT_EQ(upstream.allocations, 1);
+        void* aligned = arena.allocate(1, 64);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0u);
+        arena.release();
+        EXPECT_EQ(upstream.live, 0);
+        EXPECT_EQ(arena.allocate(8), static_cast<void*>(buffer));
+    }
+
+    {
+        jpl::unsynchronized_pool_resource pools{ jpl::pool_options{ 64, 512 }, &upstream };
+        EXPECT_EQ(pools.pool_settings().largest_required_pool_block, 512u);
+        void* first = pools.allocate(24);
+        pools.deallocate(first, 24);
+        EXPECT_EQ(pools.allocate(32), first);
+        void* wide = pools.allocate(100, 128);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(wide) % 128, 0u);
+        void* large = pools.allocate(5000, 64);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) % 64, 0u);
+        void* larger = pools.allocate(7000);
+        pools.deallocate(large, 5000, 64);
+        (void)larger;
+
+        jpl::basic_string<jpl::polymorphic_allocator<char>> text{ "allocated from a pool resource, not the heap", &pools };
+        EXPECT_EQ(text.get_allocator().resource(), &pools);
+        auto owned = jpl::allocate_unique<std::string>(&pools, 3, 'x');
+        EXPECT_EQ(*owned, "xxx");
+    }
+    EXPECT_EQ(upstream.live, 0);
+
+    jpl::synchronized_pool_resource shared{ &upstream };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&shared, t]
+        {
+            std::vector<void*> blocks;
+            for (int i = 0; i < 1000; ++i)
+            {
+                blocks.push_back(shared.allocate(static_cast<std::size_t>(8 << ((i + t) % 6))));
+            }
+            for (int i = 0; i < 1000; ++i)
+            {
+                shared.deallocate(blocks[static_cast<std::size_t>(i)], static_cast<std::size_t>(8 << ((i + t) % 6)));
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    shared.release();
+    EXPECT_EQ(upstream.live, 0);
+
+    jpl::memory_resource* previous = jpl::set_default_resource(&shared);
+    EXPECT_EQ(jpl::polymorphic_allocator<int>{}.resource(), &shared);
+    jpl::set_default_resource(previous);
+    EXPECT_EQ(jpl::get_default_resource(), jpl::new_delete_resource());
+};
+
+// page mapping and numa placement are posix only.
+#if __has_include(<sys/mman.h>)
+TEST(page_allocator, pages_and_placement)
+{
+    jpl::byte* huge = jpl::allocate_pages(3 << 20);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(huge) % jpl::huge_page_size, 0u);
+    huge[0] = jpl::byte{ 1 };
+    huge[(3 << 20) - 1] = jpl::byte{ 2 };
+    const int here = jpl::numa::current_node();
+    const int placed = jpl::numa::node_of(huge);
+    // kernels without numa support report -1 for both, or node 0 for pages.
+    EXPECT_TRUE(placed == -1 or here == -1 or placed == here);
+    jpl::deallocate_pages(huge, 3 << 20);
+
+    jpl::page_options small{ .pages = jpl::page_options::huge::never, .node = jpl::page_options::any_node, .populate = true };
+    jpl::byte* pages = jpl::allocate_pages(100, small);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(pages) % jpl::page_size(), 0u);
+    EXPECT_EQ(pages[99], jpl::byte{ 0 });
+    jpl::deallocate_pages(pages, 100, small);
+
+    jpl::byte* reserved = jpl::allocate_pages(1, jpl::page_options{ .pages = jpl::page_options::huge::reserved });
+    reserved[0] = jpl::byte{ 3 };
+    jpl::deallocate_pages(reserved, 1, jpl::page_options{ .pages = jpl::page_options::huge::reserved });
+
+    std::vector<unsigned char> data(1 << 16, 7);
+    jpl::thread_pool pool{ 2 };
+    jpl::first_touch(pool, jpl::span<jpl::byte>{ reinterpret_cast<jpl::byte*>(data.data()), data.size() - 3 });
+    EXPECT_TRUE(std::all_of(data.begin(), data.end(), [](unsigned char value) { return value == 7; }));
+
+    jpl::page_resource upstream{ small };
+    jpl::monotonic_buffer_resource arena{ jpl::huge_page_size, &upstream };
+    std::vector<int, jpl::polymorphic_allocator<int>> values{ &arena };
+    for (int i = 0; i < 100000; ++i)
+    {
+        values.push_back(i);
+    }
+    EXPECT_EQ(values[99999], 99999);
+    EXPECT_TRUE(upstream == upstream);
+    EXPECT_FALSE(upstream == *jpl::new_delete_resource());
+    EXPECT_THROW((void)upstream.allocate(64, size_t{ 1 } << 20), std::bad_alloc);
+};
+#endif
+
+struct HeapBase
+{
+    virtual ~HeapBase() = default;
+    int base = 1;
+};
+struct HeapDerived : HeapBase
+{
+    explicit HeapDerived(int* destroyed) noexcept :
+        destroyed{ destroyed }
+    {};
+    ~HeapDerived() override
+    {
+        ++*destroyed;
+    };
+    int* destroyed;
+    char padding[200]{};
+};
+
+TEST(heap, size_classes_and_caches)
+{
+    for (jpl::size_t bytes = 1; bytes <= 8192; ++bytes)
+    {
+        const jpl::size_t index = jpl::impl::heap::class_of(bytes);
+        ASSERT_GE(jpl::impl::heap::class_size(index), bytes);
+        ASSERT_TRUE(index == 0 or jpl::impl::heap::class_size(index - 1) < bytes);
+    }
+    EXPECT_EQ(jpl::impl::heap::class_of(8192), jpl::impl::heap::class_count - 1);
+
+    void* small = jpl::heap::allocate(24);
+    EXPECT_EQ(jpl::heap::usable_size(small), 32u);
+    jpl::heap::deallocate(small, 24);
+    EXPECT_EQ(jpl::heap::allocate(32), small);
+    jpl::heap::deallocate(small);
+
+    void* large = jpl::heap::allocate(100000, 4096);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) % 4096, 0u);
+    EXPECT_GE(jpl::heap::usable_size(large), 100000u);
+    std::memset(large, 0xab, 100000);
+    jpl::heap::deallocate(large);
+    void* aligned = jpl::heap::allocate(16, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0u);
+    jpl::heap::deallocate(aligned, 16, 64);
+
+    std::vector<std::string, jpl::heap_allocator<std::string>> strings;
+    for (int i = 0; i < 1000; ++i)
+    {
+        strings.push_back(std::to_string(i));
+    }
+    EXPECT_EQ(strings[999], "999");
+    std::map<int, int, std::less<>, jpl::heap_allocator<std::pair<const int, int>>> ordered;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ordered.emplace(i, i * i);
+    }
+    EXPECT_EQ(ordered.at(30), 900);
+
+    int destroyed = 0;
+    {
+        jpl::unique_ptr<HeapBase, jpl::heap_delete<HeapBase>> object = jpl::make_heap_unique<HeapDerived>(&destroyed);
+        auto number = jpl::make_heap_unique<long>(5);
+        EXPECT_EQ(*number, 5);
+        EXPECT_EQ(object->base, 1);
+    }
+    EXPECT_EQ(destroyed, 1);
+
+    // blocks freed by other threads, and by exiting threads, come back in batches.
+    std::vector<void*> blocks;
+    std::thread producer{ [&blocks]
+    {
+        for (int i = 0; i < 5000; ++i)
+        {
+            blocks.push_back(jpl::heap::allocate(48));
+        }
+    } };
+    producer.join();
+    std::vector<std::thread> consumers;
+    for (int t = 0; t < 4; ++t)
+    {
+        consumers.emplace_back([&blocks, t]
+        {
+            for (std::size_t i = static_cast<std::size_t>(t); i < blocks.size(); i += 4)
+            {
+                jpl::heap::deallocate(blocks[i], 48);
+            }
+            for (int i = 0; i < 3000; ++i)
+            {
+                void* block = jpl::heap::allocate(40);
+                std::memset(block, t, 40);
+                jpl::heap::deallocate(block, 40);
+            }
+        });
+    }
+    for (auto& consumer : consumers)
+    {
+        consumer.join();
+    }
+
+    std::vector<int, jpl::polymorphic_allocator<int>> through_resource{ jpl::heap::resource() };
+    through_resource.assign(100, 4);
+    EXPECT_EQ(through_resource[99], 4);
+};
+
+enum class Slot : unsigned char
+{
+    first,
+    second,
+    none = 0xff,
+};
+template <>
+struct jpl::niche<Slot> : jpl::sentinel_niche<Slot, Slot::none>
+{};
+
+enum class Fault : unsigned char
+{
+    ok,
+    missing,
+    corrupt,
+};
+template <>
+struct jpl::niche<Fault> : jpl::sentinel_niche<Fault, Fault::ok>
+{};
+
+struct NotFound
+{};
+
+// never null, so it opts in to the pointer's niche.
+struct Record
+{
+    int id;
+};
+template <>
+struct jpl::niche<Record*> : jpl::sentinel_niche<Record*, nullptr>
+{};
+
+constexpr auto constant_optional() -> int
+{
+    jpl::optional<int> value;
+    value = 4;
+    jpl::optional<int> copy = value;
+    copy.emplace(6);
+    return *value + copy.value_or(0) + value.transform([](int v) { return v * 10; }).value();
+};
+static_assert(constant_optional() == 50);
+
+auto parse_digit(char c) -> jpl::expected<int, std::string>
+{
+    if (c < '0' or c > '9')
+    {
+        return jpl::unexpected{ std::string{ "not a digit: " } + c };
+    }
+    return c - '0';
+};
+
+TEST(optional, niche_and_flag)
+{
+    static_assert(sizeof(jpl::optional<Record*>) == sizeof(Record*));
+    static_assert(sizeof(jpl::optional<int*>) > sizeof(int*));
+    static_assert(sizeof(jpl::optional<jpl::unique_ptr<int>>) == sizeof(int*));
+    static_assert(sizeof(jpl::optional<Slot>) == 1);
+    static_assert(sizeof(jpl::optional<int>) == 2 * sizeof(int));
+    static_assert(std::is_trivially_copyable_v<jpl::optional<int>>);
+    static_assert(std::is_trivially_copyable_v<jpl::optional<Slot>>);
+    static_assert(sizeof(jpl::expected<Record*, NotFound>) == sizeof(Record*));
+    static_assert(sizeof(jpl::expected<void, Fault>) == 1);
+
+    // null is a value like any other for a pointer that has not opted in.
+    jpl::optional<int*> null{ nullptr };
+    EXPECT_TRUE(null.has_value());
+    EXPECT_EQ(*null, nullptr);
+    Record record{ 5 };
+    jpl::optional<Record*> packed{ &record };
+    EXPECT_EQ((*packed)->id, 5);
+    packed.reset();
+    EXPECT_FALSE(packed);
+
+    jpl::optional<Slot> slot;
+    EXPECT_FALSE(slot);
+    slot = Slot::second;
+    EXPECT_EQ(*slot, Slot::second);
+    EXPECT_TRUE(slot == Slot::second);
+    slot.reset();
+    EXPECT_TRUE(slot == jpl::nullopt);
+
+    jpl::optional<jpl::unique_ptr<int>> owner{ jpl::unique_ptr<int>{ new int{ 7 } } };
+    EXPECT_EQ(**owner, 7);
+    jpl::optional<jpl::unique_ptr<int>> moved = jpl::move(owner);
+    EXPECT_FALSE(owner.has_value());
+    EXPECT_EQ(**moved, 7);
+    moved = jpl::nullopt;
+    EXPECT_FALSE(moved);
+    EXPECT_THROW((void)moved.value(), jpl::bad_optional_access);
+
+    jpl::optional<std::string> text{ jpl::in_place, 3, 'a' };
+    jpl::optional<std::string> copy = text;
+    EXPECT_EQ(*copy, "aaa");
+    copy = jpl::nullopt;
+    swap(text, copy);
+    EXPECT_FALSE(text);
+    EXPECT_EQ(copy->size(), 3u);
+    auto length = copy.and_then([](const std::string& s) { return jpl::optional<std::size_t>{ s.size() }; });
+    EXPECT_EQ(length, jpl::optional<std::size_t>{ 3 });
+    EXPECT_EQ(text.or_else([] { return jpl::optional<std::string>{ "fallback" }; }).value(), "fallback");
+    EXPECT_EQ(text.value_or("none"), "none");
+};
+
+TEST(expected, values_and_errors)
+{
+    auto good = parse_digit('7');
+    ASSERT_TRUE(good);
+    EXPECT_EQ(*good, 7);
+    auto bad = parse_digit('x');
+    ASSERT_FALSE(bad);
+    EXPECT_EQ(bad.error(), "not a digit: x");
+    EXPECT_THROW((void)bad.value(), jpl::bad_expected_access<std::string>);
+
+    auto doubled = good.transform([](int v) { return v * 2; });
+    EXPECT_EQ(doubled, 14);
+    auto chained = good.and_then([](int v) { return parse_digit(static_cast<char>('0' + v - 5)); });
+    EXPECT_EQ(*chained, 2);
+    auto recovered = bad.or_else([](const std::string&) { return jpl::expected<int, std::string>{ 0 }; });
+    EXPECT_EQ(*recovered, 0);
+    auto sized = bad.transform_error([](const std::string& s) { return s.size(); });
+    EXPECT_EQ(sized.error(), 14u);
+    EXPECT_EQ(bad.value_or(-1), -1);
+
+    good = bad;
+    EXPECT_FALSE(good);
+    good = 3;
+    EXPECT_EQ(good.value(), 3);
+    good = jpl::unexpected{ std::string{ "again" } };
+    EXPECT_TRUE(good == jpl::unexpected{ std::string{ "again" } });
+
+    int found = 4;
+    jpl::expected<int*, NotFound> lookup{ &found };
+    EXPECT_EQ(*lookup, &found);
+    lookup = jpl::unexpected{ NotFound{} };
+    EXPECT_FALSE(lookup);
+    lookup = nullptr;
+    EXPECT_TRUE(lookup.has_value());
+    EXPECT_EQ(*lookup, nullptr);
+
+    jpl::expected<void, Fault> status;
+    EXPECT_TRUE(status);
+    status = jpl::unexpected{ Fault::corrupt };
+    EXPECT_EQ(status.error(), Fault::corrupt);
+    EXPECT_THROW(status.value(), jpl::bad_expected_access<Fault>);
+    status.emplace();
+    EXPECT_TRUE(status.has_value());
+};
+
+TEST(cache_aligned, per_thread_and_per_cpu)
+{
+    static_assert(alignof(jpl::cache_aligned<char>) == jpl::hardware_destructive_interference_size);
+    static_assert(sizeof(jpl::cache_aligned<int>) == jpl::hardware_destructive_interference_size);
+    static_assert(alignof(jpl::seqlock<int>) == jpl::hardware_destructive_interference_size);
+    jpl::cache_aligned<int> counters[2]{};
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&counters[1]) - reinterpret_cast<std::uintptr_t>(&counters[0]), jpl::hardware_destructive_interference_size);
+    jpl::cache_aligned<std::string> label{ jpl::in_place, "hits" };
+    EXPECT_EQ(label->size(), 4u);
+
+    jpl::per_thread<std::atomic<std::size_t>> hits;
+    jpl::per_cpu<std::atomic<std::size_t>> misses;
+    EXPECT_GE(misses.size(), 1u);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 20; ++t)
+    {
+        threads.emplace_back([&hits, &misses]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                hits.local().fetch_add(1, std::memory_order_relaxed);
+                misses.local().fetch_add(2, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(hits.combine(std::size_t{ 0 }), 20000u);
+    EXPECT_EQ(misses.combine(std::size_t{ 0 }), 40000u);
+
+    // an index past the first chunks lands in a lazily made one.
+    EXPECT_EQ(jpl::impl::per_thread::locate(7).chunk, 0u);
+    EXPECT_EQ(jpl::impl::per_thread::locate(8).chunk, 1u);
+    EXPECT_EQ(jpl::impl::per_thread::locate(8).offset, 0u);
+    EXPECT_EQ(jpl::impl::per_thread::locate(24).chunk, 2u);
+
+    jpl::per_thread<jpl::compressed_pair<int, std::size_t>> stats;
+    stats.local().first += 3;
+    stats.local().second += 5;
+    const auto total = stats.combine(std::size_t{ 0 }, [](std::size_t sum, const jpl::compressed_pair<int, std::size_t>& slot)
+    {
+        return sum + static_cast<std::size_t>(slot.first) + slot.second;
+    });
+    EXPECT_EQ(total, 8u);
+};
+
+// bytes live through the global operator new, for checking that workloads
+// in a steady state hold memory flat. each block carries its size in front.
+std::atomic<std::size_t> heap_bytes{ 0 };
+
+auto operator new(std::size_t size) -> void*
+{
+    void* block = std::malloc(size + alignof(std::max_align_t));
+    if (block == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    *static_cast<std::size_t*>(block) = size;
+    heap_bytes.fetch_add(size, std::memory_order_relaxed);
+    return static_cast<unsigned char*>(block) + alignof(std::max_align_t);
+};
+auto operator new(std::size_t size, const std::nothrow_t&) noexcept -> void*
+{
+    try
+    {
+        return ::operator new(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+};
+auto operator delete(void* pointer) noexcept -> void
+{
+    if (pointer == nullptr)
+    {
+        return;
+    }
+    void* block = static_cast<unsigned char*>(pointer) - alignof(std::max_align_t);
+    heap_bytes.fetch_sub(*static_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+};
+auto operator delete(void* pointer, std::size_t) noexcept -> void
+{
+    ::operator delete(pointer);
+};
+auto operator delete(void* pointer, const std::nothrow_t&) noexcept -> void
+{
+    ::operator delete(pointer);
+};
+
+TEST(concurrent_hash_map, sharded_reads_and_resizes)
+{
+    jpl::concurrent_hash_map<std::uint64_t, std::uint64_t, std::hash<std::uint64_t>, std::equal_to<std::uint64_t>, 4> sessions;
+    EXPECT_TRUE(sessions.empty());
+    EXPECT_TRUE(sessions.insert(1, 10));
+    EXPECT_FALSE(sessions.insert(1, 11));
+    EXPECT_EQ(sessions.find(1).value(), 10u);
+    EXPECT_FALSE(sessions.insert_or_assign(1, 12));
+    EXPECT_EQ(sessions.find(1).value(), 12u);
+    EXPECT_TRUE(sessions.update(1, [](std::uint64_t& value) { value += 1; }));
+    EXPECT_EQ(sessions.find(1).value(), 13u);
+    EXPECT_FALSE(sessions.update(2, [](std::uint64_t&) {}));
+    EXPECT_TRUE(sessions.erase(1));
+    EXPECT_FALSE(sessions.erase(1));
+    EXPECT_FALSE(sessions.contains(1));
+
+    // a few thousand keys through tables that start at 16 slots: every shard
+    // resizes several times while readers look up the keys already written.
+    constexpr std::uint64_t count = 20000;
+    std::atomic<std::uint64_t> published{ 0 };
+    std::atomic<bool> torn{ false };
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t)
+    {
+        readers.emplace_back([&]
+        {
+            while (published.load(std::memory_order_acquire) < count)
+            {
+                const std::uint64_t limit = published.load(std::memory_order_acquire);
+                for (std::uint64_t key = 0; key < limit; key += 97)
+                {
+                    const auto value = sessions.find(key);
+                    if (not value or *value != key * 3)
+                    {
+                        torn.store(true, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+    }
+    for (std::uint64_t key = 0; key < count; ++key)
+    {
+        sessions.insert(key, key * 3);
+        published.store(key + 1, std::memory_order_release);
+    }
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_FALSE(torn.load());
+    EXPECT_EQ(sessions.size(), count);
+
+    for (std::uint64_t key = 0; key < count; key += 2)
+    {
+        EXPECT_TRUE(sessions.erase(key));
+    }
+    EXPECT_EQ(sessions.size(), count / 2);
+    std::uint64_t visited = 0;
+    sessions.for_each([&](std::uint64_t key, std::uint64_t value)
+    {
+        visited += key % 2 == 1 and value == key * 3 ? 1 : 0;
+    });
+    EXPECT_EQ(visited, count / 2);
+    sessions.clear();
+    EXPECT_TRUE(sessions.empty());
+    EXPECT_FALSE(sessions.contains(3));
+};
+
+TEST(concurrent_hash_map, churn_holds_memory_flat)
+{
+    // a session cache at a steady size: every op drops one key and adds
+    // another, which leaves a tombstone behind each time.
+    jpl::concurrent_hash_map<std::uint64_t, std::uint64_t, std::hash<std::uint64_t>, std::equal_to<std::uint64_t>, 4> sessions;
+    constexpr std::uint64_t live = 1000;
+    std::uint64_t next = 0;
+    const auto churn = [&](std::uint64_t ops)
+    {
+        for (std::uint64_t op = 0; op < ops; ++op, ++next)
+        {
+            if (next >= live)
+            {
+                sessions.erase(next - live);
+            }
+            sessions.insert(next, next);
+        }
+    };
+    churn(200000);
+    const std::size_t settled = heap_bytes.load();
+    churn(800000);
+    EXPECT_EQ(sessions.size(), live);
+    EXPECT_LE(heap_bytes.load(), settled + 4096);
+    EXPECT_EQ(sessions.find(next - 1).value(), next - 1);
+    EXPECT_FALSE(sessions.contains(next - live - 1));
+};
+
+TEST(concurrent_hash_map, grows_while_shrunk_table_migrates)
+{
+    // a table left mostly tombstones regrows small, and must still hold
+    // everything the old one has not handed over yet when it fills again.
+    jpl::concurrent_hash_map<std::uint64_t, std::uint64_t, std::hash<std::uint64_t>, std::equal_to<std::uint64_t>, 1> sessions;
+    for (std::uint64_t key = 0; key < 1533; ++key)
+    {
+        sessions.insert(key, key);
+    }
+    for (std::uint64_t key = 0; key < 1523; ++key)
+    {
+        sessions.erase(key);
+    }
+    for (std::uint64_t key = 2000; key < 2500; ++key)
+    {
+        EXPECT_TRUE(sessions.insert(key, key));
+    }
+    EXPECT_EQ(sessions.size(), 510u);
+    for (std::uint64_t key = 1523; key < 1533; ++key)
+    {
+        EXPECT_EQ(sessions.find(key).value(), key);
+    }
+    for (std::uint64_t key = 2000; key < 2500; ++key)
+    {
+        EXPECT_EQ(sessions.find(key).value(), key);
+    }
+};
+
+TEST(functional, inplace_function)
+{
+    jpl::inplace_function<int(int)> empty;
+    EXPECT_FALSE(empty);
+    EXPECT_TRUE(empty == nullptr);
+    EXPECT_THROW(empty(1), std::bad_function_call);
+
+    auto owned = std::make_unique<int>(5);
+    jpl::inplace_function<int(int)> add{ [owned = jpl::move(owned)](int value) { return value + *owned; } };
+    EXPECT_EQ(add(2), 7);
+    jpl::inplace_function<int(int)> moved{ jpl::move(add) };
+    EXPECT_FALSE(add);
+    EXPECT_EQ(moved(3), 8);
+    swap(add, moved);
+    EXPECT_EQ(add(4), 9);
+    EXPECT_FALSE(moved);
+    add = nullptr;
+    EXPECT_FALSE(add);
+};
+
+TEST(timer_wheel, schedule_cancel_and_cascade)
+{
+    jpl::timer_wheel wheel;
+    std::vector<int> fired;
+    const auto record = [&fired](int value)
+    {
+        return [&fired, value] { fired.push_back(value); };
+    };
+
+    wheel.schedule(5, record(5));
+    const auto cancelled = wheel.schedule(3, record(3));
+    wheel.schedule(0, record(1));
+    // far enough out to start two levels up and cascade down twice.
+    wheel.schedule(5000, record(5000));
+    const auto moved = wheel.schedule(10, record(10));
+    EXPECT_EQ(wheel.size(), 5u);
+    EXPECT_TRUE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.cancel(cancelled));
+    EXPECT_TRUE(wheel.reschedule(moved, 200));
+
+    EXPECT_EQ(wheel.advance(5), 2u);
+    EXPECT_EQ(fired, (std::vector<int>{ 1, 5 }));
+    EXPECT_EQ(wheel.advance_to(199), 0u);
+    EXPECT_EQ(wheel.advance(1), 1u);
+    EXPECT_EQ(wheel.advance_to(4999), 0u);
+    EXPECT_EQ(wheel.advance(1), 1u);
+    EXPECT_EQ(fired, (std::vector<int>{ 1, 5, 10, 5000 }));
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(wheel.reschedule(moved, 1));
+
+    // callbacks may schedule and cancel, including timers in their own batch.
+    jpl::timer_id sibling;
+    wheel.schedule(1, [&] { wheel.cancel(sibling); wheel.schedule(2, record(-1)); });
+    sibling = wheel.schedule(1, record(-2));
+    EXPECT_EQ(wheel.advance(1), 1u);
+    EXPECT_EQ(wheel.advance(2), 1u);
+    EXPECT_EQ(fired.back(), -1);
+
+    // deadlines past the top level wait and are placed again.
+    const std::uint64_t far = std::uint64_t{ 1 } << 40;
+    wheel.schedule(far, record(40));
+    EXPECT_EQ(wheel.advance(far - 1), 0u);
+    EXPECT_EQ(wheel.advance(1), 1u);
+    EXPECT_EQ(fired.back(), 40);
+
+    // every deadline fires on its own tick after random scheduling.
+    std::mt19937_64 random{ 7 };
+    jpl::timer_wheel checked{ wheel.now() };
+    std::uint64_t late = 0;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const std::uint64_t deadline = checked.now() + 1 + random() % 300000;
+        checked.schedule(deadline - checked.now(), [&checked, &late, deadline] { late += checked.now() != deadline ? 1 : 0; });
+    }
+    for (std::uint64_t step = 0; not checked.empty(); step += 997)
+    {
+        checked.advance(step % 5000 + 1);
+    }
+    EXPECT_EQ(late, 0u);
+};
+
+struct Session
+{
+    int id;
+    jpl::list_hook recency;
+    jpl::list_hook idle;
+    jpl::hash_set_hook by_id;
+};
+struct SessionHash
+{
+    auto operator ()(int id) const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(id);
+    };
+    auto operator ()(const Session& session) const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(session.id);
+    };
+};
+struct SessionEqual
+{
+    auto operator ()(const Session& session, int id) const noexcept -> bool
+    {
+        return session.id == id;
+    };
+    auto operator ()(const Session& left, const Session& right) const noexcept -> bool
+    {
+        return left.id == right.id;
+    };
+};
+
+TEST(intrusive, list_and_hash_set)
+{
+    std::vector<Session> sessions(8);
+    for (int i = 0; i < 8; ++i)
+    {
+        sessions[i].id = i;
+    }
+
+    jpl::intrusive_list<&Session::recency> recency;
+    jpl::intrusive_list<&Session::idle> idle;
+    for (auto& session : sessions)
+    {
+        recency.push_back(session);
+        if (session.id % 2 == 0)
+        {
+            idle.push_front(session);
+        }
+    }
+    EXPECT_EQ(recency.size(), 8u);
+    EXPECT_EQ(idle.size(), 4u);
+    EXPECT_EQ(idle.front().id, 6);
+    EXPECT_EQ(&*recency.iterator_to(sessions[3]), &sessions[3]);
+
+    // a hit moves the entry to the front; eviction takes the back.
+    recency.splice(recency.begin(), sessions[5]);
+    recency.erase(sessions[2]);
+    EXPECT_FALSE(sessions[2].recency.is_linked());
+    EXPECT_TRUE(sessions[2].idle.is_linked());
+    std::vector<int> order;
+    for (const Session& session : recency)
+    {
+        order.push_back(session.id);
+    }
+    EXPECT_EQ(order, (std::vector<int>{ 5, 0, 1, 3, 4, 6, 7 }));
+    EXPECT_EQ(recency.back().id, 7);
+    recency.pop_back();
+    EXPECT_EQ(std::prev(recency.end())->id, 6);
+    EXPECT_EQ(recency.rbegin()->id, 6);
+
+    jpl::intrusive_list<&Session::recency> moved{ jpl::move(recency) };
+    EXPECT_TRUE(recency.empty());
+    EXPECT_EQ(moved.size(), 6u);
+    moved.clear();
+    EXPECT_FALSE(sessions[5].recency.is_linked());
+
+    jpl::intrusive_hash_set<&Session::by_id, SessionHash, SessionEqual> by_id{ 4 };
+    for (auto& session : sessions)
+    {
+        EXPECT_TRUE(by_id.insert(session).second);
+    }
+    Session duplicate{};
+    duplicate.id = 3;
+    const auto [existing, inserted] = by_id.insert(duplicate);
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(&*existing, &sessions[3]);
+    EXPECT_EQ(by_id.size(), 8u);
+    EXPECT_EQ(by_id.find(6)->id, 6);
+    EXPECT_FALSE(by_id.contains(9));
+
+    by_id.erase(sessions[6]);
+    EXPECT_FALSE(by_id.contains(6));
+    EXPECT_EQ(by_id.erase(1), 1u);
+    EXPECT_EQ(by_id.erase(1), 0u);
+    by_id.rehash(64);
+    EXPECT_EQ(by_id.bucket_count(), 64u);
+    int sum = 0;
+    for (const Session& session : by_id)
+    {
+        sum += session.id;
+    }
+    EXPECT_EQ(sum, 0 + 2 + 3 + 4 + 5 + 7);
+    EXPECT_EQ(std::distance(by_id.begin(), by_id.end()), 6);
+    by_id.erase(by_id.find(7));
+    EXPECT_EQ(by_id.size(), 5u);
+    by_id.clear();
+    EXPECT_TRUE(by_id.empty());
+    EXPECT_FALSE(sessions[3].by_id.is_linked());
+    idle.clear();
+};
+
+TEST(clock_cache, budget_clock_and_handles)
+{
+    // one shard, so the whole budget is shared by every key.
+    jpl::clock_cache<int, std::string, std::hash<int>, std::equal_to<int>, 1> cache{ 100 };
+    EXPECT_FALSE(cache.find(1));
+    for (int key = 0; key < 10; ++key)
+    {
+        cache.insert(key, std::to_string(key), 10);
+    }
+    EXPECT_EQ(cache.usage(), 100u);
+    EXPECT_EQ(cache.size(), 10u);
+
+    // a hit keeps its entry through the next sweep; the oldest other goes.
+    const auto held = cache.find(0);
+    ASSERT_TRUE(held);
+    EXPECT_EQ(held->value, "0");
+    const auto evicted = cache.find(1);
+    cache.insert(10, "10", 10);
+    cache.insert(11, "11", 10);
+    EXPECT_TRUE(cache.contains(0));
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_LE(cache.usage(), 100u);
+
+    // a handle outlives eviction and replacement.
+    cache.insert(0, "zero", 10);
+    EXPECT_EQ(held->value, "0");
+    EXPECT_EQ(cache.find(0)->value, "zero");
+    EXPECT_TRUE(cache.erase(1));
+    EXPECT_FALSE(cache.erase(1));
+    EXPECT_EQ(evicted->value, "1");
+    EXPECT_EQ(evicted->use_count(), 1u);
+
+    // an entry over the whole budget is never cached, so nothing else goes,
+    // but it is still handed back; one under a cached key drops that entry.
+    const auto oversized = cache.insert(99, "large", 1000);
+    EXPECT_EQ(oversized->value, "large");
+    EXPECT_FALSE(cache.contains(99));
+    EXPECT_EQ(cache.size(), 9u);
+    EXPECT_EQ(cache.usage(), 90u);
+    EXPECT_TRUE(cache.contains(0));
+    EXPECT_TRUE(cache.contains(11));
+    const auto replaced = cache.insert(11, "large", 1000);
+    EXPECT_EQ(replaced->value, "large");
+    EXPECT_FALSE(cache.contains(11));
+    EXPECT_EQ(cache.size(), 8u);
+    EXPECT_EQ(cache.usage(), 80u);
+
+    const auto counted = cache.statistics();
+    EXPECT_EQ(counted.hits, 3u);
+    EXPECT_EQ(counted.misses, 1u);
+    EXPECT_EQ(counted.evictions, 2u);
+
+    jpl::clock_cache<std::uint64_t, std::uint64_t> shared{ 1 << 12 };
+    std::atomic<bool> wrong{ false };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&shared, &wrong, t]
+        {
+            for (std::uint64_t i = 0; i < 20000; ++i)
+            {
+                const std::uint64_t key = (i * 7 + static_cast<std::uint64_t>(t)) % 8192;
+                if (const auto found = shared.find(key))
+                {
+                    if (found->value != key * 2)
+                    {
+                        wrong.store(true, std::memory_order_relaxed);
+                    }
+                }
+                else
+                {
+                    shared.insert(key, key * 2, 1);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_FALSE(wrong.load());
+    EXPECT_LE(shared.usage(), shared.capacity());
+    const auto totals = shared.statistics();
+    EXPECT_EQ(totals.hits + totals.misses, 80000u);
+    shared.clear();
+    EXPECT_EQ(shared.size(), 0u);
+    EXPECT_EQ(shared.usage(), 0u);
+};
+
+TEST(clock_cache, misses_past_the_budget_hold_memory_flat)
+{
+    // every lookup misses and every insert evicts, so the index sees an
+    // erase and an insert per op for as long as the cache runs.
+    jpl::clock_cache<std::uint64_t, std::uint64_t> cache{ 4096 };
+    std::uint64_t next = 0;
+    const auto miss = [&](std::uint64_t ops)
+    {
+        for (std::uint64_t op = 0; op < ops; ++op, ++next)
+        {
+            EXPECT_FALSE(cache.find(next));
+            cache.insert(next, next, 1);
+        }
+    };
+    miss(200000);
+    const std::size_t settled = heap_bytes.load();
+    miss(800000);
+    EXPECT_LE(cache.usage(), cache.capacity());
+    EXPECT_LE(heap_bytes.load(), settled + 16384);
+    EXPECT_GE(cache.statistics().evictions, 1000000u - cache.capacity());
+};